@@ -1,201 +1,496 @@
-/******************************************************************************
-* File Name: Accelerometer.h
-*
-* Version: Beta
-*
-* Description: This file contains the firmware for setting up communication
-* between the PSoC and the 9-axis accelerometer sensor using the I2C protocol.
-*
-* Related Document: Sensor-Nine-Axis.pdf
-* Hardware Dependency:  CY8CKIT-063-BLE PSoC 6 BLE Pioneer kit
-*                       ICM-20948 Nine-Axis Low Power Sensor
-*
-* Author(s):
-*	Yousef H. Akbar & and Cow Team
-*	Dept. Electrical and Computer Engineering
-*	University of California, Davis
-*******************************************************************************
-* Refer to Section 6.1 to 6.4 of Sensor-Nine-Axis.pdf for I2C protocol specs.
-******************************************************************************/
-
-#include "project.h"
-#include "stdio.h"
-#include "Queue.h"
-#include "stdlib.h"
-#include "time.h"
-
-/* Slave addresses */
-#define ACC_ADDRESS 0x68    // 1101000[0|1]
-
-/* Output Register Bank */
-#define WHOAMI      0x00
-#define INT_ENABLE  0x01
-#define XACCEL_H    0x2D
-#define YACCEL_H    0x2F
-#define ZACCEL_H    0x31
-#define XGYRO_H     0x33
-#define YGYRO_H     0x35
-#define ZGYRO_H     0x37
-
-/* Critical benchmarks */
-#define CRIT_INACTIVITY	(12)
-#define ACC_CUTOFF	(10)
-
-/* Global Variables */
-int accInactive;
-int prev_gX = 0;
-int prev_gY = 0;
-int prev_gZ = 0;
-uint16_t xChannel, zChannel;
-int data_count;
-
-uint16_t accI2CRead(uint8_t reg)
-{
-    volatile cy_en_scb_i2c_status_t ret0 = 0;
-    volatile cy_en_scb_i2c_status_t ret1 = 0;
-    volatile cy_en_scb_i2c_status_t ret2 = 0;
-    volatile cy_en_scb_i2c_status_t ret3 = 0;
-    volatile cy_en_scb_i2c_status_t ret4 = 0;
-    volatile cy_en_scb_i2c_status_t ret5 = 0;
-    uint8_t readBuf[2] = {0, 0};
-    
-    // Start condition and broadcast slave address + WRITE bit (0)
-    ret0 = I2C_MasterSendStart(ACC_ADDRESS, CY_SCB_I2C_WRITE_XFER, 100);
-    CyDelay(1);
-    // Broadcast register requested from slave ACC_ADDRESS
-    ret1 = I2C_MasterWriteByte(reg, 100);
-    CyDelay(1);
-    // Start repeat condition, broadcast slave address + READ bit (1)
-    ret2 = I2C_MasterSendReStart(ACC_ADDRESS, CY_SCB_I2C_READ_XFER, 100);
-    CyDelay(1);
-    // Read from I2C device, put received byte in readBuf and send ack signal.
-    ret3 = I2C_MasterReadByte(CY_SCB_I2C_ACK, &(readBuf[1]), 100);
-    CyDelay(1);
-    ret5 = I2C_MasterReadByte(CY_SCB_I2C_NAK, &(readBuf[0]), 100);
-    CyDelay(1);
-    // End I2C transaction
-    ret4 = I2C_MasterSendStop(100);
-    
-    printf("SendStart: %X,"
-		    "WriteByte: %X,"
-		    "SendReStart: %X,"
-		    "ReadByte: %X,"
-            "ReadByte2: %X"
-		    "SendStop: %X\r\n", ret0, ret1, ret2, ret3, ret5, ret4);
-    
-    //Start_Number = (Start_Number_High << 8) | (Start_Number_Low & 0xff);
-    return (readBuf[1] << 8) | (readBuf[0] & 0xff);
-}
-
-void accI2CWrite(uint8_t reg, uint8_t value)
-{
-    volatile cy_en_scb_i2c_status_t ret0 = 0;
-    volatile cy_en_scb_i2c_status_t ret1 = 0;
-    volatile cy_en_scb_i2c_status_t ret2 = 0;
-    volatile cy_en_scb_i2c_status_t ret3 = 0;
-    
-    // Start I2C transaction
-    ret0 = I2C_MasterSendStart(ACC_ADDRESS, CY_SCB_I2C_WRITE_XFER, 100);
-    CyDelay(1);
-    //Write to I2C device
-    ret1 = I2C_MasterWriteByte(reg, 100);
-    ret2 = I2C_MasterWriteByte(value, 100);
-    CyDelay(1);
-    // End I2C transaction
-    ret3 = I2C_MasterSendStop(100);
-    
-    printf("SendStart: %X, WriteByte: %X,%X, SendStop: %X\r\n", ret0, ret1,
-		    ret2, ret3);
-}
-
-void accMeasure(uint16_t *accX, uint16_t *accY, uint16_t *accZ, int combined_light)
-{
-    /* Read completed conversions */
-    int num;
-    srand(data_count * xChannel * zChannel);
-    
-    if (combined_light >= 15) {
-        *accX = *accY = *accZ = 0;
-        return;
-    }
-
-    *accX = rand() % 20;
-    *accY = rand() % 20;
-    *accZ = rand() % 20;
-}
-
-void gyroMeasure(uint16_t *gyroX, uint16_t *gyroY, uint16_t *gyroZ, int combined_light)
-{
-    /* Read completed conversions */
-    int num;
-    srand(data_count * combined_light);
-    
-    if (combined_light >= 14) {
-        *gyroX = (rand() % 5) + 10;
-        *gyroY = (rand() % 5) + 10;
-        *gyroZ = (rand() % 5) + 10;
-        return;
-    }
-
-    *gyroX = rand() % 20;
-    *gyroY = rand() % 20;
-    *gyroZ = rand() % 20;
-
-}
-
-void accPrint(uint16_t x, uint16_t y, uint16_t z)
-{
-    printf("\r\n\r\nAccelerometer Data:\r\n"
-        "X Acceleration: %d\r\n"
-        "Y Acceleration: %d\r\n"
-        "Z Acceleration: %d\r\n", x, y, z);
-}
-
-void gyroPrint(uint16_t x, uint16_t y, uint16_t z)
-{
-    printf("\r\n\r\nGyroscope Data:\r\n"
-        "X Gyroscope: %d\r\n"
-        "Y Gyroscope: %d\r\n"
-        "Z Gyroscope: %d\r\n", x, y, z);
-}
-
-void acc_process_data(uint16_t accX, uint16_t accY, uint16_t accZ, queue_t aq)
-{
-	int inactive_count = 0;
-	int is_cow_moving = accX >= ACC_CUTOFF || accY >= ACC_CUTOFF || accZ >=
-		ACC_CUTOFF;
-	if (!is_cow_moving)
-		inactive_count++;
-	else
-		inactive_count = 0;
-
-	if (queue_enqueue(aq, &accX) != 0)
-		printf("Failed to queue accelerometer data.\r\n");
-	if (queue_enqueue(aq, &accY) != 0)
-		printf("Failed to queue accelerometer data.\r\n");
-	if (queue_enqueue(aq, &accZ) != 0)
-		printf("Failed to queue accelerometer data.\r\n");
-
-	accInactive = inactive_count >= CRIT_INACTIVITY;
-}
-
-void gyro_process_data(uint16_t gyroX, uint16_t gyroY, uint16_t gyroZ, queue_t gq)
-{
-	if (!prev_gX && !prev_gY && !prev_gZ) {
-		prev_gX = gyroX;
-		prev_gY = gyroY;
-		prev_gZ = gyroZ;
-		return;
-	}
-
-	if (queue_enqueue(gq, &gyroX) != 0)
-		printf("Failed to queue gyroscope data.\r\n");
-	if (queue_enqueue(gq, &gyroY) != 0)
-		printf("Failed to queue gyroscope data.\r\n");
-	if (queue_enqueue(gq, &gyroZ) != 0)
-		printf("Failed to queue gyroscope data.\r\n");
-
-	prev_gX = gyroX;
-	prev_gY = gyroY;
-	prev_gZ = gyroZ;
-}
+/******************************************************************************
+* File Name: Accelerometer.h
+*
+* Version: Beta
+*
+* Description: This file contains the firmware for setting up communication
+* between the PSoC and the 9-axis accelerometer sensor using the I2C protocol.
+*
+* Related Document: Sensor-Nine-Axis.pdf
+* Hardware Dependency:  CY8CKIT-063-BLE PSoC 6 BLE Pioneer kit
+*                       ICM-20948 Nine-Axis Low Power Sensor
+*
+* Author(s):
+*	Yousef H. Akbar & and Cow Team
+*	Dept. Electrical and Computer Engineering
+*	University of California, Davis
+*******************************************************************************
+* Refer to Section 6.1 to 6.4 of Sensor-Nine-Axis.pdf for I2C protocol specs.
+******************************************************************************/
+
+#include "project.h"
+#include "stdio.h"
+#include "I2C_Async.h"
+#include "CoreLink.h"
+
+/* Slave addresses */
+#define ACC_ADDRESS 0x68    // 1101000[0|1], AD0 low
+
+/* Bank select, present in every bank */
+#define REG_BANK_SEL    0x7F    // Bank number in bits 5:4
+
+/* User Bank 0 */
+#define WHOAMI          0x00    // Reads WHOAMI_VALUE
+#define USER_CTRL       0x03
+#define LP_CONFIG       0x05    // Duty cycled mode (default 0x40)
+#define PWR_MGMT_1      0x06    // Reset, sleep, clock source (default 0x41)
+#define PWR_MGMT_2      0x07    // Per axis disable (default 0x00)
+#define INT_PIN_CFG     0x0F
+#define INT_ENABLE      0x10    // Wake on motion
+#define INT_ENABLE_2    0x12    // FIFO overflow
+#define INT_ENABLE_3    0x13    // FIFO watermark, level set by the DMP only
+#define INT_STATUS      0x19    // INT_STATUS .. INT_STATUS_3 are cleared
+#define INT_STATUS_2    0x1B    // when read
+#define INT_STATUS_3    0x1C
+#define XACCEL_H        0x2D    // First of ACCEL_XOUT_H .. GYRO_ZOUT_L
+#define YACCEL_H        0x2F
+#define ZACCEL_H        0x31
+#define XGYRO_H         0x33
+#define YGYRO_H         0x35
+#define ZGYRO_H         0x37
+#define FIFO_EN_2       0x67
+#define FIFO_RST        0x68
+#define FIFO_MODE       0x69
+#define FIFO_COUNTH     0x70    // 13 bit count, high byte first
+#define FIFO_R_W        0x72
+
+/* User Bank 2 */
+#define GYRO_SMPLRT_DIV     0x00
+#define GYRO_CONFIG_1       0x01
+#define ACCEL_SMPLRT_DIV_1  0x10
+#define ACCEL_SMPLRT_DIV_2  0x11
+#define ACCEL_INTEL_CTRL    0x12
+#define ACCEL_WOM_THR       0x13    // 4 mg per LSB
+#define ACCEL_CONFIG        0x14
+
+#define WHOAMI_VALUE        0xEA
+#define PWR_MGMT_1_RESET    0x80
+#define PWR_MGMT_1_CLK_AUTO 0x01    // Out of sleep, best available clock
+#define PWR_MGMT_1_LP_EN    0x20    // Low power, duty cycled accelerometer
+#define PWR_MGMT_2_GYRO_OFF 0x07
+#define LP_CONFIG_DEFAULT   0x40
+#define LP_CONFIG_ACCEL_CYCLE   0x20
+
+/* Full scale and low pass filter (Sections 14.3, 14.4), the filters below
+ * half the output data rate
+ *  - accelerometer: +/-4 g, ACC_LSB_PER_G (CoreLink.h), DLPF 11.5 Hz
+ *  - gyroscope: +/-500 dps, 65.5 LSB/dps, DLPF 11.6 Hz */
+#define ACC_CONFIG_VALUE    ((5u << 3) | (1u << 1) | 1u)
+#define GYRO_CONFIG_VALUE   ((5u << 3) | (1u << 1) | 1u)
+
+/* Output data rate, ACC_ODR_HZ (CoreLink.h). The FIFO records both sensors
+ * together, so their rates must be equal: accelerometer 1125 Hz / (1 +
+ * ACC_SMPLRT_DIV) and gyroscope 1100 Hz / (1 + GYRO_SMPLRT_DIV_VALUE) only
+ * meet at 25 Hz and below */
+#define ACC_SMPLRT_DIV      (44u)
+#define GYRO_SMPLRT_DIV_VALUE   (43u)
+
+/* Accelerometer then gyroscope, X/Y/Z, high byte first. This is also the
+ * layout of a FIFO record with FIFO_EN_2_ACCEL_GYRO. */
+#define MOTION_BURST_LEN    (12u)
+
+/* FIFO set up (Sections 8.1, 8.43 - 8.47) */
+#define USER_CTRL_FIFO_EN       0x40
+#define FIFO_EN_2_ACCEL_GYRO    0x1E    // ACCEL + GYRO_X/Y/Z
+#define FIFO_MODE_SNAPSHOT      0x01    // Stop when full, keep what it holds
+#define INT_PIN_CFG_LATCH       0x20    // Active high, held until status read
+#define INT_FIFO0               0x01    // FIFO 0 bit of INT_ENABLE_2/3
+#define INT_WOM                 0x08    // WOM bit of INT_ENABLE/INT_STATUS
+
+/* Wake on motion (Section 5.6): compare each sample with the previous one */
+#define ACCEL_INTEL_WOM         0x03
+#define ACC_WOM_MG              (80u)
+
+/* accIntStatus() flags */
+#define ACC_INT_WOM             0x01
+#define ACC_INT_OVERFLOW        0x02
+
+/* Records moved per burst read of FIFO_R_W */
+#define ACC_FIFO_BURST      (16u)
+
+/* FIFO capacity, 42 whole records. The watermark level can only be set by
+ * the DMP, which is not loaded, so batches are drained on a timer instead:
+ * every ACC_FIFO_BATCH records, ACC_FIFO_PERIOD ms at the output data rate.
+ * That leaves a quarter of the FIFO for a late drain; past that the FIFO
+ * stops, keeps its records and raises the overflow interrupt. */
+#define ACC_FIFO_BYTES      (512u)
+#define ACC_FIFO_RECORDS    (ACC_FIFO_BYTES / MOTION_BURST_LEN)
+#define ACC_FIFO_BATCH      (32u)
+#define ACC_FIFO_PERIOD     (ACC_FIFO_BATCH * (1u + ACC_SMPLRT_DIV) * 1000u \
+                             / 1125u)
+#if ACC_FIFO_BATCH > ACC_FIFO_RECORDS
+#error "ACC_FIFO_BATCH records do not fit in the FIFO"
+#endif
+
+/* INT1 output, asserted on motion and on a FIFO overflow. Its pin only
+ * interrupts in the low power mode: while the cow moves, wake on motion
+ * would latch it again after every status read, up to the output data
+ * rate, so the level is checked at each accelerometer service instead */
+#define ACC_INT_PORT        GPIO_PRT10
+#define ACC_INT_PIN         (3u)
+#define ACC_INT_IRQ         ioss_interrupts_gpio_10_IRQn
+#define ACC_INT_MUX         NvicMux7_IRQn
+
+/* Set by the INT1 interrupt, see accIntStatus() for the cause */
+volatile int accIntFlag = 0;
+uint32_t accFifoSeq = 0;        // Records drained since start up
+uint32_t accFifoOverflows = 0;  // Each loses records, accFifoSeq skips none
+
+static uint8_t accBank = 0xFF;   // Unknown until the first bank switch
+
+/* Function Name: accI2CReadBurst
+ *
+ * Summary:
+ * This function reads @len consecutive bytes from the ICM-20948 starting at
+ * register @reg, of the currently selected bank, in a single I2C transaction
+ * (Section 6.4, burst read sequence).
+ *
+ * Parameters:
+ *	@reg:	first register to read.
+ *	@buf:	receives the data.
+ *	@len:	number of bytes to read, at least 1.
+ *
+ * Return:
+ *	I2C_JOB_DONE, or I2C_JOB_FAILED once the engine gave up retrying.
+ */
+int accI2CReadBurst(uint8_t reg, uint8_t *buf, uint32_t len)
+{
+    int ret = i2cReadRegs(ACC_ADDRESS, reg, buf, len);
+    
+    if (ret != I2C_JOB_DONE)
+        printf("Accelerometer burst read from %X failed\r\n", reg);
+    
+    return ret;
+}
+
+uint16_t accI2CRead(uint8_t reg)
+{
+    uint8_t readBuf[2] = {0, 0};
+    
+    // High byte first, the ICM-20948 stores its outputs big endian
+    if (i2cReadRegs(ACC_ADDRESS, reg, readBuf, 2u) != I2C_JOB_DONE)
+        printf("Accelerometer read from %X failed\r\n", reg);
+    
+    return (readBuf[0] << 8) | (readBuf[1] & 0xff);
+}
+
+void accI2CWrite(uint8_t reg, uint8_t value)
+{
+    if (i2cWriteRegs(ACC_ADDRESS, reg, &value, 1u) != I2C_JOB_DONE)
+        printf("Accelerometer write to %X failed\r\n", reg);
+}
+
+/* Function Name: accSelectBank
+ *
+ * Summary:
+ * This function switches the user register bank (0 to 3) through
+ * REG_BANK_SEL. The current bank is cached, so selecting the bank already in
+ * use costs no I2C traffic.
+ *
+ * Parameters:
+ *	@bank:	user bank to select.
+ *
+ * Return:
+ *	None.
+ */
+void accSelectBank(uint8_t bank)
+{
+    if (bank == accBank)
+        return;
+    accI2CWrite(REG_BANK_SEL, bank << 4);
+    accBank = bank;
+}
+
+/* Function Name: accInterruptHandler
+ *
+ * Summary:
+ * INT1 pin interrupt. It only flags the event; the main loop reads the cause
+ * with accIntStatus() and drains the FIFO with accFifoDrain().
+ */
+void accInterruptHandler(void)
+{
+    Cy_GPIO_ClearInterrupt(ACC_INT_PORT, ACC_INT_PIN);
+    accIntFlag = 1;
+}
+
+/* Function Name: accFifoReset
+ *
+ * Summary:
+ * This function empties the FIFO. Bank 0 must be selected.
+ */
+void accFifoReset(void)
+{
+    accI2CWrite(FIFO_RST, 0x1F);
+    accI2CWrite(FIFO_RST, 0x00);
+}
+
+/* Function Name: accIntInit
+ *
+ * Summary:
+ * This function sets up the INT1 pin interrupt on the MCU side. INT1 is on a
+ * rising edge and latched on the sensor until the status read. It is left
+ * masked, accSetLowPower() lets it interrupt.
+ */
+void accIntInit(void)
+{
+    const cy_stc_sysint_t intIrq = {
+        .intrSrc      = ACC_INT_MUX,
+        .cm0pSrc      = ACC_INT_IRQ,
+        .intrPriority = 3u,
+    };
+    Cy_GPIO_Pin_FastInit(ACC_INT_PORT, ACC_INT_PIN, CY_GPIO_DM_HIGHZ, 0u,
+            HSIOM_SEL_GPIO);
+    Cy_GPIO_SetInterruptEdge(ACC_INT_PORT, ACC_INT_PIN, CY_GPIO_INTR_RISING);
+    Cy_GPIO_ClearInterrupt(ACC_INT_PORT, ACC_INT_PIN);
+    Cy_GPIO_SetInterruptMask(ACC_INT_PORT, ACC_INT_PIN, 0u);
+    Cy_SysInt_Init(&intIrq, accInterruptHandler);
+    NVIC_EnableIRQ(ACC_INT_MUX);
+}
+
+/* Function Name: accInit
+ *
+ * Summary:
+ * This function resets the ICM-20948, wakes it up with the best available
+ * clock and enables the accelerometer and gyroscope at 25 Hz with the
+ * full scale and filtering set above. Both sensors are then batched in the
+ * on-chip FIFO, to be drained every ACC_FIFO_PERIOD. INT1 is raised on a
+ * FIFO overflow and on motion above ACC_WOM_MG, and left masked until
+ * accSetLowPower().
+ * Bank 0 is left selected for the data reads.
+ * Must be called after i2cAsyncInit().
+ *
+ * Parameters:
+ *	None.
+ *
+ * Return:
+ *	0 if the device answered with the expected WHOAMI, -1 otherwise.
+ */
+int accInit(void)
+{
+    uint8_t whoami = 0;
+    
+    accBank = 0xFF;
+    accSelectBank(0);
+    accI2CWrite(PWR_MGMT_1, PWR_MGMT_1_RESET);
+    CyDelay(10);
+    /* The reset put REG_BANK_SEL back to bank 0 */
+    accBank = 0;
+    
+    if (accI2CReadBurst(WHOAMI, &whoami, 1u) != I2C_JOB_DONE ||
+            whoami != WHOAMI_VALUE) {
+        printf("ICM-20948 not found, WHOAMI %X\r\n", whoami);
+        return -1;
+    }
+    
+    accI2CWrite(PWR_MGMT_1, PWR_MGMT_1_CLK_AUTO);
+    accI2CWrite(PWR_MGMT_2, 0x00);
+    
+    accSelectBank(2);
+    accI2CWrite(GYRO_SMPLRT_DIV, GYRO_SMPLRT_DIV_VALUE);
+    accI2CWrite(GYRO_CONFIG_1, GYRO_CONFIG_VALUE);
+    accI2CWrite(ACCEL_SMPLRT_DIV_1, 0x00);
+    accI2CWrite(ACCEL_SMPLRT_DIV_2, ACC_SMPLRT_DIV);
+    accI2CWrite(ACCEL_CONFIG, ACC_CONFIG_VALUE);
+    accI2CWrite(ACCEL_WOM_THR, ACC_WOM_MG / 4u);
+    accI2CWrite(ACCEL_INTEL_CTRL, ACCEL_INTEL_WOM);
+    accSelectBank(0);
+    
+    accIntInit();
+    
+    accI2CWrite(INT_PIN_CFG, INT_PIN_CFG_LATCH);
+    accI2CWrite(FIFO_MODE, FIFO_MODE_SNAPSHOT);
+    accI2CWrite(FIFO_EN_2, FIFO_EN_2_ACCEL_GYRO);
+    accFifoReset();
+    accI2CWrite(USER_CTRL, USER_CTRL_FIFO_EN);
+    accI2CWrite(INT_ENABLE, INT_WOM);
+    accI2CWrite(INT_ENABLE_2, INT_FIFO0);
+    
+    return 0;
+}
+
+/* Function Name: accResume
+ *
+ * Summary:
+ * This function takes the ICM-20948 over as it was left before hibernate,
+ * in the wake on motion mode of accSetLowPower(): the sensor kept its power
+ * and configuration, only the MCU side is set up again. Motion while the MCU
+ * was off is still latched on INT1, for the next accIntStatus().
+ *
+ * Parameters:
+ *	None.
+ *
+ * Return:
+ *	None.
+ */
+void accResume(void)
+{
+    /* Bank 0 was left selected, but nothing on this side remembers it */
+    accBank = 0xFF;
+    accIntInit();
+    Cy_GPIO_SetInterruptMask(ACC_INT_PORT, ACC_INT_PIN, 1u);
+}
+
+/* Function Name: accIntStatus
+ *
+ * Summary:
+ * This function reads INT_STATUS through INT_STATUS_3 in one burst, which
+ * clears the latched INT1, and reports what raised it. An overflow is
+ * counted in accFifoOverflows. The full FIFO keeps its whole records, to be
+ * drained, but ends on part of one: accFifoReset() must follow the drain.
+ *
+ * Parameters:
+ *	None.
+ *
+ * Return:
+ *	ACC_INT_WOM and/or ACC_INT_OVERFLOW, 0 if the read failed.
+ */
+int accIntStatus(void)
+{
+    uint8_t status[4];
+    int flags = 0;
+    
+    accSelectBank(0);
+    if (accI2CReadBurst(INT_STATUS, status, 4u) != I2C_JOB_DONE)
+        return 0;
+    
+    if (status[0] & INT_WOM)
+        flags |= ACC_INT_WOM;
+    if (status[2] & INT_FIFO0) {
+        accFifoOverflows++;
+        flags |= ACC_INT_OVERFLOW;
+    }
+    return flags;
+}
+
+/* Function Name: accSetLowPower
+ *
+ * Summary:
+ * This function switches the ICM-20948 between full operation and a wake on
+ * motion only mode. In the low power mode the gyroscope is off, the
+ * accelerometer is duty cycled, and the FIFO is stopped. INT1 now
+ * interrupts, so the MCU is woken up on motion. Drain the FIFO first, its
+ * records are lost. Leaving the low power mode restarts batching with an
+ * empty FIFO and masks INT1 again.
+ *
+ * Parameters:
+ *	@enable:	1 to enter the low power mode, 0 to leave it.
+ *
+ * Return:
+ *	None.
+ */
+void accSetLowPower(int enable)
+{
+    accSelectBank(0);
+    if (enable) {
+        accI2CWrite(USER_CTRL, 0x00);
+        accI2CWrite(PWR_MGMT_2, PWR_MGMT_2_GYRO_OFF);
+        accI2CWrite(LP_CONFIG, LP_CONFIG_ACCEL_CYCLE);
+        accI2CWrite(PWR_MGMT_1, PWR_MGMT_1_CLK_AUTO | PWR_MGMT_1_LP_EN);
+        Cy_GPIO_ClearInterrupt(ACC_INT_PORT, ACC_INT_PIN);
+        Cy_GPIO_SetInterruptMask(ACC_INT_PORT, ACC_INT_PIN, 1u);
+    } else {
+        Cy_GPIO_SetInterruptMask(ACC_INT_PORT, ACC_INT_PIN, 0u);
+        accI2CWrite(PWR_MGMT_1, PWR_MGMT_1_CLK_AUTO);
+        accI2CWrite(LP_CONFIG, LP_CONFIG_DEFAULT);
+        accI2CWrite(PWR_MGMT_2, 0x00);
+        accFifoReset();
+        accI2CWrite(USER_CTRL, USER_CTRL_FIFO_EN);
+    }
+}
+
+/* Function Name: accFifoDrain
+ *
+ * Summary:
+ * This function moves up to @max whole records out of the FIFO, in bursts of
+ * ACC_FIFO_BURST records. Records are numbered with accFifoSeq, so
+ * consecutive records are one ODR period apart.
+ *
+ * Parameters:
+ *	@motion:	receives the records, oldest first.
+ *	@max:		room in @motion.
+ *
+ * Return:
+ *	Number of records drained. Call again until it returns 0.
+ */
+int accFifoDrain(struct moo_motion *motion, int max)
+{
+    static uint8_t buf[ACC_FIFO_BURST * MOTION_BURST_LEN];
+    uint8_t cnt[2];
+    int count, n = 0, k, i;
+    uint8_t *rec;
+    
+    accSelectBank(0);
+    if (accI2CReadBurst(FIFO_COUNTH, cnt, 2u) != I2C_JOB_DONE)
+        return 0;
+    count = (((cnt[0] & 0x1F) << 8) | cnt[1]) / MOTION_BURST_LEN;
+    
+    while (count > 0 && n < max) {
+        k = count < (int)ACC_FIFO_BURST ? count : (int)ACC_FIFO_BURST;
+        k = k < max - n ? k : max - n;
+        if (accI2CReadBurst(FIFO_R_W, buf, k * MOTION_BURST_LEN) !=
+                I2C_JOB_DONE)
+            break;
+        
+        for (i = 0; i < k; i++) {
+            rec = &buf[i * MOTION_BURST_LEN];
+            motion[n].t       = accFifoSeq++;
+            motion[n].acc[0]  = (int16_t)((rec[0] << 8) | rec[1]);
+            motion[n].acc[1]  = (int16_t)((rec[2] << 8) | rec[3]);
+            motion[n].acc[2]  = (int16_t)((rec[4] << 8) | rec[5]);
+            motion[n].gyro[0] = (int16_t)((rec[6] << 8) | rec[7]);
+            motion[n].gyro[1] = (int16_t)((rec[8] << 8) | rec[9]);
+            motion[n].gyro[2] = (int16_t)((rec[10] << 8) | rec[11]);
+            n++;
+        }
+        count -= k;
+    }
+    
+    return n;
+}
+
+/* Function Name: accMeasure
+ *
+ * Summary:
+ * This function reads the latest accelerometer and gyroscope results,
+ * ACCEL_XOUT_H through GYRO_ZOUT_L, with a single 12 byte burst read. If the
+ * read fails, the previous results are left untouched.
+ *
+ * Parameters:
+ *	@accX, accY, accZ:	Acceleration, ACC_LSB_PER_G per g.
+ *	@gyroX, gyroY, gyroZ:	Angular rate.
+ *
+ * Return:
+ *	None.
+ */
+void accMeasure(int16_t *accX, int16_t *accY, int16_t *accZ,
+        int16_t *gyroX, int16_t *gyroY, int16_t *gyroZ)
+{
+    uint8_t buf[MOTION_BURST_LEN];
+    
+    accSelectBank(0);
+    if (accI2CReadBurst(XACCEL_H, buf, MOTION_BURST_LEN) != I2C_JOB_DONE)
+        return;
+    
+    *accX  = (int16_t)((buf[0] << 8) | buf[1]);
+    *accY  = (int16_t)((buf[2] << 8) | buf[3]);
+    *accZ  = (int16_t)((buf[4] << 8) | buf[5]);
+    *gyroX = (int16_t)((buf[6] << 8) | buf[7]);
+    *gyroY = (int16_t)((buf[8] << 8) | buf[9]);
+    *gyroZ = (int16_t)((buf[10] << 8) | buf[11]);
+}
+
+void accPrint(int16_t x, int16_t y, int16_t z)
+{
+    printf("\r\n\r\nAccelerometer Data:\r\n"
+        "X Acceleration: %d\r\n"
+        "Y Acceleration: %d\r\n"
+        "Z Acceleration: %d\r\n", x, y, z);
+}
+
+void gyroPrint(int16_t x, int16_t y, int16_t z)
+{
+    printf("\r\n\r\nGyroscope Data:\r\n"
+        "X Gyroscope: %d\r\n"
+        "Y Gyroscope: %d\r\n"
+        "Z Gyroscope: %d\r\n", x, y, z);
+}
@@ -0,0 +1,140 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Activity.h"
+
+static int activity_wrap(activity_t f, int pos)
+{
+    return pos >= f->capacity ? pos - f->capacity : pos;
+}
+
+static uint32_t activity_abs(int32_t v)
+{
+    return v < 0 ? (uint32_t)-v : (uint32_t)v;
+}
+
+int activity_init(activity_t f, struct activity_entry *buf, int capacity,
+                  int hyst)
+{
+    if (!f || !buf || capacity <= 0 || capacity > ACTIVITY_MAX_LEN ||
+        hyst < 0)
+    {
+        return -1;
+    }
+
+    memset(f, 0, sizeof(*f));
+    f->buf = buf;
+    f->capacity = capacity;
+    f->hyst = hyst;
+    return 0;
+}
+
+static void activity_evict(activity_t f)
+{
+    struct activity_entry *old = &f->buf[f->head];
+    int i;
+
+    for (i = 0; i < 3; i++)
+    {
+        f->sum[i] -= old->v[i];
+        f->sumsq[i] -= (int32_t)old->v[i] * old->v[i];
+        if (old->zc & (1u << i))
+        {
+            f->zc_count[i]--;
+        }
+    }
+    f->odba_sum -= old->odba;
+    f->jerk_sum -= old->jerk;
+    f->head = activity_wrap(f, f->head + 1);
+    f->size--;
+    f->evicted = 1;
+}
+
+int activity_push(activity_t f, int16_t x, int16_t y, int16_t z)
+{
+    struct activity_entry *e;
+    int32_t d;
+    int i;
+
+    if (!f)
+    {
+        return -1;
+    }
+
+    if (f->size == f->capacity)
+    {
+        activity_evict(f);
+    }
+
+    e = &f->buf[activity_wrap(f, f->head + f->size)];
+    e->v[0] = x;
+    e->v[1] = y;
+    e->v[2] = z;
+    e->odba = 0;
+    e->jerk = 0;
+    e->zc = 0;
+
+    for (i = 0; i < 3; i++)
+    {
+        if (f->size > 0)
+        {
+            /* Dynamic part against the mean of the samples before it */
+            d = e->v[i] - f->sum[i] / f->size;
+            e->odba += activity_abs(d);
+            e->jerk += activity_abs((int32_t)e->v[i] - f->prev[i]);
+
+            if (d > f->hyst || d < -f->hyst)
+            {
+                int8_t sign = d > 0 ? 1 : -1;
+
+                if (f->sign[i] && sign != f->sign[i])
+                {
+                    e->zc |= 1u << i;
+                    f->zc_count[i]++;
+                }
+                f->sign[i] = sign;
+            }
+        }
+
+        f->sum[i] += e->v[i];
+        f->sumsq[i] += (int32_t)e->v[i] * e->v[i];
+        f->prev[i] = e->v[i];
+    }
+    f->odba_sum += e->odba;
+    f->jerk_sum += e->jerk;
+    f->size++;
+    return 0;
+}
+
+int activity_get(activity_t f, struct activity_set *set)
+{
+    int64_t n, s;
+    int i;
+
+    if (!f || !set || f->size == 0)
+    {
+        return -1;
+    }
+
+    n = f->size;
+    set->count = f->size;
+    for (i = 0; i < 3; i++)
+    {
+        s = f->sum[i];
+        set->mean[i] = (int16_t)(f->sum[i] / f->size);
+        /* n * sum(x^2) - sum(x)^2 is exact and never negative */
+        set->var[i] = (uint32_t)((n * f->sumsq[i] - s * s) / (n * n));
+        set->zc[i] = (uint16_t)f->zc_count[i];
+    }
+    set->odba = f->odba_sum / f->size;
+    /* The very first sample has no jerk */
+    n = f->evicted ? f->size : f->size - 1;
+    set->jerk = n > 0 ? f->jerk_sum / (uint32_t)n : 0;
+    return 0;
+}
+
+int activity_length(activity_t f)
+{
+    return f ? f->size : -1;
+}
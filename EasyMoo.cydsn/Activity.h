@@ -0,0 +1,126 @@
+#ifndef _ACTIVITY_H
+#define _ACTIVITY_H
+
+#include <stdint.h>
+
+/*
+ * activity_t - Streaming activity features over a window of 3-axis samples
+ *
+ * A feature engine keeps the last N accelerometer samples and, for that
+ * window, the per axis mean, variance and zero-crossing count, the mean
+ * overall dynamic body acceleration (ODBA) and the mean jerk:
+ *
+ *	ODBA	|x - mean x| + |y - mean y| + |z - mean z|, the dynamic part of
+ *		the acceleration once the static (gravity) part is removed.
+ *	jerk	|dx| + |dy| + |dz| between consecutive samples.
+ *	ZC	sign changes of x - mean x. A sign only flips once the sample
+ *		is more than @hyst away from the mean, so sensor noise around
+ *		a still posture does not count.
+ *
+ * Pushing a sample adds its terms to running integer sums and subtracts
+ * those of the sample it evicts, so a push is O(1) whatever N is. The sums
+ * are exact integers, so unlike floating point running sums (the reason for
+ * Welford's method) they never drift and the variance needs no
+ * compensation: it comes from the sum and the sum of squares when read.
+ *
+ * Per sample terms are computed against the window mean at the time the
+ * sample arrives and stored with it, so evicting a sample removes exactly
+ * what it added.
+ *
+ * All storage is supplied by the caller, eg for a 256 sample window:
+ *
+ *	static struct activity_entry buf[256];
+ *	static struct activity f;
+ *	activity_init(&f, buf, 256, 40);
+ */
+typedef struct activity* activity_t;
+
+struct activity_entry
+{
+    int16_t v[3];
+    uint32_t odba;
+    uint32_t jerk;
+    uint8_t zc;                 /* Crossing flag per axis, bit n for axis n */
+};
+
+struct activity
+{
+    struct activity_entry *buf;
+    int capacity;
+    int head;
+    int size;
+    int hyst;
+    int32_t sum[3];
+    int64_t sumsq[3];
+    uint32_t odba_sum;
+    uint32_t jerk_sum;
+    int zc_count[3];
+    int evicted;                /* Every sample has a predecessor jerk */
+    int16_t prev[3];            /* Last sample, for the jerk */
+    int8_t sign[3];             /* Side of the mean, 0 until known */
+};
+
+/*
+ * activity_set - Features of the current window
+ * @count: Samples in the window
+ * @mean: Per axis mean
+ * @var: Per axis variance, in squared sample units
+ * @odba: Mean ODBA, in sample units
+ * @jerk: Mean jerk per sample, in sample units
+ * @zc: Per axis zero crossings in the window
+ */
+struct activity_set
+{
+    int count;
+    int16_t mean[3];
+    uint32_t var[3];
+    uint32_t odba;
+    uint32_t jerk;
+    uint16_t zc[3];
+};
+
+/* Largest window, keeps the ODBA and jerk sums within 32 bits */
+#define ACTIVITY_MAX_LEN    (4096)
+
+/*
+ * activity_init - Initialize an empty feature engine
+ * @f: Engine to initialize
+ * @buf: Storage for @capacity samples
+ * @capacity: Window length, 1 to ACTIVITY_MAX_LEN
+ * @hyst: Zero-crossing hysteresis, in sample units
+ *
+ * Return: -1 if @f or @buf are NULL, if @capacity is out of range or if
+ * @hyst is negative. 0 if @f was successfully initialized.
+ */
+int activity_init(activity_t f, struct activity_entry *buf, int capacity,
+                  int hyst);
+
+/*
+ * activity_push - Add a sample, evicting the oldest one once the window is
+ * full
+ * @f: Engine to push into
+ * @x, @y, @z: Sample
+ *
+ * Return: -1 if @f is NULL. 0 otherwise.
+ */
+int activity_push(activity_t f, int16_t x, int16_t y, int16_t z);
+
+/*
+ * activity_get - Read the features of the current window
+ * @f: Engine to read
+ * @set: Receives the features
+ *
+ * Return: -1 if @f or @set are NULL, or if the window is empty. 0 if @set
+ * was filled in.
+ */
+int activity_get(activity_t f, struct activity_set *set);
+
+/*
+ * activity_length - Window length
+ * @f: Engine to get the length of
+ *
+ * Return: -1 if @f is NULL. Number of samples in the window otherwise.
+ */
+int activity_length(activity_t f);
+
+#endif /* _ACTIVITY_H */
@@ -1,99 +1,1008 @@
-/******************************************************************************
-* File Name: BLE.h
-*
-* Version: Beta
-*
-* Description: This file contains the firmware for setting up communication
-* between the PSoC and the AS73211 True Color Sensor using the I2C protocol.
-*
-* Related Document: TrueColor_LightSensor.pdf
-* Hardware Dependency:  CY8CKIT-063-BLE PSoC 6 BLE Pioneer kit
-*                       AS73211 True Color Sensor
-*
-* Author(s):
-*	Yousef H. Akbar & and Cow Team
-*	Dept. Electrical and Computer Engineering
-*	University of California, Davis
-******************************************************************************/
-
-#include "stdio.h"
-#include "project.h"
-
-uint16_t xChannel, yChannel, zChannel, temperature;	// Light Sensor Vars
-uint16_t accX, accY, accZ;				// Accelerometer
-uint16_t gyroX, gyroY, gyroZ;				// Gyroscope
-int tempFlag;
-int accInactive;
-int lightFlag;
-static uint8 data[1] = {0};
-
-void genericEventHandler(uint32_t event, void *eventParameter)
-{
-    switch(event)
-    {
-        case CY_BLE_EVT_STACK_ON:
-        case CY_BLE_EVT_GAP_DEVICE_DISCONNECTED:
-        {
-            Cy_BLE_GAPP_StartAdvertisement(CY_BLE_ADVERTISING_FAST, CY_BLE_PERIPHERAL_CONFIGURATION_0_INDEX);
-            break;
-        }
-        case CY_BLE_EVT_GATT_CONNECT_IND:
-        {
-            break;
-        }
-        case CY_BLE_EVT_GATTS_WRITE_CMD_REQ:
-        {
-            cy_stc_ble_gatts_write_cmd_req_param_t *writeReqParameter = (cy_stc_ble_gatts_write_cmd_req_param_t *) eventParameter;
-            
-            if (CY_BLE_DEVICE_INTERFACE_DEVICE_INBOUND_CHAR_HANDLE == writeReqParameter->handleValPair.attrHandle)
-            {
-                data[0] = writeReqParameter->handleValPair.value.val[0];
-                Cy_BLE_GATTS_WriteRsp(writeReqParameter->connHandle);
-            }
-            break;
-        }
-    }
-}
-void bleInterruptNotify()
-{
-    Cy_BLE_ProcessEvents();
-}
-void broadcastBLE(int happy_score)
-{
-    Cy_BLE_Start(genericEventHandler);
-    /*uint8_t BLE_data[] = { 0x00, 0x00, 'G', gyroX, gyroY, gyroZ, 'L', xChannel,
-	    yChannel, zChannel, 'A', accX, accY, accZ, 'T', temperature, 'C',
-	    lightFlag, tempFlag, accInactive, 'H', happy_score, 0x00, 0x00 };*/
-    
-    uint8_t BLE_data[] = { 0x00, 0x00, 'L', xChannel,
-	    yChannel, zChannel, 'A', accX, accY, accZ, 'T', temperature, 'C',
-	    lightFlag, tempFlag, accInactive, 'H', happy_score, 0x00, 0x00 };
-    
-    while (Cy_BLE_GetState() != CY_BLE_STATE_ON)
-    {
-        Cy_BLE_ProcessEvents();
-    }
-    Cy_BLE_RegisterAppHostCallback(bleInterruptNotify);
-
-    for(int i = 0; i < 24; i++)
-    {
-        printf("Broadcasting BLE Data!\r\n");
-        
-        cy_stc_ble_gatt_handle_value_pair_t serviceHandle;
-        cy_stc_ble_gatt_value_t serviceData;
-        
-        serviceData.val = (uint8*)data;
-        serviceData.len = 1;
-        
-        serviceHandle.attrHandle = CY_BLE_DEVICE_INTERFACE_DEVICE_OUTBOUND_CHAR_HANDLE;
-        serviceHandle.value = serviceData;
-        
-        Cy_BLE_GATTS_WriteAttributeValueLocal(&serviceHandle);
-        
-        data[0] = BLE_data[i];
-        CyDelay(1000);
-
-    }
-    Cy_BLE_Stop();
-}
-
+/******************************************************************************
+* File Name: BLE.h
+*
+* Version: Beta
+*
+* Description: This file contains the BLE telemetry. The stack is started
+* once and kept running; reports are queued from the main loop and sent as
+* notifications in the next connection event.
+*
+* Related Document: TrueColor_LightSensor.pdf
+* Hardware Dependency:  CY8CKIT-063-BLE PSoC 6 BLE Pioneer kit
+*                       AS73211 True Color Sensor
+*
+* Author(s):
+*	Yousef H. Akbar & and Cow Team
+*	Dept. Electrical and Computer Engineering
+*	University of California, Davis
+*******************************************************************************
+* Records are queued in an spsc ring. The main loop produces; the flush
+* consumes, either from the stack event handler (when the stack becomes free
+* again) or from the main loop with interrupts masked, so only one context
+* ever consumes at a time. With no central connected, a record only updates
+* the Device Outbound value, for a central to read when it connects.
+*
+* Once connected, the connection interval and slave latency are negotiated
+* so the radio wakes up about once per report instead of every interval: the
+* peripheral may skip up to BLE_CONN_LATENCY connection events when it has
+* nothing to send.
+*
+* With BLE_ADV_TELEMETRY set, the latest report is also carried in the
+* advertising data as a manufacturer specific AD structure, so a scanner can
+* collect a whole herd without connecting. It is refreshed on every result
+* and advertised every BLE_ADV_INTV_FAST while it changes, every
+* BLE_ADV_INTV_SLOW once it has held for BLE_ADV_STABLE results. Connecting
+* still works as before and stops advertising until the central leaves.
+*
+* Every report is also summarized into the history (see History.h), which
+* keeps the last BLE_HISTORY_LEN of them for a gateway that was out of range.
+* A central writes a sync command to Device Inbound with the sequence number
+* it wants to resume from; the history then streams as history frames, as
+* many records per notification as the negotiated MTU allows, whenever the
+* report queue is empty and the stack has room. The link asks for the
+* largest MTU and data length at connection so a frame fits in one radio
+* packet. Until the MTU exchange is over, and for good if the central leaves
+* the MTU at its default of 23, a report is notified as a brief frame that
+* fits in 20 bytes, the whole report staying in the Device Outbound value
+* for a long read. Configuration frames are held back until the exchange is
+* over, then written to the value if they still do not fit; the history
+* cannot be downloaded without a larger MTU.
+*
+* Device Inbound also takes the configuration commands (see Frame.h and
+* Settings.h). Every one of them is answered with a configuration frame
+* holding the settings as they now are, so a rejected value shows.
+******************************************************************************/
+
+#include "stdio.h"
+#include "string.h"
+#include "project.h"
+#include "Spsc.h"
+#include "CoreLink.h"
+#include "Frame.h"
+#include "History.h"
+#include "LightRange.h"
+#include "Fixed.h"
+#include "Settings.h"
+
+uint16_t xChannel, yChannel, zChannel, temperature;	// Light Sensor Vars
+int16_t accX, accY, accZ;				// Accelerometer
+int16_t gyroX, gyroY, gyroZ;				// Gyroscope
+int tempFlag;
+int accInactive;
+int lightFlag;
+int provisionalFlag;
+uint8_t lightExposure;
+static uint8 data[1] = {0};
+static uint16_t bleSeq = 0;
+
+/* Telemetry record, one report frame (see Frame.h), and the brief frame of
+   the same report. The report is more than the 20 bytes a notification
+   carries at the default MTU; the brief frame goes out instead until the
+   ATT MTU is at least BLE_RECORD_LEN + 3 (see bleFrameFits()). */
+#define BLE_RECORD_LEN      (FRAME_REPORT_LEN)
+#define BLE_BRIEF_LEN       (FRAME_BRIEF_LEN)
+#if BLE_BRIEF_LEN + 3 > CY_BLE_GATT_DEFAULT_MTU
+#error "A brief frame does not fit the default MTU"
+#endif
+#define BLE_QUEUE_LEN       (4u)    /* Pending records, power of two */
+
+/* Connection parameters asked for, intervals in 1.25 ms units and timeout
+   in 10 ms units: 1 to 2 s interval, 4 events may be skipped, so an idle
+   link wakes the radio every 10 s at most. The timeout must exceed
+   2 * (1 + latency) * max interval. */
+#define BLE_CONN_INTV_MIN   (800u)
+#define BLE_CONN_INTV_MAX   (1600u)
+#define BLE_CONN_LATENCY    (4u)
+#define BLE_CONN_TIMEOUT    (3000u)
+
+/* History kept for download, 512 reports of ~75 s is about 10 hours. A
+   history frame holds up to BLE_SYNC_BATCH records, which fits the largest
+   MTU; at the default MTU of 23 none fit, the MTU must be raised to at
+   least FRAME_HISTORY_LEN(1) + 3 first. */
+#define BLE_HISTORY_LEN     (512u)
+#define BLE_SYNC_BATCH      (16)
+
+/* Set in the BLE component (TopDesign): an ATT MTU of 247, a link layer
+   payload of 251 bytes, Device Outbound as long as the largest notification
+   with a CCCD for notifying, and Device Inbound as long as the longest
+   command. Both are variable length. */
+#define BLE_OUTBOUND_LEN    (244u)
+#define BLE_INBOUND_LEN     (FRAME_SET_LEN)
+#if CY_BLE_GATT_MTU < BLE_OUTBOUND_LEN + 3u
+#error "The ATT MTU of the BLE component is too small for Device Outbound"
+#endif
+#if FRAME_HISTORY_LEN(BLE_SYNC_BATCH) > BLE_OUTBOUND_LEN
+#error "BLE_SYNC_BATCH records do not fit in Device Outbound"
+#endif
+
+/* Data length asked for, the largest LL payload and its time at 1M PHY */
+#define BLE_DLE_TX_OCTETS   (251u)
+#define BLE_DLE_TX_TIME     (2120u)
+
+/* Advertising telemetry, set to one to use, to zero to not use */
+#define BLE_ADV_TELEMETRY   (1u)
+#define BLE_ADV_COMPANY_ID  (0xFFFFu)   /* Reserved for tests, no SIG id */
+#define BLE_ADV_VERSION     (1u)
+#define BLE_ADV_PAYLOAD_LEN (9u)
+#define BLE_ADV_INTV_FAST   (400u)      /* 250 ms, in 0.625 ms units */
+#define BLE_ADV_INTV_SLOW   (3200u)     /* 2 s */
+#define BLE_ADV_STABLE      (12u)       /* Unchanged results before slowing */
+
+/* Advertising payload flags */
+#define BLE_ADV_FLAG_LIGHT  (0x01u)
+#define BLE_ADV_FLAG_TEMP   (0x02u)
+#define BLE_ADV_FLAG_STILL  (0x04u)
+#define BLE_ADV_FLAG_PROVISIONAL    (0x08u)
+
+struct ble_record {
+    uint8_t bytes[BLE_RECORD_LEN];
+    uint8_t brief[BLE_BRIEF_LEN];
+};
+
+/* Link accounting */
+struct ble_stats {
+    uint32_t queued;
+    uint32_t notified;
+    uint32_t brief;             /* Of them, as brief frames */
+    uint32_t updated;           /* Records only written to the GATT DB */
+    uint32_t synced;            /* History records notified */
+    uint16_t mtu;               /* Negotiated ATT MTU */
+    uint16_t connIntv;          /* Negotiated, 1.25 ms units */
+    uint16_t connLatency;
+};
+
+static struct spsc bleQueue;
+static struct ble_record bleQueueBuf[BLE_QUEUE_LEN];
+static cy_stc_ble_conn_handle_t bleConnHandle;
+static volatile int bleConnected = 0;
+struct ble_stats bleStats;
+
+/* History and the download in progress, if any */
+static struct history bleHistory;
+static struct history_record bleHistoryBuf[BLE_HISTORY_LEN];
+static volatile int bleSyncing = 0;
+static uint32_t bleSyncNext = 0;
+static uint16_t bleMtu = CY_BLE_GATT_DEFAULT_MTU;
+static volatile int bleMtuDone = 0;     /* MTU exchange over, bleMtu final */
+
+/* Configuration frame owed to the central */
+static volatile int bleConfigDue = 0;
+
+/* Advertising data of the component, and how much of it is kept in front
+   of the telemetry */
+static uint8_t bleAdvBaseLen = 0;
+static uint8_t bleAdvPayload[BLE_ADV_PAYLOAD_LEN];
+static uint16_t bleAdvInterval = BLE_ADV_INTV_FAST;
+static uint32_t bleAdvStable = 0;
+static volatile int bleAdvRestart = 0;
+
+/******************************************************************************
+* Function Name: bleScore
+*******************************************************************************
+*
+* Summary:
+*  This function fits a happy score in the byte the frames and the
+*  advertising data carry it in. A score is at most 100, but a temperature
+*  average below 0 C makes it negative in the dark, down to -133 at the
+*  lowest TEMP reading (see Fixed.h); it is sent as 0 then.
+*
+* Parameters:
+*  score: happy score
+*
+* Return:
+*  The score, 0 to 100
+*
+******************************************************************************/
+uint8_t bleScore(int32_t score)
+{
+    if (score < 0)
+        return 0u;
+    return (uint8_t)(score > FRAME_SCORE_MAX ? FRAME_SCORE_MAX : score);
+}
+
+/******************************************************************************
+* Function Name: bleStartAdvertising
+*******************************************************************************
+*
+* Summary:
+*  This function starts advertising, at the telemetry interval when the
+*  advertising telemetry is used.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+******************************************************************************/
+void bleStartAdvertising(void)
+{
+    cy_stc_ble_gapp_disc_mode_info_t *mode =
+        &cy_ble_discoveryModeInfo[CY_BLE_PERIPHERAL_CONFIGURATION_0_INDEX];
+    
+    if (BLE_ADV_TELEMETRY)
+    {
+        mode->advParam->advIntvMin = bleAdvInterval;
+        mode->advParam->advIntvMax = bleAdvInterval;
+        Cy_BLE_GAPP_StartAdvertisement(CY_BLE_ADVERTISING_CUSTOM, CY_BLE_PERIPHERAL_CONFIGURATION_0_INDEX);
+    }
+    else
+        Cy_BLE_GAPP_StartAdvertisement(CY_BLE_ADVERTISING_FAST, CY_BLE_PERIPHERAL_CONFIGURATION_0_INDEX);
+}
+
+/******************************************************************************
+* Function Name: bleAdvInit
+*******************************************************************************
+*
+* Summary:
+*  This function finds how many of the component's AD structures can stay
+*  in front of the telemetry. They are kept in order until one would not
+*  leave room for it; the flags and the device name come first.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+******************************************************************************/
+void bleAdvInit(void)
+{
+    cy_stc_ble_gapp_disc_data_t *adv =
+        cy_ble_discoveryModeInfo[CY_BLE_PERIPHERAL_CONFIGURATION_0_INDEX].advData;
+    uint8_t pos = 0;
+    
+    while (pos < adv->advDataLen &&
+           pos + 1u + adv->advData[pos] + 4u + BLE_ADV_PAYLOAD_LEN <= CY_BLE_GAP_MAX_ADV_DATA_LEN)
+        pos += 1u + adv->advData[pos];
+    bleAdvBaseLen = pos;
+}
+
+/******************************************************************************
+* Function Name: bleAdvUpdate
+*******************************************************************************
+*
+* Summary:
+*  This function puts the latest result in the advertising data. While the
+*  result keeps changing, the collar advertises at BLE_ADV_INTV_FAST; once it
+*  has held for BLE_ADV_STABLE results, at BLE_ADV_INTV_SLOW. The payload is:
+*   0: version, 1: sequence, 2: happy score (0 to 100), 3: flags,
+*   4: behaviour, 5: posture, 6-7: ODBA in mg, little endian, 8: stride
+*   frequency, 1/20 Hz
+*
+* Parameters:
+*  r: latest result from the CM4
+*
+* Return:
+*  None
+*
+******************************************************************************/
+void bleAdvUpdate(const struct moo_result *r)
+{
+    cy_stc_ble_gapp_disc_mode_info_t *mode =
+        &cy_ble_discoveryModeInfo[CY_BLE_PERIPHERAL_CONFIGURATION_0_INDEX];
+    uint8_t payload[BLE_ADV_PAYLOAD_LEN];
+    uint8_t *ad = &mode->advData->advData[bleAdvBaseLen];
+    uint32_t odba = r->odba * 1000u / ACC_LSB_PER_G;
+    uint16_t interval;
+    uint32_t intr;
+    
+    if (!BLE_ADV_TELEMETRY)
+        return;
+    
+    payload[0] = BLE_ADV_VERSION;
+    payload[1] = (uint8_t)r->seq;
+    payload[2] = bleScore(r->happy_score);
+    payload[3] = (r->lightFlag ? BLE_ADV_FLAG_LIGHT : 0u) |
+                 (r->tempFlag ? BLE_ADV_FLAG_TEMP : 0u) |
+                 (accInactive ? BLE_ADV_FLAG_STILL : 0u) |
+                 (r->provisional ? BLE_ADV_FLAG_PROVISIONAL : 0u);
+    payload[4] = (uint8_t)r->behaviour;
+    payload[5] = (uint8_t)r->posture;
+    payload[6] = (uint8_t)(odba > 0xFFFFu ? 0xFFu : odba);
+    payload[7] = (uint8_t)(odba > 0xFFFFu ? 0xFFu : odba >> 8);
+    payload[8] = (uint8_t)(r->stride_freq / 5u);
+    
+    /* Pace the advertising by how fast the report changes, the sequence
+       number aside */
+    if (memcmp(&payload[2], &bleAdvPayload[2], BLE_ADV_PAYLOAD_LEN - 2u) != 0)
+        bleAdvStable = 0;
+    else if (bleAdvStable < BLE_ADV_STABLE)
+        bleAdvStable++;
+    interval = bleAdvStable < BLE_ADV_STABLE ? BLE_ADV_INTV_FAST : BLE_ADV_INTV_SLOW;
+    memcpy(bleAdvPayload, payload, BLE_ADV_PAYLOAD_LEN);
+    
+    intr = Cy_SysLib_EnterCriticalSection();
+    ad[0] = 3u + BLE_ADV_PAYLOAD_LEN;
+    ad[1] = 0xFFu;          /* Manufacturer specific data */
+    ad[2] = (uint8_t)BLE_ADV_COMPANY_ID;
+    ad[3] = (uint8_t)(BLE_ADV_COMPANY_ID >> 8);
+    memcpy(&ad[4], payload, BLE_ADV_PAYLOAD_LEN);
+    mode->advData->advDataLen = bleAdvBaseLen + 4u + BLE_ADV_PAYLOAD_LEN;
+    
+    if (Cy_BLE_GetAdvertisementState() == CY_BLE_ADV_STATE_ADVERTISING)
+    {
+        if (interval != bleAdvInterval)
+        {
+            /* The interval only changes on a restart, from the stop event */
+            bleAdvInterval = interval;
+            bleAdvRestart = 1;
+            Cy_BLE_GAPP_StopAdvertisement();
+        }
+        else
+            Cy_BLE_GAPP_UpdateAdvScanData(mode);
+    }
+    else
+        bleAdvInterval = interval;
+    Cy_SysLib_ExitCriticalSection(intr);
+}
+
+/******************************************************************************
+* Function Name: bleFrameFits
+*******************************************************************************
+*
+* Summary:
+*  This function tells whether a frame fits in one notification at the
+*  negotiated ATT MTU, which leaves MTU - 3 bytes for the value.
+*
+* Parameters:
+*  len: frame length
+*
+* Return:
+*  1 if it fits, 0 if not until the MTU exchange is over, -1 if it never
+*  will on this connection
+*
+******************************************************************************/
+int bleFrameFits(uint16_t len)
+{
+    if (len + 3u <= bleMtu)
+        return 1;
+    return bleMtuDone ? -1 : 0;
+}
+
+/******************************************************************************
+* Function Name: bleWriteRecord
+*******************************************************************************
+*
+* Summary:
+*  This function publishes the whole record as the Device Outbound value in
+*  one write, and notifies the central if one is connected: the report if it
+*  fits the MTU, its brief frame if not.
+*
+* Parameters:
+*  record: record to publish
+*
+* Return:
+*  CY_BLE_SUCCESS if the record is sent or was only meant for the GATT DB,
+*  the stack error if the notification could not be queued
+*
+******************************************************************************/
+cy_en_ble_api_result_t bleWriteRecord(struct ble_record *record)
+{
+    cy_stc_ble_gatt_handle_value_pair_t serviceHandle;
+    cy_en_ble_api_result_t ret;
+    int brief;
+    
+    serviceHandle.attrHandle = CY_BLE_DEVICE_INTERFACE_DEVICE_OUTBOUND_CHAR_HANDLE;
+    serviceHandle.value.val = record->bytes;
+    serviceHandle.value.len = BLE_RECORD_LEN;
+    
+    if (Cy_BLE_GATTS_WriteAttributeValueLocal(&serviceHandle) != CY_BLE_GATT_ERR_NONE)
+        printf("Failed to update BLE record.\r\n");
+    
+    if (!bleConnected)
+    {
+        bleStats.updated++;
+        return CY_BLE_SUCCESS;
+    }
+    
+    brief = bleFrameFits(BLE_RECORD_LEN) != 1;
+    if (brief)
+    {
+        serviceHandle.value.val = record->brief;
+        serviceHandle.value.len = BLE_BRIEF_LEN;
+    }
+    
+    ret = Cy_BLE_GATTS_SendNotification(&bleConnHandle, &serviceHandle);
+    if (brief)
+    {
+        /* Notifying wrote the brief frame to the value, the whole report
+           goes back for a long read */
+        serviceHandle.value.val = record->bytes;
+        serviceHandle.value.len = BLE_RECORD_LEN;
+        Cy_BLE_GATTS_WriteAttributeValueLocal(&serviceHandle);
+    }
+    if (ret == CY_BLE_SUCCESS)
+    {
+        bleStats.notified++;
+        bleStats.brief += brief;
+    }
+    else if (ret == CY_BLE_ERROR_NTF_DISABLED)
+    {
+        /* The central reads the value on demand instead */
+        bleStats.updated++;
+        ret = CY_BLE_SUCCESS;
+    }
+    return ret;
+}
+
+/******************************************************************************
+* Function Name: bleSendHistory
+*******************************************************************************
+*
+* Summary:
+*  This function notifies the next history frame of the sync in progress,
+*  as many records as fit the MTU, and ends the sync with an empty frame
+*  once it has caught up with the newest record. The sync is dropped if the
+*  MTU is left too small for a single record.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  CY_BLE_SUCCESS if the frame is sent or the sync is over,
+*  CY_BLE_ERROR_INVALID_OPERATION if it waits for the MTU exchange, the
+*  stack error if the notification could not be queued
+*
+******************************************************************************/
+cy_en_ble_api_result_t bleSendHistory(void)
+{
+    static struct history_record recs[BLE_SYNC_BATCH];
+    static uint8_t frame[FRAME_HISTORY_LEN(BLE_SYNC_BATCH)];
+    cy_stc_ble_gatts_handle_value_ntf_t ntf;
+    struct frame_header hdr = { FRAME_VERSION, FRAME_TYPE_HISTORY, bleSeq,
+        RtcSeconds() };
+    cy_en_ble_api_result_t ret;
+    int max, n, len;
+    
+    switch (bleFrameFits(FRAME_HISTORY_LEN(1)))
+    {
+        case 0:
+            return CY_BLE_ERROR_INVALID_OPERATION;
+        case -1:
+            /* MTU left at its default, nothing fits */
+            bleSyncing = 0;
+            return CY_BLE_SUCCESS;
+    }
+    max = ((int)bleMtu - 3 - FRAME_HISTORY_LEN(0)) / FRAME_HISTORY_RECORD_LEN;
+    if (max > BLE_SYNC_BATCH)
+        max = BLE_SYNC_BATCH;
+    
+    n = history_read(&bleHistory, bleSyncNext, recs, max);
+    len = frame_encode_history(&hdr, recs, n, frame, sizeof(frame));
+    
+    ntf.connHandle = bleConnHandle;
+    ntf.handleValPair.attrHandle = CY_BLE_DEVICE_INTERFACE_DEVICE_OUTBOUND_CHAR_HANDLE;
+    ntf.handleValPair.value.val = frame;
+    ntf.handleValPair.value.len = (uint16_t)len;
+    ret = Cy_BLE_GATTS_Notification(&ntf);
+    if (ret != CY_BLE_SUCCESS)
+        return ret;
+    
+    bleSeq++;
+    if (n == 0)
+        bleSyncing = 0;
+    else
+    {
+        bleSyncNext = recs[n - 1].seq + 1u;
+        bleStats.synced += n;
+    }
+    return CY_BLE_SUCCESS;
+}
+
+/******************************************************************************
+* Function Name: bleSendConfig
+*******************************************************************************
+*
+* Summary:
+*  This function notifies a configuration frame with the current settings,
+*  in answer to a configuration command. If the MTU is left too small for
+*  it, the frame is written to the Device Outbound value instead.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  CY_BLE_SUCCESS if the frame is sent, CY_BLE_ERROR_INVALID_OPERATION if it
+*  waits for the MTU exchange, the stack error if the notification could not
+*  be queued
+*
+******************************************************************************/
+cy_en_ble_api_result_t bleSendConfig(void)
+{
+    static uint8_t frame[FRAME_CONFIG_LEN(CONFIG_KEYS)];
+    cy_stc_ble_gatts_handle_value_ntf_t ntf;
+    struct frame_header hdr = { FRAME_VERSION, FRAME_TYPE_CONFIG, bleSeq,
+        RtcSeconds() };
+    cy_en_ble_api_result_t ret;
+    int len;
+    
+    if (bleFrameFits(sizeof(frame)) == 0)
+        return CY_BLE_ERROR_INVALID_OPERATION;
+    len = frame_encode_config(&hdr, &settings, frame, sizeof(frame));
+    
+    ntf.connHandle = bleConnHandle;
+    ntf.handleValPair.attrHandle = CY_BLE_DEVICE_INTERFACE_DEVICE_OUTBOUND_CHAR_HANDLE;
+    ntf.handleValPair.value.val = frame;
+    ntf.handleValPair.value.len = (uint16_t)len;
+    if (bleFrameFits(sizeof(frame)) < 0)
+    {
+        if (Cy_BLE_GATTS_WriteAttributeValueLocal(&ntf.handleValPair) != CY_BLE_GATT_ERR_NONE)
+            printf("Failed to update BLE configuration.\r\n");
+    }
+    else
+    {
+        ret = Cy_BLE_GATTS_Notification(&ntf);
+        if (ret != CY_BLE_SUCCESS)
+            return ret;
+    }
+    
+    bleSeq++;
+    bleConfigDue = 0;
+    return CY_BLE_SUCCESS;
+}
+
+/******************************************************************************
+* Function Name: bleFlush
+*******************************************************************************
+*
+* Summary:
+*  This function sends queued records until the queue is empty or the stack
+*  is busy, then the answer to a configuration command, then the history if
+*  a sync is in progress; reports go first. It resumes from
+*  CY_BLE_EVT_STACK_BUSY_STATUS once the stack has room again. A report
+*  goes out at the next connection event (see bleRequestConnParams() for
+*  what it costs the radio). Called from the event handler, or with
+*  interrupts masked.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+******************************************************************************/
+void bleFlush(void)
+{
+    struct ble_record record;
+    
+    while (spsc_peek(&bleQueue, &record) == 0)
+    {
+        if (bleConnected &&
+            Cy_BLE_GATT_GetBusyStatus(bleConnHandle.attId) != CY_BLE_STACK_STATE_FREE)
+            break;
+        if (bleWriteRecord(&record) != CY_BLE_SUCCESS)
+            break;
+        spsc_pop(&bleQueue, NULL);
+    }
+    if (spsc_peek(&bleQueue, &record) == 0)
+        return;
+    
+    if (bleConfigDue && bleConnected &&
+        (Cy_BLE_GATT_GetBusyStatus(bleConnHandle.attId) != CY_BLE_STACK_STATE_FREE ||
+         bleSendConfig() != CY_BLE_SUCCESS))
+        return;
+    
+    while (bleSyncing && bleConnected &&
+           Cy_BLE_GATT_GetBusyStatus(bleConnHandle.attId) == CY_BLE_STACK_STATE_FREE)
+    {
+        if (bleSendHistory() != CY_BLE_SUCCESS)
+            break;
+    }
+}
+
+/******************************************************************************
+* Function Name: bleRequestConnParams
+*******************************************************************************
+*
+* Summary:
+*  This function asks the central for a connection interval and slave
+*  latency matched to the reporting rate.
+*
+*  Radio time per report, estimated from the link timing at 1M PHY, not
+*  measured: a packet is on air for 80 us plus 8 us per payload byte, and
+*  packets are 150 us apart. Every event the radio also ramps up and widens
+*  its receive window, about 150 us.
+*   - Empty event, the master's packet and the slave's: 80 + 150 + 80 = 310
+*     us, 460 us with the ramp-up.
+*   - Report, the 26 byte value with 7 bytes of L2CAP and ATT headers in one
+*     33 byte packet (the data length asked for at connection): 80 + 150 +
+*     344 = 574 us, 724 us in all. It goes out at the next event, the event
+*     after it carries the acknowledgement: 460 us more. Without the larger
+*     data length it takes two fragments, 1034 us. The brief frame, 22
+*     bytes, is 486 us (636 us).
+*   - Between reports, CONFIG_REPORT_DEFAULT ticks of 5 s, 75 s: an
+*     empty event every (1 + BLE_CONN_LATENCY) intervals, 7.5 at 2 s, 15
+*     at 1 s.
+*  That is 7.5 * 460 + 724 + 460 = 4.6 ms per report at a 2 s interval,
+*  8.1 ms at 1 s, against about 1 s of advertising and a stack start per
+*  report when the stack was restarted for each one.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+******************************************************************************/
+void bleRequestConnParams(void)
+{
+    cy_stc_ble_l2cap_conn_update_param_info_t param =
+    {
+        .connIntvMin   = BLE_CONN_INTV_MIN,
+        .connIntvMax   = BLE_CONN_INTV_MAX,
+        .connLatency   = BLE_CONN_LATENCY,
+        .supervisionTO = BLE_CONN_TIMEOUT,
+        .bdHandle      = bleConnHandle.bdHandle,
+    };
+    
+    Cy_BLE_L2CAP_LeConnectionParamUpdateRequest(&param);
+}
+
+/******************************************************************************
+* Function Name: bleRequestMtu
+*******************************************************************************
+*
+* Summary:
+*  This function asks the central for the MTU of the BLE component, without
+*  waiting for the central to ask. Whichever exchange completes first sets
+*  bleMtu; until then, frames that do not fit the default MTU are held back.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+******************************************************************************/
+void bleRequestMtu(void)
+{
+    cy_stc_ble_gatt_xchg_mtu_param_t param =
+    {
+        .connHandle = bleConnHandle,
+        .mtu        = CY_BLE_GATT_MTU,
+    };
+    
+    if (Cy_BLE_GATTC_ExchangeMtuReq(&param) != CY_BLE_SUCCESS)
+        bleMtuDone = 1;
+}
+
+/******************************************************************************
+* Function Name: bleRequestDataLength
+*******************************************************************************
+*
+* Summary:
+*  This function asks the controller for the largest LL data length, so a
+*  history frame as large as the MTU goes out in one packet instead of
+*  being fragmented over several.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+******************************************************************************/
+void bleRequestDataLength(void)
+{
+    cy_stc_ble_set_data_length_info_t param =
+    {
+        .bdHandle        = bleConnHandle.bdHandle,
+        .connMaxTxOctets = BLE_DLE_TX_OCTETS,
+        .connMaxTxTime   = BLE_DLE_TX_TIME,
+    };
+    
+    Cy_BLE_SetDataLength(&param);
+}
+
+void genericEventHandler(uint32_t event, void *eventParameter)
+{
+    switch(event)
+    {
+        case CY_BLE_EVT_STACK_ON:
+        case CY_BLE_EVT_GAP_DEVICE_DISCONNECTED:
+        {
+            bleConnected = 0;
+            bleSyncing = 0;
+            bleConfigDue = 0;
+            bleMtu = CY_BLE_GATT_DEFAULT_MTU;
+            bleMtuDone = 0;
+            bleStartAdvertising();
+            break;
+        }
+        case CY_BLE_EVT_GAPP_ADVERTISEMENT_START_STOP:
+        {
+            /* Stopped by bleAdvUpdate() to change the interval */
+            if (bleAdvRestart &&
+                Cy_BLE_GetAdvertisementState() == CY_BLE_ADV_STATE_STOPPED)
+            {
+                bleAdvRestart = 0;
+                if (!bleConnected)
+                    bleStartAdvertising();
+            }
+            break;
+        }
+        case CY_BLE_EVT_GATT_CONNECT_IND:
+        {
+            bleConnHandle = *(cy_stc_ble_conn_handle_t *) eventParameter;
+            bleConnected = 1;
+            bleRequestConnParams();
+            bleRequestMtu();
+            bleRequestDataLength();
+            break;
+        }
+        case CY_BLE_EVT_GATTS_XCNHG_MTU_REQ:
+        case CY_BLE_EVT_GATTC_XCHNG_MTU_RSP:
+        {
+            cy_stc_ble_gatt_xchg_mtu_param_t *param = (cy_stc_ble_gatt_xchg_mtu_param_t *) eventParameter;
+            
+            /* Either side offers its MTU, the smaller wins. Held back
+               frames go out now, or never will */
+            bleMtu = param->mtu < CY_BLE_GATT_MTU ? param->mtu : CY_BLE_GATT_MTU;
+            if (bleMtu < CY_BLE_GATT_DEFAULT_MTU)
+                bleMtu = CY_BLE_GATT_DEFAULT_MTU;
+            bleMtuDone = 1;
+            bleStats.mtu = bleMtu;
+            bleFlush();
+            break;
+        }
+        case CY_BLE_EVT_GATTC_ERROR_RSP:
+        {
+            /* The central refused the exchange, the default MTU stays */
+            if (!bleMtuDone)
+            {
+                bleMtuDone = 1;
+                bleFlush();
+            }
+            break;
+        }
+        case CY_BLE_EVT_GAP_CONNECTION_UPDATE_COMPLETE:
+        {
+            cy_stc_ble_gap_conn_param_updated_in_controller_t *param = (cy_stc_ble_gap_conn_param_updated_in_controller_t *) eventParameter;
+            
+            bleStats.connIntv    = param->connIntv;
+            bleStats.connLatency = param->connLatency;
+            break;
+        }
+        case CY_BLE_EVT_STACK_BUSY_STATUS:
+        {
+            /* Room for the next notification */
+            if (*(uint8_t *) eventParameter == CY_BLE_STACK_STATE_FREE)
+                bleFlush();
+            break;
+        }
+        case CY_BLE_EVT_GATTS_WRITE_CMD_REQ:
+        {
+            cy_stc_ble_gatts_write_cmd_req_param_t *writeReqParameter = (cy_stc_ble_gatts_write_cmd_req_param_t *) eventParameter;
+            
+            uint8_t *val = writeReqParameter->handleValPair.value.val;
+            uint16_t len = writeReqParameter->handleValPair.value.len;
+            uint32_t since;
+            int32_t value;
+            int key;
+            
+            if (CY_BLE_DEVICE_INTERFACE_DEVICE_INBOUND_CHAR_HANDLE == writeReqParameter->handleValPair.attrHandle)
+            {
+                if (frame_decode_sync(val, len, &since) == 0)
+                {
+                    /* Download the history from there on */
+                    bleSyncNext = since;
+                    bleSyncing = 1;
+                }
+                else if (frame_decode_set(val, len, &key, &value) == 0)
+                {
+                    settingsSet(key, value);
+                    bleConfigDue = 1;
+                }
+                else if (len == 1u && val[0] == FRAME_CMD_GET)
+                    bleConfigDue = 1;
+                else if (len == 1u && val[0] == FRAME_CMD_DEFAULTS)
+                {
+                    settingsDefaults();
+                    bleConfigDue = 1;
+                }
+                else
+                    data[0] = val[0];
+                bleFlush();
+                Cy_BLE_GATTS_WriteRsp(writeReqParameter->connHandle);
+            }
+            break;
+        }
+    }
+}
+void bleInterruptNotify()
+{
+    Cy_BLE_ProcessEvents();
+}
+
+/******************************************************************************
+* Function Name: bleInit
+*******************************************************************************
+*
+* Summary:
+*  This function starts the BLE stack once and for all, and waits until it
+*  is on and advertising.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+******************************************************************************/
+void bleInit(void)
+{
+    spsc_init(&bleQueue, bleQueueBuf, sizeof(struct ble_record), BLE_QUEUE_LEN);
+    history_init(&bleHistory, bleHistoryBuf, BLE_HISTORY_LEN, 0);
+    if (BLE_ADV_TELEMETRY)
+        bleAdvInit();
+    
+    Cy_BLE_Start(genericEventHandler);
+    
+    while (Cy_BLE_GetState() != CY_BLE_STATE_ON)
+    {
+        Cy_BLE_ProcessEvents();
+    }
+    Cy_BLE_RegisterAppHostCallback(bleInterruptNotify);
+}
+
+/******************************************************************************
+* Function Name: bleHistoryResume
+*******************************************************************************
+*
+* Summary:
+*  This function numbers the history on from where it was before hibernate.
+*  The records themselves were lost with the RAM. Called once, after
+*  bleInit().
+*
+* Parameters:
+*  seq: sequence number of the next record
+*
+* Return:
+*  None
+*
+******************************************************************************/
+void bleHistoryResume(uint32_t seq)
+{
+    uint32_t intr;
+    
+    /* A sync may be reading it from the event handler */
+    intr = Cy_SysLib_EnterCriticalSection();
+    history_init(&bleHistory, bleHistoryBuf, BLE_HISTORY_LEN, seq);
+    Cy_SysLib_ExitCriticalSection(intr);
+}
+
+/******************************************************************************
+* Function Name: bleLight
+*******************************************************************************
+*
+* Summary:
+*  This function sums the latest light channels, normalized for the
+*  exposure, as the history and the brief frames carry them.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  The sum, saturated to 16 bits
+*
+******************************************************************************/
+uint16_t bleLight(void)
+{
+    uint32_t light;
+    
+    light = (light_range_normalize(lightExposure, xChannel) +
+             light_range_normalize(lightExposure, yChannel) +
+             light_range_normalize(lightExposure, zChannel)) >> LIGHT_NORM_SHIFT;
+    return (uint16_t)(light > 0xFFFFu ? 0xFFFFu : light);
+}
+
+/******************************************************************************
+* Function Name: bleBuildRecord
+*******************************************************************************
+*
+* Summary:
+*  This function encodes the latest readings into a report frame, numbered
+*  and time stamped, and into the brief frame of the same number.
+*
+* Parameters:
+*  record: record to fill in
+*  happy_score: latest happy score
+*
+* Return:
+*  None
+*
+******************************************************************************/
+void bleBuildRecord(struct ble_record *record, int happy_score)
+{
+    struct frame_header hdr = { FRAME_VERSION, FRAME_TYPE_REPORT, bleSeq++,
+        RtcSeconds() };
+    struct frame_report report = { { xChannel, yChannel, zChannel },
+        lightExposure, temperature, { accX, accY, accZ },
+        bleScore(happy_score),
+        (lightFlag ? FRAME_FLAG_LIGHT : 0) | (tempFlag ? FRAME_FLAG_TEMP : 0) |
+        (accInactive ? FRAME_FLAG_STILL : 0) |
+        (provisionalFlag ? FRAME_FLAG_PROVISIONAL : 0) };
+    struct frame_brief brief = { bleLight(),
+        (int16_t)fixed_temp_cdeg(temperature), report.happy_score,
+        report.flags };
+    
+    frame_encode_report(&hdr, &report, record->bytes, BLE_RECORD_LEN);
+    frame_encode_brief(&hdr, &brief, record->brief, BLE_BRIEF_LEN);
+}
+
+/******************************************************************************
+* Function Name: bleAddHistory
+*******************************************************************************
+*
+* Summary:
+*  This function summarizes the latest readings and result into a history
+*  record, evicting the oldest one once the history is full.
+*
+* Parameters:
+*  r: latest result from the CM4
+*
+* Return:
+*  None
+*
+******************************************************************************/
+void bleAddHistory(const struct moo_result *r)
+{
+    struct history_record rec;
+    uint32_t odba;
+    uint32_t intr;
+    
+    odba = r->odba * 1000u / ACC_LSB_PER_G;
+    
+    rec.seq = 0;
+    rec.time = RtcSeconds();
+    rec.light = bleLight();
+    rec.temperature = (int16_t)fixed_temp_cdeg(temperature);
+    rec.odba = (uint16_t)(odba > 0xFFFFu ? 0xFFFFu : odba);
+    rec.happy_score = bleScore(r->happy_score);
+    rec.flags = (r->lightFlag ? FRAME_FLAG_LIGHT : 0) |
+                (r->tempFlag ? FRAME_FLAG_TEMP : 0) |
+                (accInactive ? FRAME_FLAG_STILL : 0) |
+                (r->provisional ? FRAME_FLAG_PROVISIONAL : 0);
+    rec.behaviour = (int8_t)r->behaviour;
+    rec.posture = (int8_t)r->posture;
+    
+    /* A sync may be reading it from the event handler */
+    intr = Cy_SysLib_EnterCriticalSection();
+    history_add(&bleHistory, &rec);
+    Cy_SysLib_ExitCriticalSection(intr);
+}
+
+/******************************************************************************
+* Function Name: broadcastBLE
+*******************************************************************************
+*
+* Summary:
+*  This function queues a report and returns right away. If the queue is
+*  full, the oldest report is dropped in favour of the new one.
+*
+* Parameters:
+*  happy_score: latest happy score
+*
+* Return:
+*  None
+*
+******************************************************************************/
+void broadcastBLE(int happy_score)
+{
+    struct ble_record record;
+    uint32_t intr;
+    
+    bleBuildRecord(&record, happy_score);
+    
+    intr = Cy_SysLib_EnterCriticalSection();
+    if (spsc_push(&bleQueue, &record) != 0)
+    {
+        spsc_pop(&bleQueue, NULL);
+        spsc_push(&bleQueue, &record);
+    }
+    bleStats.queued++;
+    bleFlush();
+    Cy_SysLib_ExitCriticalSection(intr);
+}
+
@@ -0,0 +1,118 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Classifier.h"
+#include "ClassifierModel.h"
+
+#define SECONDS_PER_DAY     (86400u)
+
+int classifier_features(const struct activity_set *set, int32_t *features)
+{
+    if (!set || !features)
+    {
+        return -1;
+    }
+
+    features[CLASSIFIER_ODBA] = (int32_t)set->odba;
+    features[CLASSIFIER_JERK] = (int32_t)set->jerk;
+    features[CLASSIFIER_VAR_X] = (int32_t)set->var[0];
+    features[CLASSIFIER_VAR_Y] = (int32_t)set->var[1];
+    features[CLASSIFIER_VAR_Z] = (int32_t)set->var[2];
+    features[CLASSIFIER_ZC] = set->zc[0] + set->zc[1] + set->zc[2];
+    features[CLASSIFIER_MEAN_X] = set->mean[0];
+    features[CLASSIFIER_MEAN_Y] = set->mean[1];
+    features[CLASSIFIER_MEAN_Z] = set->mean[2];
+    return 0;
+}
+
+int classifier_predict(const int32_t *features)
+{
+    int votes[BEHAVIOUR_COUNT] = {0};
+    const struct classifier_node *node;
+    int t, best = 0;
+
+    if (!features)
+    {
+        return -1;
+    }
+
+    for (t = 0; t < CLASSIFIER_TREES; t++)
+    {
+        node = &classifier_nodes[classifier_roots[t]];
+        while (node->feature >= 0)
+        {
+            node = &classifier_nodes[features[node->feature] <=
+                                     node->threshold ? node->left :
+                                     node->right];
+        }
+        votes[node->left]++;
+    }
+
+    for (t = 1; t < BEHAVIOUR_COUNT; t++)
+    {
+        if (votes[t] > votes[best])
+        {
+            best = t;
+        }
+    }
+    return best;
+}
+
+int classifier_provisional(void)
+{
+    return CLASSIFIER_PROVISIONAL;
+}
+
+int budget_init(struct behaviour_budget *budget)
+{
+    if (!budget)
+    {
+        return -1;
+    }
+
+    memset(budget, 0, sizeof(*budget));
+    return 0;
+}
+
+int budget_add(struct behaviour_budget *budget, uint32_t now, int behaviour,
+               uint32_t *hour)
+{
+    uint32_t elapsed, end, before;
+    int ended = 0;
+
+    if (!budget || !hour || behaviour < 0 || behaviour >= BEHAVIOUR_COUNT)
+    {
+        return -1;
+    }
+
+    if (!budget->started)
+    {
+        budget->started = 1;
+        budget->last = now;
+        return 0;
+    }
+
+    elapsed = now >= budget->last ? now - budget->last :
+              now + SECONDS_PER_DAY - budget->last;
+
+    /* Split the time at the end of the hour it started in */
+    end = (budget->last / SECONDS_PER_HOUR + 1) * SECONDS_PER_HOUR;
+    before = end - budget->last;
+    if (elapsed >= before)
+    {
+        budget->seconds[behaviour] += before;
+        memcpy(hour, budget->seconds, sizeof(budget->seconds));
+        memset(budget->seconds, 0, sizeof(budget->seconds));
+        elapsed -= before;
+        ended = 1;
+        /* Gaps of over an hour are only accounted up to the new hour */
+        if (elapsed > SECONDS_PER_HOUR)
+        {
+            elapsed = now % SECONDS_PER_HOUR;
+        }
+    }
+    budget->seconds[behaviour] += elapsed;
+    budget->last = now;
+    return ended;
+}
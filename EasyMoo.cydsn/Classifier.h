@@ -0,0 +1,124 @@
+#ifndef _CLASSIFIER_H
+#define _CLASSIFIER_H
+
+#include <stdint.h>
+
+#include "Activity.h"
+
+/*
+ * Behaviour classifier
+ *
+ * A small ensemble of decision trees labels a window of accelerometer
+ * features (see Activity.h) with one of the behaviours below. Each tree
+ * votes and the most voted behaviour wins, ties going to the lowest one.
+ *
+ * The trees are integer threshold tests on the features, held in const
+ * tables (ClassifierModel.h) generated by tools/train_classifier.py. An
+ * inference visits at most CLASSIFIER_TREES * CLASSIFIER_MAX_DEPTH nodes,
+ * so its cost is bounded whatever the input. A model trained on synthetic
+ * data only brings the pipeline up, its behaviours are provisional (see
+ * classifier_provisional()).
+ *
+ * behaviour_budget - Time spent in each behaviour per hour of the day
+ *
+ * Time is attributed to the behaviour current when it elapsed, from the RTC
+ * time of day in seconds. When an hour ends, its totals are handed back and
+ * a new hour starts.
+ */
+
+enum behaviour
+{
+    BEHAVIOUR_GRAZING,
+    BEHAVIOUR_RUMINATING,
+    BEHAVIOUR_LYING,
+    BEHAVIOUR_WALKING,
+    BEHAVIOUR_COUNT
+};
+
+/* Feature vector layout, shared with tools/train_classifier.py */
+enum classifier_feature
+{
+    CLASSIFIER_ODBA,
+    CLASSIFIER_JERK,
+    CLASSIFIER_VAR_X,
+    CLASSIFIER_VAR_Y,
+    CLASSIFIER_VAR_Z,
+    CLASSIFIER_ZC,
+    CLASSIFIER_MEAN_X,
+    CLASSIFIER_MEAN_Y,
+    CLASSIFIER_MEAN_Z,
+    CLASSIFIER_FEATURES
+};
+
+/*
+ * classifier_node - Decision tree node
+ * @feature: Feature tested, or -1 for a leaf
+ * @threshold: Go to @left if the feature is <= @threshold, else to @right
+ * @left, @right: Child node indexes; for a leaf, @left is the behaviour
+ */
+struct classifier_node
+{
+    int8_t feature;
+    int32_t threshold;
+    uint16_t left, right;
+};
+
+struct behaviour_budget
+{
+    uint32_t seconds[BEHAVIOUR_COUNT];
+    uint32_t last;              /* Time of day of the last update */
+    int started;
+};
+
+#define SECONDS_PER_HOUR    (3600u)
+
+/*
+ * classifier_features - Build the feature vector of a window
+ * @set: Window features
+ * @features: Receives CLASSIFIER_FEATURES values
+ *
+ * Return: -1 if @set or @features are NULL. 0 otherwise.
+ */
+int classifier_features(const struct activity_set *set, int32_t *features);
+
+/*
+ * classifier_predict - Classify a feature vector
+ * @features: CLASSIFIER_FEATURES values, see classifier_features()
+ *
+ * Return: -1 if @features is NULL. The predicted enum behaviour otherwise.
+ */
+int classifier_predict(const int32_t *features);
+
+/*
+ * classifier_provisional - Whether the model is a placeholder
+ *
+ * Return: 1 if the model was trained on synthetic data, its behaviours and
+ * budgets not to be trusted. 0 otherwise.
+ */
+int classifier_provisional(void);
+
+/*
+ * budget_init - Start an empty budget
+ * @budget: Budget to initialize
+ *
+ * Return: -1 if @budget is NULL. 0 otherwise.
+ */
+int budget_init(struct behaviour_budget *budget);
+
+/*
+ * budget_add - Account the time elapsed since the last update
+ * @budget: Budget to update
+ * @now: Time of day in seconds
+ * @behaviour: Behaviour the time is attributed to
+ * @hour: Receives the totals of the hour, if one ended
+ *
+ * The first call only sets the starting time. Updates must be less than a
+ * day apart.
+ *
+ * Return: -1 if @budget or @hour are NULL, or if @behaviour is out of range.
+ * 1 if an hour ended and @hour was filled in. 0 otherwise.
+ */
+int budget_add(struct behaviour_budget *budget, uint32_t now, int behaviour,
+               uint32_t *hour);
+
+#endif /* _CLASSIFIER_H */
@@ -0,0 +1,58 @@
+/*
+ * ClassifierModel.h - Behaviour classifier model, see Classifier.h
+ *
+ * Generated by tools/train_classifier.py, do not edit.
+ * Training data: synthetic, seed 136, 60 windows per behaviour
+ * Training accuracy: 100.0%
+ */
+
+#ifndef _CLASSIFIER_MODEL_H
+#define _CLASSIFIER_MODEL_H
+
+#define CLASSIFIER_TREES        (5)
+#define CLASSIFIER_MAX_DEPTH    (4)
+#define CLASSIFIER_PROVISIONAL  (1)
+
+static const uint16_t classifier_roots[CLASSIFIER_TREES] = {
+    0, 7, 14, 21, 28
+};
+
+static const struct classifier_node classifier_nodes[] = {
+    /*   0 */ { CLASSIFIER_VAR_Z, 4205, 1, 2 },
+    /*   1 */ { -1, 0, BEHAVIOUR_LYING, 0 },
+    /*   2 */ { CLASSIFIER_MEAN_X, -4621, 3, 4 },
+    /*   3 */ { -1, 0, BEHAVIOUR_GRAZING, 0 },
+    /*   4 */ { CLASSIFIER_JERK, 686, 5, 6 },
+    /*   5 */ { -1, 0, BEHAVIOUR_RUMINATING, 0 },
+    /*   6 */ { -1, 0, BEHAVIOUR_WALKING, 0 },
+    /*   7 */ { CLASSIFIER_JERK, 171, 8, 9 },
+    /*   8 */ { -1, 0, BEHAVIOUR_LYING, 0 },
+    /*   9 */ { CLASSIFIER_MEAN_X, -4592, 10, 11 },
+    /*  10 */ { -1, 0, BEHAVIOUR_GRAZING, 0 },
+    /*  11 */ { CLASSIFIER_VAR_Y, 95755, 12, 13 },
+    /*  12 */ { -1, 0, BEHAVIOUR_RUMINATING, 0 },
+    /*  13 */ { -1, 0, BEHAVIOUR_WALKING, 0 },
+    /*  14 */ { CLASSIFIER_ZC, 12, 15, 18 },
+    /*  15 */ { CLASSIFIER_JERK, 171, 16, 17 },
+    /*  16 */ { -1, 0, BEHAVIOUR_LYING, 0 },
+    /*  17 */ { -1, 0, BEHAVIOUR_RUMINATING, 0 },
+    /*  18 */ { CLASSIFIER_VAR_X, 770430, 19, 20 },
+    /*  19 */ { -1, 0, BEHAVIOUR_GRAZING, 0 },
+    /*  20 */ { -1, 0, BEHAVIOUR_WALKING, 0 },
+    /*  21 */ { CLASSIFIER_ODBA, 1585, 22, 27 },
+    /*  22 */ { CLASSIFIER_VAR_Y, 2924, 23, 24 },
+    /*  23 */ { -1, 0, BEHAVIOUR_LYING, 0 },
+    /*  24 */ { CLASSIFIER_MEAN_X, -3953, 25, 26 },
+    /*  25 */ { -1, 0, BEHAVIOUR_GRAZING, 0 },
+    /*  26 */ { -1, 0, BEHAVIOUR_RUMINATING, 0 },
+    /*  27 */ { -1, 0, BEHAVIOUR_WALKING, 0 },
+    /*  28 */ { CLASSIFIER_ODBA, 540, 29, 32 },
+    /*  29 */ { CLASSIFIER_MEAN_Z, 7681, 30, 31 },
+    /*  30 */ { -1, 0, BEHAVIOUR_LYING, 0 },
+    /*  31 */ { -1, 0, BEHAVIOUR_RUMINATING, 0 },
+    /*  32 */ { CLASSIFIER_ODBA, 1600, 33, 34 },
+    /*  33 */ { -1, 0, BEHAVIOUR_GRAZING, 0 },
+    /*  34 */ { -1, 0, BEHAVIOUR_WALKING, 0 },
+};
+
+#endif /* _CLASSIFIER_MODEL_H */
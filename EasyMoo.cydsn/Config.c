@@ -0,0 +1,62 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Config.h"
+
+/* Default and range of every setting */
+static const struct
+{
+    int32_t def;
+    int32_t min;
+    int32_t max;
+} config_limits[CONFIG_KEYS] =
+{
+    [CONFIG_TICK]         = { CONFIG_TICK_DEFAULT, 100, 59000 },
+    [CONFIG_REPORT_EVERY] = { CONFIG_REPORT_DEFAULT, 1, 720 },
+    [CONFIG_INACTIVE]     = { CONFIG_INACTIVE_DEFAULT, 10, 86400 },
+    [CONFIG_LIGHT_CUTOFF] = { CONFIG_LIGHT_CUTOFF_DEFAULT, 0, 65535 },
+    [CONFIG_CRIT_TEMP]    = { CONFIG_CRIT_TEMP_DEFAULT, -40, 85 },
+    [CONFIG_CRIT_LIGHT]   = { CONFIG_CRIT_LIGHT_DEFAULT, 1, 720 },
+    [CONFIG_ACC_TICK]     = { CONFIG_ACC_TICK_DEFAULT, 100, 59000 },
+    [CONFIG_HIBERNATE]    = { CONFIG_HIBERNATE_DEFAULT, 0, 3600 },
+};
+
+int config_defaults(struct config *c)
+{
+    int i;
+
+    if (!c)
+    {
+        return -1;
+    }
+
+    for (i = 0; i < CONFIG_KEYS; i++)
+    {
+        c->value[i] = config_limits[i].def;
+    }
+    return 0;
+}
+
+int config_set(struct config *c, int key, int32_t value)
+{
+    if (!c || key < 0 || key >= CONFIG_KEYS ||
+        value < config_limits[key].min || value > config_limits[key].max)
+    {
+        return -1;
+    }
+
+    c->value[key] = value;
+    return 0;
+}
+
+int config_get(const struct config *c, int key, int32_t *value)
+{
+    if (!c || !value || key < 0 || key >= CONFIG_KEYS)
+    {
+        return -1;
+    }
+
+    *value = c->value[key];
+    return 0;
+}
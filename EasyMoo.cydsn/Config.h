@@ -0,0 +1,92 @@
+#ifndef _CONFIG_H
+#define _CONFIG_H
+
+#include <stdint.h>
+
+/*
+ * Runtime configuration
+ *
+ * The sampling and reporting rates and the thresholds that used to be built
+ * in are kept in a configuration instead, so they can be retuned per herd
+ * without reflashing: battery life for resolution. Every setting has a key,
+ * a default and a range; a setting can only ever hold a value in its range.
+ *
+ *	CONFIG_TICK		Light acquisition period, in ms
+ *	CONFIG_REPORT_EVERY	Ticks between two reports
+ *	CONFIG_INACTIVE		Seconds without motion before sleeping
+ *	CONFIG_LIGHT_CUTOFF	Light below which a sample is dark, in
+ *				default exposure counts
+ *	CONFIG_CRIT_TEMP	Temperature that raises the flag, in degrees
+ *	CONFIG_CRIT_LIGHT	Dark samples that raise the light flag
+ *	CONFIG_ACC_TICK		Accelerometer service period, in ms
+ *	CONFIG_HIBERNATE	Seconds to hibernate at a time when idle at
+ *				night, 0 to never hibernate
+ *
+ * Keys are only ever added at the end, so a configuration saved by an
+ * older firmware still loads, the new keys taking their defaults. The two
+ * periods were in seconds before, which is out of their range now: those
+ * load as their defaults too.
+ */
+
+enum config_key
+{
+    CONFIG_TICK,
+    CONFIG_REPORT_EVERY,
+    CONFIG_INACTIVE,
+    CONFIG_LIGHT_CUTOFF,
+    CONFIG_CRIT_TEMP,
+    CONFIG_CRIT_LIGHT,
+    CONFIG_ACC_TICK,
+    CONFIG_HIBERNATE,
+    CONFIG_KEYS
+};
+
+/* Defaults, the values that were built in */
+#define CONFIG_TICK_DEFAULT         (5000)
+#define CONFIG_REPORT_DEFAULT       (15)
+#define CONFIG_INACTIVE_DEFAULT     (600)
+#define CONFIG_LIGHT_CUTOFF_DEFAULT (50)
+#define CONFIG_CRIT_TEMP_DEFAULT    (20)
+#define CONFIG_CRIT_LIGHT_DEFAULT   (10)
+#define CONFIG_ACC_TICK_DEFAULT     (5000)
+#define CONFIG_HIBERNATE_DEFAULT    (0)
+
+/*
+ * config - Value of every setting
+ * @value: Values, indexed by enum config_key
+ */
+struct config
+{
+    int32_t value[CONFIG_KEYS];
+};
+
+/*
+ * config_defaults - Set every setting to its default
+ * @c: Configuration to reset
+ *
+ * Return: -1 if @c is NULL. 0 otherwise.
+ */
+int config_defaults(struct config *c);
+
+/*
+ * config_set - Change a setting
+ * @c: Configuration to change
+ * @key: enum config_key
+ * @value: New value
+ *
+ * Return: -1 if @c is NULL, if @key is unknown or if @value is out of the
+ * range of @key, @c being left as it was. 0 otherwise.
+ */
+int config_set(struct config *c, int key, int32_t value);
+
+/*
+ * config_get - Read a setting
+ * @c: Configuration to read
+ * @key: enum config_key
+ * @value: Receives the value
+ *
+ * Return: -1 if a pointer is NULL or if @key is unknown. 0 otherwise.
+ */
+int config_get(const struct config *c, int key, int32_t *value);
+
+#endif /* _CONFIG_H */
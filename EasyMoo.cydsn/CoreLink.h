@@ -0,0 +1,332 @@
+/******************************************************************************
+* File Name: CoreLink.h
+*
+* Version: Beta
+*
+* Description: This file contains the inter-core link between the CM0+ and the
+* CM4. The CM0+ only acquires sensor samples and pushes them into a lock-free
+* ring; the CM4, which has an FPU, pops them, runs all the data processing and
+* pushes the results back through a second ring.
+*
+* Related Document: Technical Reference Manual, Inter-Processor Communication
+* Hardware Dependency: CY8CKIT-063-BLE PSoC 6 BLE Pioneer kit
+*
+* Author(s):
+*	Yousef H. Akbar & and Cow Team
+*	Dept. Electrical and Computer Engineering
+*	University of California, Davis
+*******************************************************************************
+* Both rings live in CM0+ SRAM, which the CM4 can address directly. At start up
+* the CM0+ hands the address of the link to the CM4 through an IPC channel.
+* After that, every pushed sample or motion batch raises an IPC notify
+* interrupt on the CM4 so it can sleep until there is work to do. Results are
+* not signalled back: the CM0+ collects them the next time it wakes up. While
+* the result ring is full, the CM4 leaves samples in theirs instead of
+* dropping results, and the CM0+ wakes it up again once it has made room.
+* Configuration changes go to the CM4 through a third ring, ahead of the
+* samples they apply to.
+*
+* Every result also carries the processing state a hibernate snapshot needs
+* (see Hibernate.h). On a wake up from hibernate, the snapshot is handed back
+* to the CM4 with the link itself.
+******************************************************************************/
+
+#ifndef CORE_LINK_H
+#define CORE_LINK_H
+
+#include "project.h"
+#include "Spsc.h"
+#include "Classifier.h"
+#include "Config.h"
+#include "Snapshot.h"
+
+/* IPC resources, the first ones not reserved by the PDL */
+#define CORE_LINK_IPC_CHAN  (CY_IPC_CHAN_USER)
+#define CORE_LINK_IPC_INTR  (CY_IPC_INTR_USER)
+#define CORE_LINK_IPC_IRQN  ((IRQn_Type)(cpuss_interrupts_ipc_0_IRQn + \
+                                         CORE_LINK_IPC_INTR))
+
+/* Ring sizes, must be powers of two */
+#define CORE_LINK_SAMPLES   (16u)
+#define CORE_LINK_RESULTS   (16u)
+#define CORE_LINK_MOTION    (512u)
+#define CORE_LINK_CONFIGS   (4u)
+
+/* One acquisition cycle, as read from the sensors by the CM0+ */
+struct moo_sample {
+	uint32_t seq;
+	uint32_t xChannel, yChannel, zChannel;	/* Normalized, see LightRange.h */
+	uint16_t temperature;
+	int16_t accX, accY, accZ;
+	int16_t gyroX, gyroY, gyroZ;
+	uint8_t exposure;			/* Light sensor range */
+	uint32_t time;				/* RTC time of day, seconds */
+	uint8_t still;				/* No motion, FIFO stopped */
+};
+
+/* Accelerometer and gyroscope scales, +/-4 g and +/-500 dps full scale, and
+ * FIFO record rate, the same for both, 1125 Hz / (1 + ACC_SMPLRT_DIV) (see
+ * accInit()) */
+#define ACC_LSB_PER_G       (8192)
+#define GYRO_LSB_PER_DPS    (65.5f)
+#define ACC_ODR_HZ          (1125.0f / 45.0f)
+
+/* One accelerometer/gyroscope record drained from the ICM-20948 FIFO */
+struct moo_motion {
+	uint32_t t;				/* Record number, at the sensor ODR */
+	int16_t acc[3];
+	int16_t gyro[3];
+};
+
+/* Outcome of processing one sample on the CM4 */
+struct moo_result {
+	uint32_t seq;
+	int32_t happy_score;
+	int32_t window_count;
+	int32_t light_min, light_max;
+	uint32_t odba, jerk;			/* Activity, ACC_LSB_PER_G per g */
+	uint32_t zc;				/* Zero crossings, all axes */
+	uint8_t lightFlag, tempFlag;
+	int8_t behaviour;			/* enum behaviour, -1 if unknown */
+	int8_t budget_hour;			/* Hour that just ended, or -1 */
+	uint16_t budget[BEHAVIOUR_COUNT];	/* Its seconds per behaviour */
+	uint8_t provisional;			/* Behaviour from a placeholder model */
+	uint16_t stride_freq;			/* Last walk, centi-Hz, 0 if none */
+	int8_t regularity;			/* Stride regularity, percent */
+	uint16_t harmonic_ratio;		/* Gait symmetry, Q8 */
+	int8_t posture;				/* enum posture */
+	int8_t head_down;			/* Head below the horizon, degrees */
+	struct snapshot_proc state;		/* To carry over a hibernate */
+};
+
+struct core_link {
+	struct spsc samples;
+	struct spsc results;
+	struct spsc motion;
+	struct spsc config;
+	struct moo_sample sample_buf[CORE_LINK_SAMPLES];
+	struct moo_result result_buf[CORE_LINK_RESULTS];
+	struct moo_motion motion_buf[CORE_LINK_MOTION];
+	struct config config_buf[CORE_LINK_CONFIGS];
+	struct snapshot resume;			/* Valid if resumed */
+	uint8_t resumed;
+};
+
+#if CY_CPU_CORTEX_M0P
+
+static struct core_link coreLink;
+
+/* Function Name: coreLinkInit
+ *
+ * Summary:
+ * This function sets up both rings and hands the address of the link to the
+ * CM4 over the IPC channel. It must be called once, after Cy_SysEnableCM4().
+ * The CM4 waits for the pointer, so the order of start up does not matter.
+ *
+ * Parameters:
+ *	@resume:	snapshot for the CM4 to carry on from, NULL to start
+ *			over.
+ *
+ * Return:
+ *	None.
+ */
+void coreLinkInit(const struct snapshot *resume)
+{
+	IPC_STRUCT_Type *ipc = Cy_IPC_Drv_GetIpcBaseAddress(CORE_LINK_IPC_CHAN);
+
+	coreLink.resumed = resume != NULL;
+	if (resume)
+		coreLink.resume = *resume;
+
+	spsc_init(&coreLink.samples, coreLink.sample_buf,
+			sizeof(struct moo_sample), CORE_LINK_SAMPLES);
+	spsc_init(&coreLink.results, coreLink.result_buf,
+			sizeof(struct moo_result), CORE_LINK_RESULTS);
+	spsc_init(&coreLink.motion, coreLink.motion_buf,
+			sizeof(struct moo_motion), CORE_LINK_MOTION);
+	spsc_init(&coreLink.config, coreLink.config_buf,
+			sizeof(struct config), CORE_LINK_CONFIGS);
+
+	/* The channel is free at boot; retry only covers a stray lock */
+	while (Cy_IPC_Drv_SendMsgPtr(ipc, 1u << CORE_LINK_IPC_INTR,
+				&coreLink) != CY_IPC_DRV_SUCCESS)
+		;
+}
+
+/* Function Name: coreLinkPushSample
+ *
+ * Summary:
+ * This function pushes one sample for the CM4 and wakes it up. If the CM4 has
+ * fallen behind and the ring is full, the sample is dropped and counted in
+ * coreLink.samples.dropped.
+ *
+ * Parameters:
+ *	@sample:	sample to hand over.
+ *
+ * Return:
+ *	0 if the sample was queued, -1 if it was dropped.
+ */
+int coreLinkPushSample(const struct moo_sample *sample)
+{
+	int ret = spsc_push(&coreLink.samples, sample);
+
+	Cy_IPC_Drv_AcquireNotify(Cy_IPC_Drv_GetIpcBaseAddress(CORE_LINK_IPC_CHAN),
+			1u << CORE_LINK_IPC_INTR);
+	return ret;
+}
+
+/* Function Name: coreLinkPushMotion
+ *
+ * Summary:
+ * This function pushes a batch of motion records for the CM4 and wakes it up
+ * once for the whole batch. Records that do not fit are dropped and counted
+ * in coreLink.motion.dropped.
+ *
+ * Parameters:
+ *	@motion:	records to push, oldest first.
+ *	@n:		number of records.
+ *
+ * Return:
+ *	Number of records pushed.
+ */
+int coreLinkPushMotion(const struct moo_motion *motion, int n)
+{
+	int i, pushed = 0;
+
+	for (i = 0; i < n; i++)
+		if (spsc_push(&coreLink.motion, &motion[i]) == 0)
+			pushed++;
+
+	Cy_IPC_Drv_AcquireNotify(Cy_IPC_Drv_GetIpcBaseAddress(CORE_LINK_IPC_CHAN),
+			1u << CORE_LINK_IPC_INTR);
+	return pushed;
+}
+
+/* Function Name: coreLinkPushConfig
+ *
+ * Summary:
+ * This function hands a new configuration over to the CM4, which takes it
+ * before the next sample. Only the CM4 may pop the ring, so if it is full
+ * the configuration is refused and the caller tries again later.
+ *
+ * Parameters:
+ *	@cfg:		configuration to hand over.
+ *
+ * Return:
+ *	0 if the configuration was queued, -1 if the ring is full.
+ */
+int coreLinkPushConfig(const struct config *cfg)
+{
+	int ret = spsc_push(&coreLink.config, cfg);
+
+	Cy_IPC_Drv_AcquireNotify(Cy_IPC_Drv_GetIpcBaseAddress(CORE_LINK_IPC_CHAN),
+			1u << CORE_LINK_IPC_INTR);
+	return ret;
+}
+
+/* Function Name: coreLinkPopResult
+ *
+ * Summary:
+ * This function pops the oldest result produced by the CM4, if any. Popping
+ * from a full ring wakes the CM4 up, as it holds samples back until then.
+ *
+ * Parameters:
+ *	@result:	receives the result.
+ *
+ * Return:
+ *	0 if @result was set, -1 if no result is pending.
+ */
+int coreLinkPopResult(struct moo_result *result)
+{
+	int full = spsc_length(&coreLink.results) == CORE_LINK_RESULTS;
+	int ret = spsc_pop(&coreLink.results, result);
+
+	if (ret == 0 && full)
+		Cy_IPC_Drv_AcquireNotify(
+				Cy_IPC_Drv_GetIpcBaseAddress(CORE_LINK_IPC_CHAN),
+				1u << CORE_LINK_IPC_INTR);
+	return ret;
+}
+
+/* Function Name: coreLinkIdle
+ *
+ * Summary:
+ * This function tells whether the CM4 has taken everything handed over.
+ *
+ * Parameters:
+ *	None.
+ *
+ * Return:
+ *	1 if the sample, motion and configuration rings are empty, 0 otherwise.
+ */
+int coreLinkIdle(void)
+{
+	return spsc_length(&coreLink.samples) == 0 &&
+		spsc_length(&coreLink.motion) == 0 &&
+		spsc_length(&coreLink.config) == 0;
+}
+
+#endif /* CY_CPU_CORTEX_M0P */
+
+#if CY_CPU_CORTEX_M4
+
+static const cy_stc_sysint_t coreLinkIrqCfg = {
+	.intrSrc = CORE_LINK_IPC_IRQN,
+	.intrPriority = 3u,
+};
+
+/* Function Name: coreLinkInterruptHandler
+ *
+ * Summary:
+ * IPC notify handler. It only acknowledges the interrupt; waking the CPU up
+ * is all that is needed, the main loop then drains the sample ring.
+ */
+void coreLinkInterruptHandler(void)
+{
+	IPC_INTR_STRUCT_Type *intr = Cy_IPC_Drv_GetIntrBaseAddr(CORE_LINK_IPC_INTR);
+
+	Cy_IPC_Drv_ClearInterrupt(intr, CY_IPC_NO_NOTIFICATION,
+			1u << CORE_LINK_IPC_CHAN);
+}
+
+/* Function Name: coreLinkAttach
+ *
+ * Summary:
+ * This function enables the IPC notify interrupt and sleeps until the CM0+ has
+ * published the link, then releases the channel so it can be used for
+ * notifications.
+ *
+ * Parameters:
+ *	None.
+ *
+ * Return:
+ *	Address of the link set up by the CM0+.
+ */
+struct core_link *coreLinkAttach(void)
+{
+	IPC_STRUCT_Type *ipc = Cy_IPC_Drv_GetIpcBaseAddress(CORE_LINK_IPC_CHAN);
+	void *link = NULL;
+
+	Cy_IPC_Drv_SetInterruptMask(Cy_IPC_Drv_GetIntrBaseAddr(CORE_LINK_IPC_INTR),
+			CY_IPC_NO_NOTIFICATION, 1u << CORE_LINK_IPC_CHAN);
+	Cy_SysInt_Init(&coreLinkIrqCfg, coreLinkInterruptHandler);
+	NVIC_EnableIRQ(coreLinkIrqCfg.intrSrc);
+
+	for (;;) {
+		/* Masked, so a notify between the check and WFI still wakes us */
+		uint32_t intr = Cy_SysLib_EnterCriticalSection();
+		if (Cy_IPC_Drv_ReadMsgPtr(ipc, &link) == CY_IPC_DRV_SUCCESS) {
+			Cy_SysLib_ExitCriticalSection(intr);
+			break;
+		}
+		Cy_SysPm_CpuEnterSleep(CY_SYSPM_WAIT_FOR_INTERRUPT);
+		Cy_SysLib_ExitCriticalSection(intr);
+	}
+	Cy_IPC_Drv_LockRelease(ipc, CY_IPC_NO_NOTIFICATION);
+
+	return (struct core_link *)link;
+}
+
+#endif /* CY_CPU_CORTEX_M4 */
+
+#endif /* CORE_LINK_H */
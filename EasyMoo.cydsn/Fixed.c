@@ -0,0 +1,33 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Fixed.h"
+
+int32_t fixed_temp_cdeg(uint16_t raw)
+{
+    return (int32_t)raw * FIXED_TEMP_STEP - FIXED_TEMP_OFFSET;
+}
+
+int32_t fixed_happy_score(int32_t light, int32_t light_target, int32_t temp,
+                          int32_t temp_target, int32_t common)
+{
+    int32_t num;
+
+    /* Capping the inputs caps the scores */
+    if (light > light_target * common)
+    {
+        light = light_target * common;
+    }
+    if (temp > temp_target * common)
+    {
+        temp = temp_target * common;
+    }
+
+    /*
+     * (100 * light / (light_target * common) + 100 * temp / (temp_target *
+     * common)) / 2 over a common denominator.
+     */
+    num = 50 * (light * temp_target + temp * light_target);
+    return num / (light_target * temp_target * common);
+}
@@ -0,0 +1,64 @@
+#ifndef _FIXED_H
+#define _FIXED_H
+
+#include <stdint.h>
+
+/*
+ * Fixed-point sensor conversions and scoring
+ *
+ * Neither core may assume an FPU (the CM0+ has none), so all conversions are
+ * done on integers:
+ *
+ *	temperature	centi-degrees Celsius. The AS73211 TEMP register has a
+ *			0.05 C step, which is exact in hundredths but not in any
+ *			binary fraction.
+ *	happy score	integer percent, computed with exact rational arithmetic
+ *			and truncated toward zero.
+ *
+ * Nothing here divides by a variable except fixed_happy_score(), which
+ * divides once per call: its targets come reduced by their common divisor,
+ * worked out at compile time by the caller.
+ */
+
+/* Centi-degrees per TEMP LSB and offset of the TEMP register (Section 7.16) */
+#define FIXED_TEMP_STEP     (5)
+#define FIXED_TEMP_OFFSET   (6690)
+
+/*
+ * fixed_temp_cdeg - Convert the AS73211 TEMP register
+ * @raw: TEMP register, 12 bit result
+ *
+ * Return: Chip temperature in centi-degrees Celsius, raw * 0.05 - 66.9 C.
+ */
+int32_t fixed_temp_cdeg(uint16_t raw);
+
+/*
+ * fixed_happy_score - Happy score from the light and temperature averages
+ * @light: Average light
+ * @light_target: Average light worth 100%, over @common, positive
+ * @temp: Average temperature
+ * @temp_target: Average temperature worth 100%, over @common, positive
+ * @common: A common divisor of the two targets, positive
+ *
+ * Each average scores its percentage of the target, capped at 100, and the
+ * happy score is the mean of the two. @light and @light_target * @common
+ * (and @temp and @temp_target * @common) only need to share units.
+ *
+ * Any common divisor gives the same score, the greatest leaves the most
+ * room: the products 50 * @light * @temp_target and 50 * @temp *
+ * @light_target must add up within 31 bits. The Process.h targets leave room
+ * for averages down to -2^16.
+ *
+ * This is not the float code it replaces, bit for bit: there, rounding
+ * could land a score just either side of a whole number before the
+ * truncation. Light 3584 and temperature 1325 score exactly 7% and 53%,
+ * so 30, where the float code gave 29. Over every light average from 0 to
+ * 60000 and temperature from -6690 to 13785, 71304 of the 1228580476
+ * scores differ, each by one point: 17753 up, 53551 down.
+ *
+ * Return: The happy score in percent, truncated toward zero.
+ */
+int32_t fixed_happy_score(int32_t light, int32_t light_target, int32_t temp,
+                          int32_t temp_target, int32_t common);
+
+#endif /* _FIXED_H */
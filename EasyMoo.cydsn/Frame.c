@@ -0,0 +1,378 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Frame.h"
+
+/* CRC-16/CCITT-FALSE of every byte value */
+static const uint16_t frame_crc_table[256] =
+{
+    0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+    0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF,
+    0x1231, 0x0210, 0x3273, 0x2252, 0x52B5, 0x4294, 0x72F7, 0x62D6,
+    0x9339, 0x8318, 0xB37B, 0xA35A, 0xD3BD, 0xC39C, 0xF3FF, 0xE3DE,
+    0x2462, 0x3443, 0x0420, 0x1401, 0x64E6, 0x74C7, 0x44A4, 0x5485,
+    0xA56A, 0xB54B, 0x8528, 0x9509, 0xE5EE, 0xF5CF, 0xC5AC, 0xD58D,
+    0x3653, 0x2672, 0x1611, 0x0630, 0x76D7, 0x66F6, 0x5695, 0x46B4,
+    0xB75B, 0xA77A, 0x9719, 0x8738, 0xF7DF, 0xE7FE, 0xD79D, 0xC7BC,
+    0x48C4, 0x58E5, 0x6886, 0x78A7, 0x0840, 0x1861, 0x2802, 0x3823,
+    0xC9CC, 0xD9ED, 0xE98E, 0xF9AF, 0x8948, 0x9969, 0xA90A, 0xB92B,
+    0x5AF5, 0x4AD4, 0x7AB7, 0x6A96, 0x1A71, 0x0A50, 0x3A33, 0x2A12,
+    0xDBFD, 0xCBDC, 0xFBBF, 0xEB9E, 0x9B79, 0x8B58, 0xBB3B, 0xAB1A,
+    0x6CA6, 0x7C87, 0x4CE4, 0x5CC5, 0x2C22, 0x3C03, 0x0C60, 0x1C41,
+    0xEDAE, 0xFD8F, 0xCDEC, 0xDDCD, 0xAD2A, 0xBD0B, 0x8D68, 0x9D49,
+    0x7E97, 0x6EB6, 0x5ED5, 0x4EF4, 0x3E13, 0x2E32, 0x1E51, 0x0E70,
+    0xFF9F, 0xEFBE, 0xDFDD, 0xCFFC, 0xBF1B, 0xAF3A, 0x9F59, 0x8F78,
+    0x9188, 0x81A9, 0xB1CA, 0xA1EB, 0xD10C, 0xC12D, 0xF14E, 0xE16F,
+    0x1080, 0x00A1, 0x30C2, 0x20E3, 0x5004, 0x4025, 0x7046, 0x6067,
+    0x83B9, 0x9398, 0xA3FB, 0xB3DA, 0xC33D, 0xD31C, 0xE37F, 0xF35E,
+    0x02B1, 0x1290, 0x22F3, 0x32D2, 0x4235, 0x5214, 0x6277, 0x7256,
+    0xB5EA, 0xA5CB, 0x95A8, 0x8589, 0xF56E, 0xE54F, 0xD52C, 0xC50D,
+    0x34E2, 0x24C3, 0x14A0, 0x0481, 0x7466, 0x6447, 0x5424, 0x4405,
+    0xA7DB, 0xB7FA, 0x8799, 0x97B8, 0xE75F, 0xF77E, 0xC71D, 0xD73C,
+    0x26D3, 0x36F2, 0x0691, 0x16B0, 0x6657, 0x7676, 0x4615, 0x5634,
+    0xD94C, 0xC96D, 0xF90E, 0xE92F, 0x99C8, 0x89E9, 0xB98A, 0xA9AB,
+    0x5844, 0x4865, 0x7806, 0x6827, 0x18C0, 0x08E1, 0x3882, 0x28A3,
+    0xCB7D, 0xDB5C, 0xEB3F, 0xFB1E, 0x8BF9, 0x9BD8, 0xABBB, 0xBB9A,
+    0x4A75, 0x5A54, 0x6A37, 0x7A16, 0x0AF1, 0x1AD0, 0x2AB3, 0x3A92,
+    0xFD2E, 0xED0F, 0xDD6C, 0xCD4D, 0xBDAA, 0xAD8B, 0x9DE8, 0x8DC9,
+    0x7C26, 0x6C07, 0x5C64, 0x4C45, 0x3CA2, 0x2C83, 0x1CE0, 0x0CC1,
+    0xEF1F, 0xFF3E, 0xCF5D, 0xDF7C, 0xAF9B, 0xBFBA, 0x8FD9, 0x9FF8,
+    0x6E17, 0x7E36, 0x4E55, 0x5E74, 0x2E93, 0x3EB2, 0x0ED1, 0x1EF0,
+};
+
+uint16_t frame_crc16(const uint8_t *buf, uint32_t len)
+{
+    uint16_t crc = 0xFFFF;
+    uint32_t i;
+
+    for (i = 0; i < len; i++)
+    {
+        crc = (uint16_t)(crc << 8) ^ frame_crc_table[(crc >> 8) ^ buf[i]];
+    }
+    return crc;
+}
+
+static uint8_t *frame_put16(uint8_t *p, uint16_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    return p + 2;
+}
+
+static uint8_t *frame_put32(uint8_t *p, uint32_t v)
+{
+    p = frame_put16(p, (uint16_t)v);
+    return frame_put16(p, (uint16_t)(v >> 16));
+}
+
+static uint16_t frame_get16(const uint8_t *p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t frame_get32(const uint8_t *p)
+{
+    return frame_get16(p) | ((uint32_t)frame_get16(p + 2) << 16);
+}
+
+static uint8_t *frame_put_header(uint8_t *p, const struct frame_header *hdr,
+                                 int type)
+{
+    *p++ = (uint8_t)((FRAME_VERSION << 4) | type);
+    p = frame_put16(p, hdr->seq);
+    return frame_put32(p, hdr->time);
+}
+
+int frame_encode_report(const struct frame_header *hdr,
+                        const struct frame_report *report, uint8_t *buf,
+                        uint32_t len)
+{
+    uint8_t *p;
+    int i;
+
+    if (!hdr || !report || !buf || len < FRAME_REPORT_LEN)
+    {
+        return -1;
+    }
+
+    p = frame_put_header(buf, hdr, FRAME_TYPE_REPORT);
+    for (i = 0; i < 3; i++)
+    {
+        p = frame_put16(p, report->light[i]);
+    }
+    *p++ = report->exposure;
+    p = frame_put16(p, report->temperature);
+    for (i = 0; i < 3; i++)
+    {
+        p = frame_put16(p, (uint16_t)report->acc[i]);
+    }
+    *p++ = report->happy_score;
+    *p++ = report->flags;
+    frame_put16(p, frame_crc16(buf, FRAME_REPORT_LEN - FRAME_CRC_LEN));
+    return FRAME_REPORT_LEN;
+}
+
+int frame_decode_header(const uint8_t *buf, uint32_t len,
+                        struct frame_header *hdr)
+{
+    if (!buf || !hdr || len < FRAME_HEADER_LEN + FRAME_CRC_LEN)
+    {
+        return -1;
+    }
+    if (frame_crc16(buf, len - FRAME_CRC_LEN) !=
+        frame_get16(buf + len - FRAME_CRC_LEN))
+    {
+        return -1;
+    }
+
+    hdr->version = buf[0] >> 4;
+    hdr->type = buf[0] & 0x0F;
+    hdr->seq = frame_get16(buf + 1);
+    hdr->time = frame_get32(buf + 3);
+    if (hdr->version != FRAME_VERSION)
+    {
+        return -1;
+    }
+    return hdr->type;
+}
+
+int frame_decode_report(const uint8_t *buf, uint32_t len,
+                        struct frame_header *hdr,
+                        struct frame_report *report)
+{
+    const uint8_t *p;
+    int i;
+
+    if (!report || len != FRAME_REPORT_LEN ||
+        frame_decode_header(buf, len, hdr) != FRAME_TYPE_REPORT)
+    {
+        return -1;
+    }
+
+    p = buf + FRAME_HEADER_LEN;
+    for (i = 0; i < 3; i++, p += 2)
+    {
+        report->light[i] = frame_get16(p);
+    }
+    report->exposure = *p++;
+    report->temperature = frame_get16(p);
+    p += 2;
+    for (i = 0; i < 3; i++, p += 2)
+    {
+        report->acc[i] = (int16_t)frame_get16(p);
+    }
+    report->happy_score = *p++;
+    report->flags = *p;
+    return 0;
+}
+
+int frame_encode_brief(const struct frame_header *hdr,
+                       const struct frame_brief *brief, uint8_t *buf,
+                       uint32_t len)
+{
+    uint8_t *p;
+
+    if (!hdr || !brief || !buf || len < FRAME_BRIEF_LEN)
+    {
+        return -1;
+    }
+
+    p = frame_put_header(buf, hdr, FRAME_TYPE_BRIEF);
+    p = frame_put16(p, brief->light);
+    p = frame_put16(p, (uint16_t)brief->temperature);
+    *p++ = brief->happy_score;
+    *p++ = brief->flags;
+    frame_put16(p, frame_crc16(buf, FRAME_BRIEF_LEN - FRAME_CRC_LEN));
+    return FRAME_BRIEF_LEN;
+}
+
+int frame_decode_brief(const uint8_t *buf, uint32_t len,
+                       struct frame_header *hdr, struct frame_brief *brief)
+{
+    const uint8_t *p;
+
+    if (!brief || len != FRAME_BRIEF_LEN ||
+        frame_decode_header(buf, len, hdr) != FRAME_TYPE_BRIEF)
+    {
+        return -1;
+    }
+
+    p = buf + FRAME_HEADER_LEN;
+    brief->light = frame_get16(p);
+    brief->temperature = (int16_t)frame_get16(p + 2);
+    brief->happy_score = p[4];
+    brief->flags = p[5];
+    return 0;
+}
+
+int frame_encode_history(const struct frame_header *hdr,
+                         const struct history_record *recs, int n,
+                         uint8_t *buf, uint32_t len)
+{
+    uint8_t *p;
+    int i;
+
+    if (!hdr || !buf || (n > 0 && !recs) || n < 0 ||
+        n > FRAME_HISTORY_MAX || len < (uint32_t)FRAME_HISTORY_LEN(n))
+    {
+        return -1;
+    }
+
+    p = frame_put_header(buf, hdr, FRAME_TYPE_HISTORY);
+    p = frame_put32(p, n > 0 ? recs[0].seq : 0);
+    *p++ = (uint8_t)n;
+    for (i = 0; i < n; i++)
+    {
+        p = frame_put32(p, recs[i].time);
+        p = frame_put16(p, recs[i].light);
+        p = frame_put16(p, (uint16_t)recs[i].temperature);
+        p = frame_put16(p, recs[i].odba);
+        *p++ = recs[i].happy_score;
+        *p++ = recs[i].flags;
+        *p++ = (uint8_t)recs[i].behaviour;
+        *p++ = (uint8_t)recs[i].posture;
+    }
+    frame_put16(p, frame_crc16(buf, FRAME_HISTORY_LEN(n) - FRAME_CRC_LEN));
+    return FRAME_HISTORY_LEN(n);
+}
+
+int frame_decode_history(const uint8_t *buf, uint32_t len,
+                         struct frame_header *hdr,
+                         struct history_record *recs, int max)
+{
+    const uint8_t *p;
+    uint32_t seq;
+    int i, n;
+
+    if (!recs || len < (uint32_t)FRAME_HISTORY_LEN(0) ||
+        frame_decode_header(buf, len, hdr) != FRAME_TYPE_HISTORY)
+    {
+        return -1;
+    }
+
+    p = buf + FRAME_HEADER_LEN;
+    seq = frame_get32(p);
+    n = p[4];
+    if (len != (uint32_t)FRAME_HISTORY_LEN(n) || n > max)
+    {
+        return -1;
+    }
+
+    p += 5;
+    for (i = 0; i < n; i++, p += FRAME_HISTORY_RECORD_LEN)
+    {
+        recs[i].seq = seq + (uint32_t)i;
+        recs[i].time = frame_get32(p);
+        recs[i].light = frame_get16(p + 4);
+        recs[i].temperature = (int16_t)frame_get16(p + 6);
+        recs[i].odba = frame_get16(p + 8);
+        recs[i].happy_score = p[10];
+        recs[i].flags = p[11];
+        recs[i].behaviour = (int8_t)p[12];
+        recs[i].posture = (int8_t)p[13];
+    }
+    return n;
+}
+
+int frame_encode_sync(uint32_t since, uint8_t *buf)
+{
+    if (!buf)
+    {
+        return -1;
+    }
+
+    buf[0] = FRAME_CMD_SYNC;
+    frame_put32(buf + 1, since);
+    return FRAME_SYNC_LEN;
+}
+
+int frame_decode_sync(const uint8_t *buf, uint32_t len, uint32_t *since)
+{
+    if (!buf || !since || len != FRAME_SYNC_LEN || buf[0] != FRAME_CMD_SYNC)
+    {
+        return -1;
+    }
+
+    *since = frame_get32(buf + 1);
+    return 0;
+}
+
+int frame_encode_config(const struct frame_header *hdr,
+                        const struct config *cfg, uint8_t *buf, uint32_t len)
+{
+    uint8_t *p;
+    int i;
+
+    if (!hdr || !cfg || !buf || len < FRAME_CONFIG_LEN(CONFIG_KEYS))
+    {
+        return -1;
+    }
+
+    p = frame_put_header(buf, hdr, FRAME_TYPE_CONFIG);
+    *p++ = CONFIG_KEYS;
+    for (i = 0; i < CONFIG_KEYS; i++)
+    {
+        p = frame_put32(p, (uint32_t)cfg->value[i]);
+    }
+    frame_put16(p, frame_crc16(buf, FRAME_CONFIG_LEN(CONFIG_KEYS) -
+                                    FRAME_CRC_LEN));
+    return FRAME_CONFIG_LEN(CONFIG_KEYS);
+}
+
+int frame_decode_config(const uint8_t *buf, uint32_t len,
+                        struct frame_header *hdr, struct config *cfg)
+{
+    const uint8_t *p;
+    int i, n, taken = 0;
+
+    if (!cfg || len < FRAME_CONFIG_LEN(0) ||
+        frame_decode_header(buf, len, hdr) != FRAME_TYPE_CONFIG)
+    {
+        return -1;
+    }
+
+    p = buf + FRAME_HEADER_LEN;
+    n = *p++;
+    if (len != (uint32_t)FRAME_CONFIG_LEN(n))
+    {
+        return -1;
+    }
+
+    /* Keys from a newer firmware are skipped */
+    for (i = 0; i < n && i < CONFIG_KEYS; i++, p += 4)
+    {
+        if (config_set(cfg, i, (int32_t)frame_get32(p)) == 0)
+        {
+            taken++;
+        }
+    }
+    return taken;
+}
+
+int frame_encode_set(int key, int32_t value, uint8_t *buf)
+{
+    if (!buf)
+    {
+        return -1;
+    }
+
+    buf[0] = FRAME_CMD_SET;
+    buf[1] = (uint8_t)key;
+    frame_put32(buf + 2, (uint32_t)value);
+    return FRAME_SET_LEN;
+}
+
+int frame_decode_set(const uint8_t *buf, uint32_t len, int *key,
+                     int32_t *value)
+{
+    if (!buf || !key || !value || len != FRAME_SET_LEN ||
+        buf[0] != FRAME_CMD_SET)
+    {
+        return -1;
+    }
+
+    *key = buf[1];
+    *value = (int32_t)frame_get32(buf + 2);
+    return 0;
+}
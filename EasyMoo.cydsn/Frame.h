@@ -0,0 +1,357 @@
+#ifndef _FRAME_H
+#define _FRAME_H
+
+#include <stdint.h>
+
+#include "History.h"
+#include "Config.h"
+
+/*
+ * Telemetry frames
+ *
+ * Telemetry leaves the collar as binary frames of fixed layout, every field
+ * at its full width and little endian, framed by a header and closed by a
+ * CRC:
+ *
+ *	offset	size	field
+ *	0	1	version (high nibble) and type (low nibble)
+ *	1	2	sequence number, wraps around
+ *	3	4	timestamp, RTC seconds
+ *	7	...	payload of the type
+ *	n - 2	2	CRC-16/CCITT-FALSE of everything before it
+ *
+ * A report frame (FRAME_TYPE_REPORT) carries one acquisition cycle:
+ *
+ *	7	2 x 3	light channels X, Y, Z, raw counts
+ *	13	1	light exposure (see LightRange.h)
+ *	14	2	raw TEMP register
+ *	16	2 x 3	acceleration x, y, z, signed counts
+ *	22	1	happy score, percent, 0 to FRAME_SCORE_MAX
+ *	23	1	FRAME_FLAG_* bits
+ *
+ * The happy score of the firmware goes negative when it is cold in the
+ * dark (see Fixed.h); every frame carries it clamped to 0 instead.
+ *
+ * That is 26 bytes, more than the 20 a notification carries at the default
+ * ATT MTU of 23. A brief frame (FRAME_TYPE_BRIEF) carries the same report
+ * cut down to fit, in the units of the history:
+ *
+ *	7	2	light, normalized sum of the channels
+ *	9	2	temperature, centidegrees C, signed
+ *	11	1	happy score, 0 to FRAME_SCORE_MAX
+ *	12	1	FRAME_FLAG_* bits
+ *
+ * A history frame (FRAME_TYPE_HISTORY) carries consecutive records of the
+ * history (see History.h), as many as fit in one notification:
+ *
+ *	7	4	sequence number of the first record
+ *	11	1	number of records, 0 once the history is exhausted
+ *	12	14 x n	records, sequence numbers implied:
+ *			0 timestamp (4), 4 light (2), 6 temperature (2),
+ *			8 ODBA (2), 10 happy score (0 to FRAME_SCORE_MAX),
+ *			11 flags, 12 behaviour, 13 posture
+ *
+ * A client asks for the history with a sync command, FRAME_CMD_SYNC then
+ * the sequence number of the first record it wants (4 bytes). The collar
+ * answers with history frames back to back, then one with no records.
+ *
+ * A configuration frame (FRAME_TYPE_CONFIG) carries every setting (see
+ * Config.h), by key:
+ *
+ *	7	1	number of settings
+ *	8	4 x n	values, signed, in enum config_key order
+ *
+ * It answers the configuration commands, each of which is one command byte
+ * followed by its arguments:
+ *
+ *	FRAME_CMD_SET		key (1), value (4): change one setting
+ *	FRAME_CMD_GET		read every setting
+ *	FRAME_CMD_DEFAULTS	reset every setting to its default
+ *
+ * The settings are saved as a configuration frame too. A frame with fewer
+ * settings than the firmware knows, from an older one, leaves the others
+ * alone.
+ *
+ * The encoder and decoder only use byte operations, so they build on the
+ * collar and on a gateway of any endianness alike. The CRC is table driven
+ * for decoding at high rates. A decoder must reject frames whose version it
+ * does not know; fields are only ever added with a new version.
+ */
+
+#define FRAME_VERSION       (1)
+
+/* Frame types */
+#define FRAME_TYPE_REPORT   (1)
+#define FRAME_TYPE_HISTORY  (2)
+#define FRAME_TYPE_CONFIG   (3)
+#define FRAME_TYPE_BRIEF    (4)
+
+#define FRAME_HEADER_LEN    (7)
+#define FRAME_CRC_LEN       (2)
+#define FRAME_REPORT_LEN    (FRAME_HEADER_LEN + 17 + FRAME_CRC_LEN)
+#define FRAME_BRIEF_LEN     (FRAME_HEADER_LEN + 6 + FRAME_CRC_LEN)
+
+/* History frame of @n records */
+#define FRAME_HISTORY_RECORD_LEN    (14)
+#define FRAME_HISTORY_LEN(n)        (FRAME_HEADER_LEN + 5 + \
+                                     FRAME_HISTORY_RECORD_LEN * (n) + \
+                                     FRAME_CRC_LEN)
+#define FRAME_HISTORY_MAX           (255)
+
+/* Configuration frame of @n settings */
+#define FRAME_CONFIG_LEN(n)         (FRAME_HEADER_LEN + 1 + 4 * (n) + \
+                                     FRAME_CRC_LEN)
+
+/* Client commands */
+#define FRAME_CMD_SYNC      (0x01)
+#define FRAME_SYNC_LEN      (5)
+#define FRAME_CMD_SET       (0x02)
+#define FRAME_SET_LEN       (6)
+#define FRAME_CMD_GET       (0x03)
+#define FRAME_CMD_DEFAULTS  (0x04)
+
+/* Happy score carried, percent */
+#define FRAME_SCORE_MAX     (100)
+
+/* Report flags */
+#define FRAME_FLAG_LIGHT    (0x01)      /* Too long in the dark */
+#define FRAME_FLAG_TEMP     (0x02)      /* Too hot */
+#define FRAME_FLAG_STILL    (0x04)      /* No motion */
+#define FRAME_FLAG_PROVISIONAL (0x08)   /* Behaviour from a placeholder model */
+
+/*
+ * frame_header - Fields common to every frame
+ * @version: Frame version
+ * @type: FRAME_TYPE_*
+ * @seq: Sequence number
+ * @time: Timestamp, RTC seconds
+ */
+struct frame_header
+{
+    uint8_t version;
+    uint8_t type;
+    uint16_t seq;
+    uint32_t time;
+};
+
+/*
+ * frame_report - Payload of a report frame
+ * @light: Light channels X, Y, Z
+ * @exposure: Light exposure
+ * @temperature: Raw TEMP register
+ * @acc: Acceleration x, y, z
+ * @happy_score: Happy score, 0 to FRAME_SCORE_MAX
+ * @flags: FRAME_FLAG_* bits
+ */
+struct frame_report
+{
+    uint16_t light[3];
+    uint8_t exposure;
+    uint16_t temperature;
+    int16_t acc[3];
+    uint8_t happy_score;
+    uint8_t flags;
+};
+
+/*
+ * frame_brief - Payload of a brief frame
+ * @light: Light, normalized sum of the channels
+ * @temperature: Temperature, centidegrees C
+ * @happy_score: Happy score, 0 to FRAME_SCORE_MAX
+ * @flags: FRAME_FLAG_* bits
+ */
+struct frame_brief
+{
+    uint16_t light;
+    int16_t temperature;
+    uint8_t happy_score;
+    uint8_t flags;
+};
+
+/*
+ * frame_crc16 - CRC-16/CCITT-FALSE
+ * @buf: Bytes to check
+ * @len: Number of bytes
+ *
+ * Polynomial 0x1021, initial value 0xFFFF, no reflection, no final xor.
+ *
+ * Return: The CRC of @buf.
+ */
+uint16_t frame_crc16(const uint8_t *buf, uint32_t len);
+
+/*
+ * frame_encode_report - Encode a report frame
+ * @hdr: Header, its version and type are ignored
+ * @report: Payload
+ * @buf: Receives the frame
+ * @len: Size of @buf
+ *
+ * Return: -1 if a pointer is NULL or if @buf is shorter than
+ * FRAME_REPORT_LEN. Length of the frame otherwise.
+ */
+int frame_encode_report(const struct frame_header *hdr,
+                        const struct frame_report *report, uint8_t *buf,
+                        uint32_t len);
+
+/*
+ * frame_decode_header - Check a frame and decode its header
+ * @buf: Frame
+ * @len: Length of the frame
+ * @hdr: Receives the header
+ *
+ * Return: -1 if a pointer is NULL, if the frame is too short, if its CRC
+ * does not match or if its version is not FRAME_VERSION. Its type
+ * otherwise.
+ */
+int frame_decode_header(const uint8_t *buf, uint32_t len,
+                        struct frame_header *hdr);
+
+/*
+ * frame_decode_report - Decode a report frame
+ * @buf: Frame
+ * @len: Length of the frame
+ * @hdr: Receives the header
+ * @report: Receives the payload
+ *
+ * Return: -1 if a pointer is NULL, if the frame does not check (see
+ * frame_decode_header()), or if it is not a report of FRAME_REPORT_LEN
+ * bytes. 0 if @hdr and @report were filled in.
+ */
+int frame_decode_report(const uint8_t *buf, uint32_t len,
+                        struct frame_header *hdr,
+                        struct frame_report *report);
+
+/*
+ * frame_encode_brief - Encode a brief frame
+ * @hdr: Header, its version and type are ignored
+ * @brief: Payload
+ * @buf: Receives the frame
+ * @len: Size of @buf
+ *
+ * Return: -1 if a pointer is NULL or if @buf is shorter than
+ * FRAME_BRIEF_LEN. Length of the frame otherwise.
+ */
+int frame_encode_brief(const struct frame_header *hdr,
+                       const struct frame_brief *brief, uint8_t *buf,
+                       uint32_t len);
+
+/*
+ * frame_decode_brief - Decode a brief frame
+ * @buf: Frame
+ * @len: Length of the frame
+ * @hdr: Receives the header
+ * @brief: Receives the payload
+ *
+ * Return: -1 if a pointer is NULL, if the frame does not check (see
+ * frame_decode_header()), or if it is not a brief frame of FRAME_BRIEF_LEN
+ * bytes. 0 if @hdr and @brief were filled in.
+ */
+int frame_decode_brief(const uint8_t *buf, uint32_t len,
+                       struct frame_header *hdr, struct frame_brief *brief);
+
+/*
+ * frame_encode_history - Encode a history frame
+ * @hdr: Header, its version and type are ignored
+ * @recs: Consecutive records, oldest first
+ * @n: Number of records, 0 to FRAME_HISTORY_MAX
+ * @buf: Receives the frame
+ * @len: Size of @buf
+ *
+ * Return: -1 if a pointer is NULL, if @n is out of range or if @buf is
+ * shorter than FRAME_HISTORY_LEN(@n). Length of the frame otherwise.
+ */
+int frame_encode_history(const struct frame_header *hdr,
+                         const struct history_record *recs, int n,
+                         uint8_t *buf, uint32_t len);
+
+/*
+ * frame_decode_history - Decode a history frame
+ * @buf: Frame
+ * @len: Length of the frame
+ * @hdr: Receives the header
+ * @recs: Receives the records, with their sequence numbers
+ * @max: Room in @recs
+ *
+ * Return: -1 if a pointer is NULL, if the frame does not check (see
+ * frame_decode_header()), if it is not a history frame of consistent
+ * length or if it holds more than @max records. Number of records
+ * otherwise.
+ */
+int frame_decode_history(const uint8_t *buf, uint32_t len,
+                         struct frame_header *hdr,
+                         struct history_record *recs, int max);
+
+/*
+ * frame_encode_sync - Encode a sync command
+ * @since: Sequence number of the first record wanted
+ * @buf: Receives FRAME_SYNC_LEN bytes
+ *
+ * Return: -1 if @buf is NULL. FRAME_SYNC_LEN otherwise.
+ */
+int frame_encode_sync(uint32_t since, uint8_t *buf);
+
+/*
+ * frame_decode_sync - Decode a sync command
+ * @buf: Command
+ * @len: Length of the command
+ * @since: Receives the sequence number of the first record wanted
+ *
+ * Return: -1 if a pointer is NULL or if @buf is not a sync command. 0 if
+ * @since was set.
+ */
+int frame_decode_sync(const uint8_t *buf, uint32_t len, uint32_t *since);
+
+/*
+ * frame_encode_config - Encode a configuration frame
+ * @hdr: Header, its version and type are ignored
+ * @cfg: Settings
+ * @buf: Receives the frame
+ * @len: Size of @buf
+ *
+ * Return: -1 if a pointer is NULL or if @buf is shorter than
+ * FRAME_CONFIG_LEN(CONFIG_KEYS). Length of the frame otherwise.
+ */
+int frame_encode_config(const struct frame_header *hdr,
+                        const struct config *cfg, uint8_t *buf, uint32_t len);
+
+/*
+ * frame_decode_config - Decode a configuration frame
+ * @buf: Frame
+ * @len: Length of the frame
+ * @hdr: Receives the header
+ * @cfg: Settings to update
+ *
+ * Settings the frame does not carry, or carries out of their range, are
+ * left as they are in @cfg.
+ *
+ * Return: -1 if a pointer is NULL, if the frame does not check (see
+ * frame_decode_header()) or if it is not a configuration frame of
+ * consistent length. Number of settings taken otherwise.
+ */
+int frame_decode_config(const uint8_t *buf, uint32_t len,
+                        struct frame_header *hdr, struct config *cfg);
+
+/*
+ * frame_encode_set - Encode a set command
+ * @key: enum config_key
+ * @value: New value
+ * @buf: Receives FRAME_SET_LEN bytes
+ *
+ * Return: -1 if @buf is NULL. FRAME_SET_LEN otherwise.
+ */
+int frame_encode_set(int key, int32_t value, uint8_t *buf);
+
+/*
+ * frame_decode_set - Decode a set command
+ * @buf: Command
+ * @len: Length of the command
+ * @key: Receives the key
+ * @value: Receives the value
+ *
+ * Return: -1 if a pointer is NULL or if @buf is not a set command. 0 if
+ * @key and @value were set.
+ */
+int frame_decode_set(const uint8_t *buf, uint32_t len, int *key,
+                     int32_t *value);
+
+#endif /* _FRAME_H */
@@ -0,0 +1,184 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "Gait.h"
+
+#define GAIT_PI             (3.14159265f)
+
+/* Lags around the expected period searched for the autocorrelation peak */
+#define GAIT_LAG_SEARCH     (2)
+
+float gait_goertzel(const float *x, int n, float f)
+{
+    float coeff = 2.0f * cosf(2.0f * GAIT_PI * f);
+    float s0, s1 = 0.0f, s2 = 0.0f;
+    int i;
+
+    for (i = 0; i < n; i++)
+    {
+        s0 = x[i] + coeff * s1 - s2;
+        s2 = s1;
+        s1 = s0;
+    }
+    return s1 * s1 + s2 * s2 - coeff * s1 * s2;
+}
+
+float gait_autocorr(const float *x, int n, int lag)
+{
+    float r0 = 0.0f, r = 0.0f;
+    int i;
+
+    for (i = 0; i < n; i++)
+    {
+        r0 += x[i] * x[i];
+    }
+    for (i = 0; i + lag < n; i++)
+    {
+        r += x[i] * x[i + lag];
+    }
+    if (r0 <= 0.0f)
+    {
+        return 0.0f;
+    }
+    return (r / (n - lag)) / (r0 / n);
+}
+
+/* Best autocorrelation within GAIT_LAG_SEARCH of @period samples */
+static float gait_regularity(const float *x, int n, float period)
+{
+    int lag = (int)(period + 0.5f);
+    int l, first = lag - GAIT_LAG_SEARCH, last = lag + GAIT_LAG_SEARCH;
+    float r, best = -1.0f;
+
+    if (first < 1)
+    {
+        first = 1;
+    }
+    /* Past half the window, too few products for a stable estimate */
+    if (last > n / 2)
+    {
+        last = n / 2;
+    }
+    if (first > last)
+    {
+        return 0.0f;
+    }
+
+    for (l = first; l <= last; l++)
+    {
+        r = gait_autocorr(x, n, l);
+        if (r > best)
+        {
+            best = r;
+        }
+    }
+    return best;
+}
+
+/* Spectrum magnitude of the windowed signal at @hz */
+static float gait_magnitude(const float *win, int n, float fs, float hz)
+{
+    return sqrtf(gait_goertzel(win, n, hz / fs));
+}
+
+int gait_analyze(const struct store_view *view, float fs, float min_rms,
+                 float *work, struct gait_set *set)
+{
+    float *sig, *win;
+    float mean = 0.0f, sumsq = 0.0f;
+    float df, f, top, m, best_m = -1.0f, best_f = 0.0f, ml, mr, den, delta;
+    float even = 0.0f, odd = 0.0f;
+    int n, i, j, k, pos;
+
+    if (!view || !work || !set || fs <= 0.0f)
+    {
+        return -1;
+    }
+    n = view->len[0] + view->len[1];
+    if (n < GAIT_MIN_LEN || n > GAIT_MAX_LEN)
+    {
+        return -1;
+    }
+
+    memset(set, 0, sizeof(*set));
+    sig = work;
+    win = work + n;
+
+    /* Acceleration magnitude, independent of how the collar sits */
+    pos = 0;
+    for (j = 0; j < 2; j++)
+    {
+        for (i = 0; i < view->len[j]; i++)
+        {
+            float x = view->x[j][i], y = view->y[j][i], z = view->z[j][i];
+
+            sig[pos] = sqrtf(x * x + y * y + z * z);
+            mean += sig[pos++];
+        }
+    }
+
+    /* Only the dynamic part is left once gravity (the mean) is removed */
+    mean /= n;
+    for (i = 0; i < n; i++)
+    {
+        sig[i] -= mean;
+        sumsq += sig[i] * sig[i];
+        win[i] = sig[i] * (0.5f - 0.5f * cosf(2.0f * GAIT_PI * i / (n - 1)));
+    }
+    set->rms = sqrtf(sumsq / n);
+    if (set->rms < min_rms)
+    {
+        return 1;
+    }
+
+    /* Step frequency: strongest half bin in the search band */
+    df = fs / n / 2.0f;
+    top = GAIT_STEP_MAX < fs / 2.0f - df ? GAIT_STEP_MAX : fs / 2.0f - df;
+    for (k = 0; (f = GAIT_STEP_MIN + k * df) <= top; k++)
+    {
+        m = gait_magnitude(win, n, fs, f);
+        if (m > best_m)
+        {
+            best_m = m;
+            best_f = f;
+        }
+    }
+    if (best_m <= 0.0f)
+    {
+        return 1;
+    }
+
+    /* The peak lies between half bins, place it on the parabola through
+       its neighbours */
+    ml = gait_magnitude(win, n, fs, best_f - df);
+    mr = gait_magnitude(win, n, fs, best_f + df);
+    den = ml - 2.0f * best_m + mr;
+    delta = den < 0.0f ? 0.5f * (ml - mr) / den : 0.0f;
+    if (delta > 0.5f || delta < -0.5f)
+    {
+        delta = delta > 0.0f ? 0.5f : -0.5f;
+    }
+    set->step_freq = best_f + delta * df;
+    set->stride_freq = set->step_freq / 2.0f;
+
+    /* Harmonic ratio over the stride harmonics below Nyquist */
+    for (k = 1; k <= GAIT_HARMONICS && k * set->stride_freq < fs / 2.0f; k++)
+    {
+        m = gait_magnitude(win, n, fs, k * set->stride_freq);
+        if (k & 1)
+        {
+            odd += m;
+        }
+        else
+        {
+            even += m;
+        }
+    }
+    set->harmonic_ratio = odd > 0.0f ? even / odd : 0.0f;
+
+    set->step_reg = gait_regularity(sig, n, fs / set->step_freq);
+    set->stride_reg = gait_regularity(sig, n, fs / set->stride_freq);
+    return 0;
+}
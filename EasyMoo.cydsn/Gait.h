@@ -0,0 +1,111 @@
+#ifndef _GAIT_H
+#define _GAIT_H
+
+#include <stdint.h>
+
+#include "Store.h"
+
+/*
+ * Gait analysis over a window of accelerometer samples
+ *
+ * While walking, the acceleration magnitude |a| rises and falls with every
+ * footfall. Its spectrum has a peak at the step frequency and, since a
+ * stride is two steps, harmonics of the stride frequency. A sound gait
+ * repeats from one step to the next, so its energy sits in the even
+ * harmonics of the stride. Lameness makes the two steps of a stride differ,
+ * which moves energy to the odd harmonics and lowers the harmonic ratio:
+ *
+ *	HR = sum of even harmonic amplitudes / sum of odd harmonic amplitudes
+ *
+ * The steps of an even gait also look alike in time. The regularity is the
+ * normalized autocorrelation of the signal at the stride period, and at the
+ * step period for the step regularity. Both are 1 for a perfectly periodic
+ * gait and fall as the gait becomes irregular.
+ *
+ * Only a few frequencies are of interest, so the spectrum is sampled with a
+ * bank of Goertzel filters (one O(N) pass per frequency) rather than a full
+ * FFT. The step frequency is searched between GAIT_STEP_MIN and
+ * GAIT_STEP_MAX every half bin of a Hann windowed signal, and refined by
+ * parabolic interpolation between neighbouring bins.
+ *
+ * The kernels are plain single precision C: the CM4 runs them on its FPU,
+ * and they build unchanged on a host for checks against reference outputs.
+ *
+ * All storage is supplied by the caller, eg for a 256 sample window:
+ *
+ *	static float work[2 * 256];
+ *	struct gait_set set;
+ *	store_view(acc, 256, &view);
+ *	gait_analyze(&view, 25.0f, 400.0f, work, &set);
+ */
+
+/* Step frequency search band, in Hz */
+#define GAIT_STEP_MIN       (1.0f)
+#define GAIT_STEP_MAX       (4.0f)
+
+/* Stride harmonics in the harmonic ratio */
+#define GAIT_HARMONICS      (10)
+
+/* Window length limits */
+#define GAIT_MIN_LEN        (64)
+#define GAIT_MAX_LEN        (2048)
+
+/*
+ * gait_set - Gait indicators of a window
+ * @step_freq: Step frequency, in Hz
+ * @stride_freq: Stride frequency, half the step frequency, in Hz
+ * @step_reg: Autocorrelation at the step period, -1 to 1
+ * @stride_reg: Autocorrelation at the stride period, -1 to 1
+ * @harmonic_ratio: Even over odd stride harmonic amplitudes
+ * @rms: RMS of the dynamic magnitude, in sample units
+ */
+struct gait_set
+{
+    float step_freq;
+    float stride_freq;
+    float step_reg;
+    float stride_reg;
+    float harmonic_ratio;
+    float rms;
+};
+
+/*
+ * gait_goertzel - Spectrum power at one frequency
+ * @x: Signal
+ * @n: Number of samples
+ * @f: Frequency, in cycles per sample (0 to 0.5)
+ *
+ * Return: |X(f)|^2, the squared magnitude of the DFT of @x at @f. @f need
+ * not fall on a DFT bin.
+ */
+float gait_goertzel(const float *x, int n, float f);
+
+/*
+ * gait_autocorr - Normalized autocorrelation at one lag
+ * @x: Zero mean signal
+ * @n: Number of samples
+ * @lag: Lag, in samples, 0 to @n - 1
+ *
+ * Return: The unbiased autocorrelation at @lag over the one at lag 0, or 0
+ * if @x is all zeros.
+ */
+float gait_autocorr(const float *x, int n, int lag);
+
+/*
+ * gait_analyze - Extract the gait indicators of a window
+ * @view: Accelerometer samples, oldest first
+ * @fs: Sample rate, in Hz
+ * @min_rms: Least RMS of the dynamic magnitude that counts as walking, in
+ * sample units
+ * @work: Storage for twice as many floats as samples in @view
+ * @set: Receives the indicators
+ *
+ * Return: -1 if a pointer is NULL, @fs is not positive or @view holds fewer
+ * than GAIT_MIN_LEN or more than GAIT_MAX_LEN samples. 1 if the window is
+ * too quiet to be a gait, in which case only @set->rms is filled in. 0 if
+ * @set was filled in.
+ */
+int gait_analyze(const struct store_view *view, float fs, float min_rms,
+                 float *work, struct gait_set *set);
+
+#endif /* _GAIT_H */
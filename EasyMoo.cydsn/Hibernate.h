@@ -0,0 +1,109 @@
+/******************************************************************************
+* File Name: Hibernate.h
+*
+* Version: Beta
+*
+* Description: This file contains the hibernate duty cycling of the collar.
+* When idle for long, at night, the CM0+ snapshots the application state (see
+* Snapshot.h) into the backup registers and hibernates until the RTC alarm.
+* Waking up from hibernate is a reset: the snapshot then takes the place of
+* the start up delay and of the parts of the start up that only set up what
+* kept its state.
+*
+* Related Document: Technical Reference Manual, Power Modes
+* Hardware Dependency: CY8CKIT-063-BLE PSoC 6 BLE Pioneer kit
+*
+* Author(s):
+*	Yousef H. Akbar & and Cow Team
+*	Dept. Electrical and Computer Engineering
+*	University of California, Davis
+*******************************************************************************
+* Hibernate draws far less than deep sleep, but everything but the backup
+* domain is off: the RAM of both cores, the MCWDT (see Timer.h) and the BLE
+* link. Only the RTC alarm wakes up from it, INT1 of the accelerometer is not
+* on a hibernate wake up pin; motion in the meantime is latched on the sensor
+* and serviced on the next wake up. The history records kept in RAM are lost,
+* their sequence numbers carry on, so a download shows the gap.
+*
+* The backup registers keep their contents through hibernate. A snapshot is
+* only used once, a reset that is not a wake up from hibernate starts over.
+* Must be included after RTC_Alarm.h.
+******************************************************************************/
+
+#ifndef HIBERNATE_H
+#define HIBERNATE_H
+
+#include "project.h"
+#include "Snapshot.h"
+
+/******************************************************************************
+* Function Name: hibernateResume
+*******************************************************************************
+*
+* Summary:
+*  This function tells a wake up from hibernate from any other start up, and
+*  reads the snapshot taken before it. The pins, held through hibernate, are
+*  released. It must be called first thing in main().
+*
+* Parameters:
+*  snap: receives the snapshot
+*
+* Return:
+*  0 if woken up from hibernate with a valid snapshot, -1 to start over
+*
+******************************************************************************/
+int hibernateResume(struct snapshot *snap)
+{
+    uint32_t words[SNAPSHOT_WORDS];
+    int i;
+
+    if ((Cy_SysLib_GetResetReason() & CY_SYSLIB_RESET_HIB_WAKEUP) == 0u)
+        return -1;
+    Cy_SysPm_IoUnfreeze();
+
+    for (i = 0; i < SNAPSHOT_WORDS; i++)
+        words[i] = BACKUP->BREG[i];
+    BACKUP->BREG[0] = 0u;
+    return snapshot_decode(words, snap);
+}
+
+/******************************************************************************
+* Function Name: hibernateEnter
+*******************************************************************************
+*
+* Summary:
+*  This function saves a snapshot to the backup registers and hibernates for
+*  @seconds. It only returns if the snapshot could not be packed, without
+*  hibernating, or if hibernate was refused.
+*
+* Parameters:
+*  snap: snapshot to carry on from
+*  seconds: time to hibernate, 1 to SECONDS_PER_DAY - 1
+*
+* Return:
+*  -1, the collar did not hibernate
+*
+******************************************************************************/
+int hibernateEnter(const struct snapshot *snap, uint32_t seconds)
+{
+    uint32_t words[SNAPSHOT_WORDS];
+    int i;
+
+    /* Waking up without a snapshot would start over, stay awake instead */
+    if (snapshot_encode(snap, words) != 0)
+        return -1;
+    for (i = 0; i < SNAPSHOT_WORDS; i++)
+        BACKUP->BREG[i] = words[i];
+
+    RtcAlarmIn(seconds);
+    Cy_SysPm_SetHibWakeupSource(CY_SYSPM_HIBALARM);
+    Cy_SysPm_Hibernate();
+
+    /* Still here, carry on awake */
+    Cy_SysPm_ClearHibWakeupSource(CY_SYSPM_HIBALARM);
+    Cy_RTC_SetInterruptMask(0u);
+    BACKUP->BREG[0] = 0u;
+    return -1;
+}
+
+#endif /* HIBERNATE_H */
@@ -0,0 +1,99 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "History.h"
+
+int history_init(history_t h, struct history_record *buf, int capacity,
+                 uint32_t first_seq)
+{
+    if (!h || !buf || capacity <= 0)
+    {
+        return -1;
+    }
+
+    h->buf = buf;
+    h->capacity = capacity;
+    h->head = 0;
+    h->size = 0;
+    h->next_seq = first_seq;
+    return 0;
+}
+
+int history_add(history_t h, const struct history_record *rec)
+{
+    int pos;
+
+    if (!h || !rec)
+    {
+        return -1;
+    }
+
+    pos = h->head + h->size;
+    if (pos >= h->capacity)
+    {
+        pos -= h->capacity;
+    }
+    if (h->size == h->capacity)
+    {
+        /* Full, the new record takes the place of the oldest */
+        h->head = h->head + 1 == h->capacity ? 0 : h->head + 1;
+    }
+    else
+    {
+        h->size++;
+    }
+
+    h->buf[pos] = *rec;
+    h->buf[pos].seq = h->next_seq++;
+    return 0;
+}
+
+int history_read(history_t h, uint32_t since, struct history_record *out,
+                 int max)
+{
+    uint32_t oldest, skip;
+    int pos, i, n;
+
+    if (!h || !out || max < 0)
+    {
+        return -1;
+    }
+
+    /* Distances from the newest record, so that wrapping sequence numbers
+       still compare */
+    oldest = h->next_seq - (uint32_t)h->size;
+    skip = since - oldest;
+    if (skip > (uint32_t)h->size)
+    {
+        /* Either evicted or not added yet */
+        skip = h->next_seq - since <= (uint32_t)INT32_MAX ? 0 :
+               (uint32_t)h->size;
+    }
+
+    n = h->size - (int)skip;
+    if (n > max)
+    {
+        n = max;
+    }
+    pos = h->head + (int)skip;
+    for (i = 0; i < n; i++, pos++)
+    {
+        if (pos >= h->capacity)
+        {
+            pos -= h->capacity;
+        }
+        out[i] = h->buf[pos];
+    }
+    return n;
+}
+
+uint32_t history_next_seq(history_t h)
+{
+    return h ? h->next_seq : 0;
+}
+
+int history_length(history_t h)
+{
+    return h ? h->size : -1;
+}
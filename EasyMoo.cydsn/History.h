@@ -0,0 +1,114 @@
+#ifndef _HISTORY_H
+#define _HISTORY_H
+
+#include <stdint.h>
+
+/*
+ * history_t - Sequence numbered record history
+ *
+ * A history keeps the last N summary records, one per reporting interval,
+ * so that what was measured while no gateway was in range can be
+ * downloaded later. Every record gets the next sequence number when it is
+ * added; numbers never repeat (until they wrap at 2^32), so a client that
+ * remembers the last number it received can ask for everything after it.
+ *
+ * Once full, adding a record evicts the oldest one. Asking for records that
+ * were evicted returns the oldest ones left, the gap showing in their
+ * sequence numbers.
+ *
+ * All storage is supplied by the caller, eg for 512 records:
+ *
+ *	static struct history_record buf[512];
+ *	static struct history h;
+ *	history_init(&h, buf, 512, 0);
+ */
+typedef struct history* history_t;
+
+/*
+ * history_record - Summary of one reporting interval
+ * @seq: Sequence number, set by history_add()
+ * @time: Timestamp, RTC seconds
+ * @light: Light, sum of the channels at the default exposure
+ * @temperature: Temperature, in centi-degrees
+ * @odba: Mean ODBA, in mg
+ * @happy_score: Happy score
+ * @flags: FRAME_FLAG_* bits
+ * @behaviour: enum behaviour, -1 if unknown
+ * @posture: enum posture
+ */
+struct history_record
+{
+    uint32_t seq;
+    uint32_t time;
+    uint16_t light;
+    int16_t temperature;
+    uint16_t odba;
+    uint8_t happy_score;
+    uint8_t flags;
+    int8_t behaviour;
+    int8_t posture;
+};
+
+struct history
+{
+    struct history_record *buf;
+    int capacity;
+    int head;
+    int size;
+    uint32_t next_seq;
+};
+
+/*
+ * history_init - Initialize an empty history
+ * @h: History to initialize
+ * @buf: Storage for @capacity records
+ * @capacity: Number of records kept
+ * @first_seq: Sequence number of the first record added
+ *
+ * Return: -1 if @h or @buf are NULL or if @capacity is not positive. 0 if
+ * @h was successfully initialized.
+ */
+int history_init(history_t h, struct history_record *buf, int capacity,
+                 uint32_t first_seq);
+
+/*
+ * history_add - Add a record, evicting the oldest one once full
+ * @h: History to add to
+ * @rec: Record, its sequence number is ignored
+ *
+ * Return: -1 if @h or @rec are NULL. 0 otherwise.
+ */
+int history_add(history_t h, const struct history_record *rec);
+
+/*
+ * history_read - Copy records from a sequence number on
+ * @h: History to read
+ * @since: Sequence number of the first record wanted
+ * @out: Receives the records, oldest first
+ * @max: Room in @out
+ *
+ * Records older than the oldest one kept start at the oldest one kept.
+ *
+ * Return: -1 if @h or @out are NULL or if @max is negative. Number of
+ * records copied otherwise, 0 once @since is past the newest record.
+ */
+int history_read(history_t h, uint32_t since, struct history_record *out,
+                 int max);
+
+/*
+ * history_next_seq - Sequence number the next record will get
+ * @h: History to look into
+ *
+ * Return: 0 if @h is NULL. The next sequence number otherwise.
+ */
+uint32_t history_next_seq(history_t h);
+
+/*
+ * history_length - History length
+ * @h: History to get the length of
+ *
+ * Return: -1 if @h is NULL. Number of records kept otherwise.
+ */
+int history_length(history_t h);
+
+#endif /* _HISTORY_H */
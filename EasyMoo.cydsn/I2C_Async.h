@@ -0,0 +1,331 @@
+/******************************************************************************
+* File Name: I2C_Async.h
+*
+* Version: Beta
+*
+* Description: This file contains the interrupt driven I2C transfer engine
+* shared by the light sensor and accelerometer drivers. Transfers are queued
+* as jobs and run by the SCB high-level master API in the background, so the
+* CPU can sleep while bytes are on the bus instead of polling byte by byte.
+* The SCB is reached through the bus shim of I2C_Bus.h only.
+*
+* Related Document: PSoC 6 PDL API Reference, SCB I2C Master
+* Hardware Dependency:  CY8CKIT-063-BLE PSoC 6 BLE Pioneer kit
+*
+* Author(s):
+*	Yousef H. Akbar & and Cow Team
+*	Dept. Electrical and Computer Engineering
+*	University of California, Davis
+*******************************************************************************
+* A job is a register access on one slave:
+*  - write:	START, addr+W, reg, tx bytes..., STOP
+*  - read:	START, addr+W, reg, RESTART, addr+R, rx bytes..., STOP
+* The register write of a read is sent pending, which makes the following
+* i2cBusRead() issue a repeated start.
+*
+* Jobs are owned by the caller and queued by address in an spsc ring. The main
+* loop produces, the I2C interrupt consumes. Starting a job from the main loop
+* is done with interrupts masked, so only one context ever consumes at a time.
+* Failed jobs are retried up to I2C_MAX_RETRIES times before completing with
+* an error. A retry is not started from where the failure was seen: the job
+* is left at the head of the queue and i2cAsyncWait() restarts it after
+* I2C_RETRY_DELAY_US, giving a busy bus or slave time to recover. Completion
+* callbacks run in the ISR and must not submit new jobs, since the main loop
+* is the only producer.
+******************************************************************************/
+
+#ifndef I2C_ASYNC_H
+#define I2C_ASYNC_H
+
+#include "project.h"
+#include "string.h"
+#include "Spsc.h"
+
+#define I2C_QUEUE_LEN       (8u)    /* Pending jobs, power of two */
+#define I2C_TX_MAX          (8u)    /* Data bytes written after the register */
+#define I2C_MAX_RETRIES     (2u)
+#define I2C_RETRY_DELAY_US  (500u)  /* Backoff before a failed job is retried */
+
+/* Bus events, reported by the shim to i2cAsyncEvent() */
+#define I2C_BUS_WR_DONE     (0x1u)
+#define I2C_BUS_RD_DONE     (0x2u)
+#define I2C_BUS_ERROR       (0x4u)
+
+typedef void (*i2c_bus_event_t)(uint32_t event);
+
+/* Bus shim, the SCB in I2C_Bus.h. With I2C_BUS_FAKE defined, as in the host
+   tests, the includer defines these for a bus of its own */
+static void i2cBusInit(i2c_bus_event_t handler);
+static uint32_t i2cBusWrite(uint8_t addr, uint8_t *buf, uint32_t len,
+		int pending);
+static uint32_t i2cBusRead(uint8_t addr, uint8_t *buf, uint32_t len);
+static uint32_t i2cBusError(void);
+
+#ifndef I2C_BUS_FAKE
+#include "I2C_Bus.h"
+#endif
+
+/* Job status */
+#define I2C_JOB_DONE        (0)
+#define I2C_JOB_PENDING     (1)
+#define I2C_JOB_FAILED      (-1)
+
+struct i2c_job;
+typedef void (*i2c_done_t)(struct i2c_job *job);
+
+struct i2c_job {
+	uint8_t addr;                   /* 7 bit slave address */
+	uint8_t wbuf[1 + I2C_TX_MAX];   /* Register, then data to write */
+	uint32_t wlen;
+	uint8_t *rx;                    /* Read buffer, NULL for a write job */
+	uint32_t rxLen;
+	i2c_done_t done;                /* Optional, called from the ISR */
+	void *arg;
+	uint32_t retries;
+	volatile int status;
+	uint32_t error;                 /* i2cBusError() of the last error */
+};
+
+/* Error/retry accounting */
+struct i2c_stats {
+	uint32_t jobs;
+	uint32_t errors;
+	uint32_t retries;
+	uint32_t failures;
+};
+
+static struct spsc i2cQueue;
+static struct i2c_job *i2cQueueBuf[I2C_QUEUE_LEN];
+static volatile int i2cBusy = 0;
+static volatile int i2cRetry = 0;   /* Head job waits out the retry backoff */
+struct i2c_stats i2cStats;
+
+void i2cAsyncStartNext(void);
+
+/* Function Name: i2cAsyncComplete
+ *
+ * Summary:
+ * This function retires the job at the head of the queue, notifies its owner
+ * and starts the next one. Called with the engine owned by the caller (from
+ * the ISR, or with interrupts masked).
+ */
+static void i2cAsyncComplete(struct i2c_job *job, int status)
+{
+	spsc_pop(&i2cQueue, NULL);
+	if (status != I2C_JOB_DONE)
+		i2cStats.failures++;
+	job->status = status;
+	if (job->done)
+		job->done(job);
+	i2cAsyncStartNext();
+}
+
+/* Function Name: i2cAsyncFail
+ *
+ * Summary:
+ * This function accounts for an error on @job, the head of the queue. The
+ * job is left there for i2cAsyncWait() to retry after the backoff, or fails
+ * once out of retries.
+ */
+static void i2cAsyncFail(struct i2c_job *job, uint32_t error)
+{
+	i2cStats.errors++;
+	job->error = error;
+	if (job->retries++ < I2C_MAX_RETRIES) {
+		i2cStats.retries++;
+		i2cRetry = 1;
+	} else {
+		i2cAsyncComplete(job, I2C_JOB_FAILED);
+	}
+}
+
+/* Function Name: i2cAsyncStartJob
+ *
+ * Summary:
+ * This function kicks off the first phase of @job: the register write (left
+ * pending for a read). If the bus refuses the transfer, the job is failed
+ * (see i2cAsyncFail()).
+ */
+static void i2cAsyncStartJob(struct i2c_job *job)
+{
+	uint32_t ret;
+
+	ret = i2cBusWrite(job->addr, job->wbuf, job->wlen, job->rxLen > 0u);
+	if (ret != 0u)
+		i2cAsyncFail(job, ret);
+}
+
+/* Function Name: i2cAsyncStartNext
+ *
+ * Summary:
+ * This function starts the job at the head of the queue, or marks the engine
+ * idle if there is none.
+ */
+void i2cAsyncStartNext(void)
+{
+	struct i2c_job *job;
+
+	if (spsc_peek(&i2cQueue, &job) != 0) {
+		i2cBusy = 0;
+		return;
+	}
+	i2cBusy = 1;
+	i2cAsyncStartJob(job);
+}
+
+/* Function Name: i2cAsyncEvent
+ *
+ * Summary:
+ * Bus event handler, called from the I2C interrupt. It moves the current job
+ * to its next phase, fails it on error, or completes it.
+ *
+ * Parameters:
+ *	@event:	I2C_BUS_* bits.
+ */
+void i2cAsyncEvent(uint32_t event)
+{
+	struct i2c_job *job;
+
+	if (spsc_peek(&i2cQueue, &job) != 0)
+		return;
+
+	if (event & I2C_BUS_ERROR) {
+		i2cAsyncFail(job, i2cBusError());
+		return;
+	}
+
+	if ((event & I2C_BUS_WR_DONE) && job->rxLen > 0u) {
+		/* Register pointer is set, read back with a repeated start */
+		if (i2cBusRead(job->addr, job->rx, job->rxLen) != 0u)
+			i2cAsyncEvent(I2C_BUS_ERROR);
+		return;
+	}
+
+	if (event & (I2C_BUS_WR_DONE | I2C_BUS_RD_DONE))
+		i2cAsyncComplete(job, I2C_JOB_DONE);
+}
+
+/* Function Name: i2cAsyncInit
+ *
+ * Summary:
+ * This function sets up the job queue and hooks the engine to the I2C
+ * component's interrupt. It must be called after I2C_Start().
+ */
+void i2cAsyncInit(void)
+{
+	spsc_init(&i2cQueue, i2cQueueBuf, sizeof(struct i2c_job *), I2C_QUEUE_LEN);
+	i2cBusInit(i2cAsyncEvent);
+}
+
+/* Function Name: i2cAsyncSubmit
+ *
+ * Summary:
+ * This function queues @job and starts it if the bus is idle. The job, and
+ * its buffers, must stay valid until its status leaves I2C_JOB_PENDING.
+ *
+ * Parameters:
+ *	@job:	job to queue.
+ *
+ * Return:
+ *	0 if @job was queued, -1 if the queue is full.
+ */
+int i2cAsyncSubmit(struct i2c_job *job)
+{
+	uint32_t intr;
+
+	job->status  = I2C_JOB_PENDING;
+	job->retries = 0;
+	job->error   = 0;
+	if (spsc_push(&i2cQueue, &job) != 0)
+		return -1;
+	i2cStats.jobs++;
+
+	intr = Cy_SysLib_EnterCriticalSection();
+	if (!i2cBusy)
+		i2cAsyncStartNext();
+	Cy_SysLib_ExitCriticalSection(intr);
+	return 0;
+}
+
+/* Function Name: i2cAsyncWait
+ *
+ * Summary:
+ * This function sleeps until @job completes. The CPU is woken up by the I2C
+ * interrupt, so no cycles are spent polling the bus. A failed job at the head
+ * of the queue, @job or one ahead of it, is retried from here after
+ * I2C_RETRY_DELAY_US.
+ *
+ * Return:
+ *	I2C_JOB_DONE or I2C_JOB_FAILED.
+ */
+int i2cAsyncWait(struct i2c_job *job)
+{
+	for (;;) {
+		/* Masked, so a completion between the check and WFI still wakes us */
+		uint32_t intr = Cy_SysLib_EnterCriticalSection();
+		if (job->status != I2C_JOB_PENDING) {
+			Cy_SysLib_ExitCriticalSection(intr);
+			return job->status;
+		}
+		if (i2cRetry) {
+			Cy_SysLib_ExitCriticalSection(intr);
+			Cy_SysLib_DelayUs(I2C_RETRY_DELAY_US);
+			intr = Cy_SysLib_EnterCriticalSection();
+			i2cRetry = 0;
+			i2cAsyncStartNext();
+			Cy_SysLib_ExitCriticalSection(intr);
+			continue;
+		}
+		Cy_SysPm_CpuEnterSleep(CY_SYSPM_WAIT_FOR_INTERRUPT);
+		Cy_SysLib_ExitCriticalSection(intr);
+	}
+}
+
+/* Function Name: i2cReadRegs
+ *
+ * Summary:
+ * This function reads @len bytes from slave @addr starting at register @reg
+ * and sleeps until they have arrived.
+ *
+ * Return:
+ *	I2C_JOB_DONE or I2C_JOB_FAILED.
+ */
+int i2cReadRegs(uint8_t addr, uint8_t reg, uint8_t *buf, uint32_t len)
+{
+	struct i2c_job job = {0};
+
+	job.addr    = addr;
+	job.wbuf[0] = reg;
+	job.wlen    = 1u;
+	job.rx      = buf;
+	job.rxLen   = len;
+	if (i2cAsyncSubmit(&job) != 0)
+		return I2C_JOB_FAILED;
+	return i2cAsyncWait(&job);
+}
+
+/* Function Name: i2cWriteRegs
+ *
+ * Summary:
+ * This function writes @len bytes (at most I2C_TX_MAX) to slave @addr starting
+ * at register @reg and sleeps until the write is done.
+ *
+ * Return:
+ *	I2C_JOB_DONE or I2C_JOB_FAILED.
+ */
+int i2cWriteRegs(uint8_t addr, uint8_t reg, const uint8_t *buf, uint32_t len)
+{
+	struct i2c_job job = {0};
+
+	if (len > I2C_TX_MAX)
+		return I2C_JOB_FAILED;
+	job.addr    = addr;
+	job.wbuf[0] = reg;
+	memcpy(&job.wbuf[1], buf, len);
+	job.wlen    = 1u + len;
+	if (i2cAsyncSubmit(&job) != 0)
+		return I2C_JOB_FAILED;
+	return i2cAsyncWait(&job);
+}
+
+#endif /* I2C_ASYNC_H */
@@ -0,0 +1,113 @@
+/******************************************************************************
+* File Name: I2C_Bus.h
+*
+* Version: Beta
+*
+* Description: This file contains the bus shim of the I2C transfer engine
+* (I2C_Async.h): the only place the engine reaches the SCB high-level master
+* API. The engine sees transfers and I2C_BUS_* events, not SCB calls, so it
+* also runs on the fake bus of the host tests.
+*
+* Related Document: PSoC 6 PDL API Reference, SCB I2C Master
+* Hardware Dependency:  CY8CKIT-063-BLE PSoC 6 BLE Pioneer kit
+*
+* Author(s):
+*	Yousef H. Akbar & and Cow Team
+*	Dept. Electrical and Computer Engineering
+*	University of California, Davis
+******************************************************************************/
+
+#ifndef I2C_BUS_H
+#define I2C_BUS_H
+
+#include "project.h"
+
+static cy_stc_scb_i2c_master_xfer_config_t i2cXfer;
+static i2c_bus_event_t i2cBusHandler;
+
+/* Function Name: i2cBusEvent
+ *
+ * Summary:
+ * SCB I2C event callback, called from the I2C interrupt. It hands the events
+ * of a master transfer to the engine as I2C_BUS_* bits.
+ */
+static void i2cBusEvent(uint32_t event)
+{
+	uint32_t bus = 0u;
+
+	if (event & CY_SCB_I2C_MASTER_ERR_EVENT)
+		bus |= I2C_BUS_ERROR;
+	if (event & CY_SCB_I2C_MASTER_WR_CMPLT_EVENT)
+		bus |= I2C_BUS_WR_DONE;
+	if (event & CY_SCB_I2C_MASTER_RD_CMPLT_EVENT)
+		bus |= I2C_BUS_RD_DONE;
+	if (bus != 0u)
+		i2cBusHandler(bus);
+}
+
+/* Function Name: i2cBusInit
+ *
+ * Summary:
+ * This function hooks @handler to the I2C component's interrupt. It must be
+ * called after I2C_Start().
+ */
+static void i2cBusInit(i2c_bus_event_t handler)
+{
+	i2cBusHandler = handler;
+	Cy_SCB_I2C_RegisterEventCallback(I2C_HW, i2cBusEvent, &I2C_context);
+}
+
+/* Function Name: i2cBusWrite
+ *
+ * Summary:
+ * This function starts writing @len bytes of @buf to slave @addr. With
+ * @pending set, no STOP follows and the next i2cBusRead() issues a repeated
+ * start. I2C_BUS_WR_DONE or I2C_BUS_ERROR reports the end of the transfer.
+ *
+ * Return:
+ *	0 if the transfer started, the SCB status otherwise.
+ */
+static uint32_t i2cBusWrite(uint8_t addr, uint8_t *buf, uint32_t len,
+		int pending)
+{
+	i2cXfer.slaveAddress = addr;
+	i2cXfer.buffer       = buf;
+	i2cXfer.bufferSize   = len;
+	i2cXfer.xferPending  = pending != 0;
+	return Cy_SCB_I2C_MasterWrite(I2C_HW, &i2cXfer, &I2C_context);
+}
+
+/* Function Name: i2cBusRead
+ *
+ * Summary:
+ * This function starts reading @len bytes from slave @addr into @buf, ended
+ * with a STOP. I2C_BUS_RD_DONE or I2C_BUS_ERROR reports the end of the
+ * transfer.
+ *
+ * Return:
+ *	0 if the transfer started, the SCB status otherwise.
+ */
+static uint32_t i2cBusRead(uint8_t addr, uint8_t *buf, uint32_t len)
+{
+	i2cXfer.slaveAddress = addr;
+	i2cXfer.buffer       = buf;
+	i2cXfer.bufferSize   = len;
+	i2cXfer.xferPending  = false;
+	return Cy_SCB_I2C_MasterRead(I2C_HW, &i2cXfer, &I2C_context);
+}
+
+/* Function Name: i2cBusError
+ *
+ * Summary:
+ * This function tells what went wrong with the last transfer, after an
+ * I2C_BUS_ERROR.
+ *
+ * Return:
+ *	The master status bits of the SCB.
+ */
+static uint32_t i2cBusError(void)
+{
+	return Cy_SCB_I2C_MasterGetStatus(I2C_HW, &I2C_context);
+}
+
+#endif /* I2C_BUS_H */
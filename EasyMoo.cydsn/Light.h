@@ -1,242 +1,423 @@
-/******************************************************************************
-* File Name: Light.h
-*
-* Version: Beta
-*
-* Description: This file contains the firmware for setting up communication
-* between the PSoC and the AS73211 True Color Sensor using the I2C protocol.
-*
-* Related Document: TrueColor_LightSensor.pdf
-* Hardware Dependency:  CY8CKIT-063-BLE PSoC 6 BLE Pioneer kit
-*                       AS73211 True Color Sensor
-*
-* Author(s):
-*	Yousef H. Akbar & and Cow Team
-*	Dept. Electrical and Computer Engineering
-*	University of California, Davis
-*******************************************************************************
-* Refer to Section 7.18 of TrueColor_LightSensor.pdf for I2C R/W Protocols.
-*
-* General I2C Procedure (7.21):
-*  - After supplying power: device in CONF state, but Powered Down.
-*  	- This is where we set control registers for options.
-*  	- Check by reading those same control registers.
-*  - Switch to MEAS state while specifying what mode you want.
-*
-* Figure 42 and 43 for example reading/writing.
-* Section 8 contains register bank information.
-******************************************************************************/
-
-#include "project.h"
-#include "stdio.h"
-#include "Queue.h"
-
-/* Slave addresses */
-#define LIGHT_ADDRESS 0x74    // 1110100[0|1]
-
-/* Control Register Bank */
-#define OSR     0x00        // Operational State Register (default 0x42)
-#define CREG1   0x06        // Config Register 1
-#define CREG2   0x07        // Config Register 2
-#define CREG3   0x08        // Config Register 3
-#define TBREAK  0x09        // Break time between measurements
-
-/* Output Register Bank */
-#define TEMP    0x01        // Temperature (0h + 12 bit temp result)
-#define MRES1   0x02        // Measurement X-Channel RED
-#define MRES2   0x03        // Y-Channel GREEN
-#define MRES3   0x04        // Z-Channel BLUE
-
-/* Macro for converting 16 bit temp. to celcius (Refer to Section 7.16) */
-uint16_t temperature;       // declaration of existing temp in main_cm0p.c
-#define CHIPTEMP temperature * 0.05 - 66.9
-#define LIGHT_CUTOFF    (50)
-
-#define CRIT_TEMP       (20)
-#define CRIT_LIGHT      (10)
-
-/* Global Variables */
-int tempFlag, lightFlag;
-
-/* Function Name: lightI2CRead
- *
- * Summary:
- * This function reads 2 bytes of data from the light sensor register
- * @reg using the I2C protocol and returns the result. The general
- * procedure for read sequences is detailed in 7.19 and Figure 40.
- * For any register, the low byte is read first followed by the high
- * byte.
- *
- * Parameters:
- *	@reg:		The register from which you want to read data.
- *
- * Return:
- *	readBuf:	Two byte buffer with register data.
- */
-uint16_t lightI2CRead(uint8_t reg)
-{
-    volatile cy_en_scb_i2c_status_t ret0 = 0;
-    volatile cy_en_scb_i2c_status_t ret1 = 0;
-    volatile cy_en_scb_i2c_status_t ret2 = 0;
-    volatile cy_en_scb_i2c_status_t ret3 = 0;
-    volatile cy_en_scb_i2c_status_t ret4 = 0;
-    volatile cy_en_scb_i2c_status_t ret5 = 0;
-    uint8_t readBuf[2] = {0, 0};
-    
-    // Start condition and broadcast slave address + WRITE bit (0)
-    ret0 = I2C_MasterSendStart(LIGHT_ADDRESS, CY_SCB_I2C_WRITE_XFER, 100);
-    CyDelay(1);
-    // Broadcast register requested from slave LIGHT_ADDRESS
-    ret1 = I2C_MasterWriteByte(reg, 100);
-    CyDelay(1);
-    // Start repeat condition, broadcast slave address + READ bit (1)
-    ret2 = I2C_MasterSendReStart(LIGHT_ADDRESS, CY_SCB_I2C_READ_XFER, 100);
-    CyDelay(1);
-    // Read from I2C device, put received byte in readBuf and send ack signal.
-    ret3 = I2C_MasterReadByte(CY_SCB_I2C_ACK, &(readBuf[0]), 100);
-    CyDelay(1);
-    ret5 = I2C_MasterReadByte(CY_SCB_I2C_NAK, &(readBuf[1]), 100);
-    CyDelay(1);
-    // End I2C transaction
-    ret4 = I2C_MasterSendStop(100);
-    
-    printf("SendStart: %X,"
-		    "WriteByte: %X,"
-		    "SendReStart: %X,"
-		    "ReadByte: %X,"
-		    "ReadByte2: %X"
-		    "SendStop: %X\r\n", ret0, ret1, ret2, ret3, ret5, ret4);
-    
-    //Start_Number = (Start_Number_High << 8) | (Start_Number_Low & 0xff);
-    return (readBuf[1] << 8) | (readBuf[0] & 0xff);
-}
-
-/* Function Name: lightI2CWrite
- *
- * Summary:
- * This function writes to the light sensor using the I2C protocol. The general
- * procedure for write sequences is detailed in 7.18 and Figure 40.
- *
- * Parameters:
- *	@reg:	The register to which you want to write data.
- *	@val:	The value you would like to write to @reg
- *
- * Return:
- * 	None.
- */
-void lightI2CWrite(uint8_t reg, uint8_t value)
-{
-    volatile cy_en_scb_i2c_status_t ret0 = 0;
-    volatile cy_en_scb_i2c_status_t ret1 = 0;
-    volatile cy_en_scb_i2c_status_t ret2 = 0;
-    volatile cy_en_scb_i2c_status_t ret3 = 0;
-    
-    // Start I2C transaction
-    ret0 = I2C_MasterSendStart(LIGHT_ADDRESS, CY_SCB_I2C_WRITE_XFER, 100);
-    CyDelay(1);
-    //Write to I2C device
-    ret1 = I2C_MasterWriteByte(reg, 100);
-    ret2 = I2C_MasterWriteByte(value, 100);
-    CyDelay(1);
-    // End I2C transaction
-    ret3 = I2C_MasterSendStop(100);
-    
-    printf("SendStart: %X, WriteByte: %X,%X, SendStop: %X\r\n", ret0, ret1,
-		    ret2, ret3);
-}
-
-/* Function Name: lightMeasure
- *
- * Summary:
- * This function performs a single measurement cycle for the light sensor by
- * transitioning the device state from power down to measurement, then after the
- * measurement is complete (64ms later), we save the results.  Lastly, we
- * transition back to the power down state for power reduction.
- *
- * Parameters:
- *	@xChannel, yChannel, zChannel:	The 3 RGB channels from photodiodes.
- *	@temperature:			On-board temperature sensor result.
- *
- * Return:
- *	None.
- */
-void lightMeasure(uint16_t *xChannel, uint16_t *yChannel, uint16_t *zChannel,
-		uint16_t *temperature)
-{
-	/* Transition to Measurement mode 0x83 */
-	lightI2CWrite(OSR, 0x83);
-	/* Wait for conversion to finish, defined by TCONV */
-	CyDelay(64);
-
-	/* Read completed conversions */
-	*temperature    = lightI2CRead(TEMP);
-	*xChannel       = lightI2CRead(MRES1);
-	*yChannel       = lightI2CRead(MRES2);
-	*zChannel       = lightI2CRead(MRES3);
-
-	/* Transition back to PowerDown, for power reduction */
-	lightI2CWrite(OSR, 0x42);
-}
-
-/* Function Name: lightPrint
- *
- * Summary:
- * This function prints the most recent data from the light sensor: the 3
- * channels of photodiodes conversions (RGB light) and the chip temperature.
- * Note that temperature is obtained using a macro function that converts the
- * TEMP register from the board to an actual celcius temperature.
- *
- * Parameters:
- *	@x: the xChannel (R) 16 bit result
- *	@y: the yChannel (G) 16 bit result
- *	@z: the zChannel (B) 16 bit result
- *
- * Return:
- *	None.
- */
-void lightPrint(uint16_t x, uint16_t y, uint16_t z)
-{
-	printf("\r\n\r\nLight Sensor Data:\r\n"
-			"Red Light: %d\r\n"
-			"Green Light: %d\r\n"
-			"Blue Light: %d\r\n"
-			"Temperature: %.2f\r\n", x, y, z, CHIPTEMP);
-}
-
-/* Function Name: light_process_data
- *
- * Summary:
- * This function performs the data clustering on the readings from the light
- * sensor. This includes setting intermediate and critical flags based on the
- * most recent readings. Namely, the three variables of interest are dark_count,
- * lightFlag, and tempFlag. The first two check if the cow has not seen light in
- * too long, and the last flag checks if the temperature is too high.
- *
- * Parameters:
- *	@x:	the xChannel (R) 16 bit result
- *	@y:	the yChannel (G) 16 bit result
- *	@z:	the zChannel (B) 16 bit result
- *	@tq:	queue data structure for temperature results.
- *	@lq:	queue data structure for light results.
- *
- * Return:
- *	None.
- */
-void light_process_data(uint16_t x, uint16_t y, uint16_t z, queue_t tq, queue_t lq)
-{
-	int dark_count = 0;
-	int chip_temp = CHIPTEMP;
-	int combined_light = x + y + z;
-	if (combined_light < LIGHT_CUTOFF)
-		dark_count++;
-	else
-		dark_count = 0;
-
-	if (queue_enqueue(lq, combined_light) != 0)
-		printf("Failed to queue light data.\r\n");
-	if (queue_enqueue(tq, chip_temp) != 0)
-		printf("Failed to queue temperature data.\r\n");
-
-	lightFlag   = dark_count >= CRIT_LIGHT;    
-	tempFlag    = CHIPTEMP >= CRIT_TEMP;
-}
+/******************************************************************************
+* File Name: Light.h
+*
+* Version: Beta
+*
+* Description: This file contains the firmware for setting up communication
+* between the PSoC and the AS73211 True Color Sensor using the I2C protocol.
+*
+* Related Document: TrueColor_LightSensor.pdf
+* Hardware Dependency:  CY8CKIT-063-BLE PSoC 6 BLE Pioneer kit
+*                       AS73211 True Color Sensor
+*
+* Author(s):
+*	Yousef H. Akbar & and Cow Team
+*	Dept. Electrical and Computer Engineering
+*	University of California, Davis
+*******************************************************************************
+* Refer to Section 7.18 of TrueColor_LightSensor.pdf for I2C R/W Protocols.
+*
+* General I2C Procedure (7.21):
+*  - After supplying power: device in CONF state, but Powered Down.
+*  	- This is where we set control registers for options.
+*  	- Check by reading those same control registers.
+*  - Switch to MEAS state while specifying what mode you want.
+*
+* Figure 42 and 43 for example reading/writing.
+* Section 8 contains register bank information.
+******************************************************************************/
+
+#include "project.h"
+#include "stdio.h"
+#include "I2C_Async.h"
+#include "LightRange.h"
+#include "Fixed.h"
+
+/* Slave addresses */
+#define LIGHT_ADDRESS 0x74    // 1110100[0|1]
+
+/* Control Register Bank */
+#define OSR     0x00        // Operational State Register (default 0x42)
+#define CREG1   0x06        // Config Register 1
+#define CREG2   0x07        // Config Register 2
+#define CREG3   0x08        // Config Register 3
+#define TBREAK  0x09        // Break time between measurements
+
+/* Output Register Bank */
+#define TEMP    0x01        // Temperature (0h + 12 bit temp result)
+#define MRES1   0x02        // Measurement X-Channel RED
+#define MRES2   0x03        // Y-Channel GREEN
+#define MRES3   0x04        // Z-Channel BLUE
+
+/* CREG3 fields (Section 8.2.4) */
+#define CREG3_MMODE_CONT    0x00    // Continuous, next conversion after TBREAK
+#define CREG3_MMODE_CMD     0x40    // Single conversion per start (default)
+#define CREG3_MMODE_SYNS    0x80    // Start synchronized on SYN pin
+#define CREG3_MMODE_SYND    0xC0    // Start/stop synchronized on SYN pin
+#define CREG3_SB            0x10    // Standby between conversions
+#define CREG3_RDYOD         0x08    // READY pin open drain (0: push-pull)
+#define CREG3_CCLK_1MHZ     0x00    // 1.024 MHz conversion clock
+
+/* Break between continuous conversions, in 8 us steps (max 2.04 ms) */
+#define LIGHT_TBREAK        0xFF
+#define LIGHT_TBREAK_US     (LIGHT_TBREAK * 8u)
+
+/* OSR states */
+#define OSR_CONFIG          0x02    // Configuration state, powered up
+#define OSR_PD_CONFIG       0x42    // Configuration state, powered down
+#define OSR_START_MEAS      0x83    // Measurement state, start conversions
+
+/* READY output, goes high when a conversion has finished */
+#define LIGHT_READY_PORT    GPIO_PRT9
+#define LIGHT_READY_PIN     (2u)
+#define LIGHT_READY_IRQ     ioss_interrupts_gpio_9_IRQn
+#define LIGHT_READY_MUX     NvicMux6_IRQn
+
+/* STATUS register bits (Section 8.2.6) */
+#define STATUS_OUTCONVOF    0x80    // Internal reference counter overflow
+#define STATUS_MRESOF       0x40    // Measurement result overflow
+#define STATUS_ADCOF        0x20    // ADC input overflow
+#define STATUS_LDATA        0x10    // Results overwritten before read
+#define STATUS_NDATA        0x08    // New results available
+#define STATUS_NOTREADY     0x04    // Conversion in progress
+
+/* Output bank burst: OSR, STATUS, TEMP, MRES1, MRES2, MRES3 (LSB first) */
+#define RESULT_BURST_LEN    (10u)
+
+/* One full read-out of the output register bank */
+struct light_result {
+	uint8_t osr;
+	uint8_t status;
+	uint16_t temperature;
+	uint16_t x, y, z;
+};
+
+/* Set by the READY interrupt, a fresh conversion is waiting to be read */
+volatile int lightReadyFlag = 0;
+
+/* Measurements, and those READY never came for */
+struct light_stats {
+	uint32_t samples;
+	uint32_t missed;
+};
+struct light_stats lightStats;
+
+/* Auto-ranging state, picks CREG1 for the next conversion */
+struct light_range lightRange;
+
+uint16_t temperature;       // declaration of existing temp in main_cm0p.c
+
+/* Function Name: lightI2CRead
+ *
+ * Summary:
+ * This function reads 2 bytes of data from the light sensor register
+ * @reg using the I2C protocol and returns the result. The general
+ * procedure for read sequences is detailed in 7.19 and Figure 40.
+ * For any register, the low byte is read first followed by the high
+ * byte. The transfer runs on the I2C engine and the CPU sleeps meanwhile.
+ *
+ * Parameters:
+ *	@reg:		The register from which you want to read data.
+ *
+ * Return:
+ *	readBuf:	Two byte buffer with register data.
+ */
+uint16_t lightI2CRead(uint8_t reg)
+{
+    uint8_t readBuf[2] = {0, 0};
+    
+    if (i2cReadRegs(LIGHT_ADDRESS, reg, readBuf, 2u) != I2C_JOB_DONE)
+        printf("Light read from %X failed\r\n", reg);
+    
+    return (readBuf[1] << 8) | (readBuf[0] & 0xff);
+}
+
+/* Function Name: lightI2CWrite
+ *
+ * Summary:
+ * This function writes to the light sensor using the I2C protocol. The general
+ * procedure for write sequences is detailed in 7.18 and Figure 40.
+ *
+ * Parameters:
+ *	@reg:	The register to which you want to write data.
+ *	@val:	The value you would like to write to @reg
+ *
+ * Return:
+ * 	None.
+ */
+void lightI2CWrite(uint8_t reg, uint8_t value)
+{
+    if (i2cWriteRegs(LIGHT_ADDRESS, reg, &value, 1u) != I2C_JOB_DONE)
+        printf("Light write to %X failed\r\n", reg);
+}
+
+/* Function Name: lightI2CReadBurst
+ *
+ * Summary:
+ * This function reads @len consecutive bytes from the light sensor starting
+ * at register @reg, in a single I2C transaction. The AS73211 increments its
+ * register pointer after each 16 bit register, so one start/restart/stop
+ * sequence covers the whole output register bank (Section 7.19, Figure 43).
+ *
+ * Parameters:
+ *	@reg:	first register to read.
+ *	@buf:	receives the data, low byte of each register first.
+ *	@len:	number of bytes to read, at least 1.
+ *
+ * Return:
+ *	I2C_JOB_DONE, or I2C_JOB_FAILED once the engine gave up retrying.
+ */
+int lightI2CReadBurst(uint8_t reg, uint8_t *buf, uint32_t len)
+{
+    int ret = i2cReadRegs(LIGHT_ADDRESS, reg, buf, len);
+    
+    if (ret != I2C_JOB_DONE)
+        printf("Light burst read from %X failed\r\n", reg);
+    
+    return ret;
+}
+
+/* Function Name: lightReadResults
+ *
+ * Summary:
+ * This function fetches the operational state, status, temperature and the
+ * three channel results with one burst read of the output register bank.
+ *
+ * Parameters:
+ *	@res:	receives the results.
+ *
+ * Return:
+ *	I2C_JOB_DONE, or I2C_JOB_FAILED if the read failed.
+ */
+int lightReadResults(struct light_result *res)
+{
+	uint8_t buf[RESULT_BURST_LEN];
+	int ret;
+
+	ret = lightI2CReadBurst(OSR, buf, RESULT_BURST_LEN);
+	if (ret != I2C_JOB_DONE)
+		return ret;
+
+	res->osr         = buf[0];
+	res->status      = buf[1];
+	res->temperature = (buf[3] << 8) | buf[2];
+	res->x           = (buf[5] << 8) | buf[4];
+	res->y           = (buf[7] << 8) | buf[6];
+	res->z           = (buf[9] << 8) | buf[8];
+	return ret;
+}
+
+/* Function Name: lightReadyInterruptHandler
+ *
+ * Summary:
+ * READY pin interrupt. It flags the new conversion and masks itself, so the
+ * sensor converting in the background never wakes up the CPU unless a
+ * measurement has been asked for with lightArm().
+ */
+void lightReadyInterruptHandler(void)
+{
+	Cy_GPIO_ClearInterrupt(LIGHT_READY_PORT, LIGHT_READY_PIN);
+	Cy_GPIO_SetInterruptMask(LIGHT_READY_PORT, LIGHT_READY_PIN, 0u);
+	lightReadyFlag = 1;
+}
+
+/* Function Name: lightSetExposure
+ *
+ * Summary:
+ * This function reprograms gain and conversion time (CREG1) for exposure @exp
+ * (see LightRange.h). CREG1 is only writable in the configuration state, so
+ * the sensor is stopped for the write and restarted in continuous mode.
+ *
+ * Parameters:
+ *	@exp:	exposure, 0 to LIGHT_EXP_MAX.
+ *
+ * Return:
+ *	None.
+ */
+void lightSetExposure(int exp)
+{
+	lightI2CWrite(OSR, OSR_CONFIG);
+	lightI2CWrite(CREG1, light_range_creg1(exp));
+	lightI2CWrite(OSR, OSR_START_MEAS);
+}
+
+/* Function Name: lightInit
+ *
+ * Summary:
+ * This function sets up the READY pin interrupt and puts the light sensor in
+ * continuous measurement mode (Section 7.4): once started, the sensor converts
+ * on its own, with a break of TBREAK between conversions, and raises READY
+ * after each one. The registers are only writable in the configuration state,
+ * so the sensor is powered up in it first. Must be called after i2cAsyncInit().
+ *
+ * Parameters:
+ *	None.
+ *
+ * Return:
+ *	None.
+ */
+void lightInit(void)
+{
+	const cy_stc_sysint_t readyIrq = {
+		.intrSrc      = LIGHT_READY_MUX,
+		.cm0pSrc      = LIGHT_READY_IRQ,
+		.intrPriority = 3u,
+	};
+
+	Cy_GPIO_Pin_FastInit(LIGHT_READY_PORT, LIGHT_READY_PIN, CY_GPIO_DM_HIGHZ,
+			0u, HSIOM_SEL_GPIO);
+	Cy_GPIO_SetInterruptEdge(LIGHT_READY_PORT, LIGHT_READY_PIN,
+			CY_GPIO_INTR_RISING);
+	Cy_GPIO_SetInterruptMask(LIGHT_READY_PORT, LIGHT_READY_PIN, 0u);
+	Cy_SysInt_Init(&readyIrq, lightReadyInterruptHandler);
+	NVIC_EnableIRQ(LIGHT_READY_MUX);
+
+	light_range_init(&lightRange, LIGHT_EXP_DEFAULT);
+
+	lightI2CWrite(OSR, OSR_CONFIG);
+	lightI2CWrite(CREG1, light_range_creg1(lightRange.exp));
+	lightI2CWrite(CREG3, CREG3_MMODE_CONT | CREG3_CCLK_1MHZ);
+	lightI2CWrite(TBREAK, LIGHT_TBREAK);
+	lightI2CWrite(OSR, OSR_START_MEAS);
+}
+
+/* Function Name: lightStop
+ *
+ * Summary:
+ * This function stops the conversions and powers the light sensor down, for
+ * when the MCU hibernates. lightInit() starts it again.
+ *
+ * Parameters:
+ *	None.
+ *
+ * Return:
+ *	None.
+ */
+void lightStop(void)
+{
+	Cy_GPIO_SetInterruptMask(LIGHT_READY_PORT, LIGHT_READY_PIN, 0u);
+	lightI2CWrite(OSR, OSR_PD_CONFIG);
+}
+
+/* Function Name: lightArm
+ *
+ * Summary:
+ * This function starts a measurement from the light sensor, which keeps
+ * converting in continuous mode (see lightInit()): it arms the READY
+ * interrupt, dropping any edge left over from an earlier conversion, so the
+ * next one to complete sets lightReadyFlag. The CPU is free until then;
+ * lightCollect() fetches the results, at READY or after lightReadyTimeout().
+ *
+ * Parameters:
+ *	None.
+ *
+ * Return:
+ *	None.
+ */
+void lightArm(void)
+{
+	lightReadyFlag = 0;
+	Cy_GPIO_ClearInterrupt(LIGHT_READY_PORT, LIGHT_READY_PIN);
+	Cy_GPIO_SetInterruptMask(LIGHT_READY_PORT, LIGHT_READY_PIN, 1u);
+}
+
+/* Function Name: lightReadyTimeout
+ *
+ * Summary:
+ * This function tells how long READY may take after lightArm(): twice the
+ * conversion cycle, TCONV of the current exposure plus TBREAK, the one in
+ * progress and the next, with a timer tick to spare. Past it, READY was
+ * missed.
+ *
+ * Return:
+ *	Timeout in ms.
+ */
+uint32_t lightReadyTimeout(void)
+{
+	uint32_t cycle = light_range_tconv_ms(lightRange.exp) * 1000u +
+			LIGHT_TBREAK_US;
+
+	return (2u * cycle + 999u) / 1000u + 1u;
+}
+
+/* Function Name: lightCollect
+ *
+ * Summary:
+ * This function ends the measurement lightArm() started. If READY came, the
+ * results are saved with a single burst read; if it did not, READY is masked
+ * again and the miss is counted in lightStats. Either way the outputs are
+ * only written with fresh results.
+ *
+ * The results then drive the auto-ranging (see LightRange.h): if they were
+ * too dim or too close to saturation, CREG1 is changed for the next
+ * conversion. @exposure reports the exposure the results were taken with,
+ * which light_range_normalize() needs to bring them to a common scale.
+ *
+ * Parameters:
+ *	@xChannel, yChannel, zChannel:	The 3 RGB channels from photodiodes.
+ *	@temperature:			On-board temperature sensor result.
+ *	@exposure:			Exposure of the channel results.
+ *
+ * Return:
+ *	0 with fresh results, -1 if READY was missed or the read failed.
+ */
+int lightCollect(uint16_t *xChannel, uint16_t *yChannel, uint16_t *zChannel,
+		uint16_t *temperature, uint8_t *exposure)
+{
+	uint16_t peak;
+	struct light_result res;
+
+	if (!lightReadyFlag) {
+		Cy_GPIO_SetInterruptMask(LIGHT_READY_PORT, LIGHT_READY_PIN, 0u);
+		lightStats.missed++;
+		printf("Light READY missed\r\n");
+		return -1;
+	}
+	lightReadyFlag = 0;
+
+	/* Read completed conversions, all in one transaction */
+	if (lightReadResults(&res) != I2C_JOB_DONE)
+		return -1;
+
+	*temperature    = res.temperature;
+	*xChannel       = res.x;
+	*yChannel       = res.y;
+	*zChannel       = res.z;
+	*exposure       = lightRange.exp;
+	lightStats.samples++;
+
+	peak = res.x > res.y ? res.x : res.y;
+	peak = peak > res.z ? peak : res.z;
+	if (light_range_update(&lightRange, peak, res.status) == 1)
+		lightSetExposure(lightRange.exp);
+	return 0;
+}
+
+/* Function Name: lightPrint
+ *
+ * Summary:
+ * This function prints the most recent data from the light sensor: the 3
+ * channels of photodiodes conversions (RGB light) and the chip temperature.
+ * Note that temperature is converted from the TEMP register to centi-degrees
+ * celcius with integer math (see Fixed.h), as the CM0+ has no FPU.
+ *
+ * Parameters:
+ *	@x: the xChannel (R) 16 bit result
+ *	@y: the yChannel (G) 16 bit result
+ *	@z: the zChannel (B) 16 bit result
+ *
+ * Return:
+ *	None.
+ */
+void lightPrint(uint16_t x, uint16_t y, uint16_t z)
+{
+	int32_t cdeg = fixed_temp_cdeg(temperature);
+	int32_t mag = cdeg < 0 ? -cdeg : cdeg;
+
+	printf("\r\n\r\nLight Sensor Data:\r\n"
+			"Red Light: %d\r\n"
+			"Green Light: %d\r\n"
+			"Blue Light: %d\r\n"
+			"Temperature: %s%d.%02d\r\n", x, y, z,
+			cdeg < 0 ? "-" : "", (int)(mag / 100), (int)(mag % 100));
+}
@@ -0,0 +1,104 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "LightRange.h"
+
+#define GAIN_STEPS      (11)    /* 1x to 2048x */
+#define MAX_STEP        (4)     /* Largest exposure jump on a dark sample */
+
+static int light_range_time(int exp)
+{
+    return exp > GAIN_STEPS ? exp - GAIN_STEPS : 0;
+}
+
+/* Counts only reach 16 bits for conversions of 64 ms and up */
+static uint32_t light_range_full_scale(int exp)
+{
+    int time = light_range_time(exp);
+
+    return time >= 6 ? 0xFFFFu : (1024u << time) - 1u;
+}
+
+int light_range_init(light_range_t range, int exp)
+{
+    if (!range || exp < 0 || exp > LIGHT_EXP_MAX)
+    {
+        return -1;
+    }
+
+    range->exp = exp;
+    return 0;
+}
+
+int light_range_update(light_range_t range, uint16_t peak, uint8_t status)
+{
+    uint32_t fs, p;
+    int exp;
+
+    if (!range)
+    {
+        return -1;
+    }
+
+    fs = light_range_full_scale(range->exp);
+    exp = range->exp;
+
+    if (status & LIGHT_RANGE_OVERFLOW)
+    {
+        /* The peak is clipped, so how far off it is is unknown */
+        exp -= MAX_STEP;
+    }
+    else if (peak > fs - fs / 4)
+    {
+        exp--;
+    }
+    else if (peak < fs / 8)
+    {
+        /* Jump straight to about 1/4 of full scale */
+        for (p = peak; p < fs / 4 && exp - range->exp < MAX_STEP; p <<= 1)
+        {
+            exp++;
+        }
+    }
+
+    if (exp < 0)
+    {
+        exp = 0;
+    }
+    if (exp > LIGHT_EXP_MAX)
+    {
+        exp = LIGHT_EXP_MAX;
+    }
+    if (exp == range->exp)
+    {
+        return 0;
+    }
+    range->exp = exp;
+    return 1;
+}
+
+uint8_t light_range_creg1(int exp)
+{
+    int time = light_range_time(exp);
+    int gain = GAIN_STEPS - (exp - time);
+
+    return (uint8_t)((gain << 4) | time);
+}
+
+uint32_t light_range_tconv_ms(int exp)
+{
+    return 1u << light_range_time(exp);
+}
+
+uint32_t light_range_normalize(int exp, uint16_t counts)
+{
+    int shift = LIGHT_EXP_DEFAULT + LIGHT_NORM_SHIFT - exp;
+
+    if (shift >= 0)
+    {
+        return (uint32_t)counts << shift;
+    }
+    shift = -shift;
+    return ((uint32_t)counts + (1u << (shift - 1))) >> shift;
+}
@@ -0,0 +1,96 @@
+#ifndef _LIGHTRANGE_H
+#define _LIGHTRANGE_H
+
+#include <stdint.h>
+
+/*
+ * light_range_t - Auto-ranging state for the AS73211 light sensor
+ *
+ * The sensitivity of the sensor is set by CREG1: a gain from 1x to 2048x and
+ * a conversion time from 1 ms up, both in powers of two. The pair is folded
+ * into a single exposure exponent @exp, counts being proportional to
+ * 2^@exp times the irradiance:
+ *
+ *	@exp  0..11	conversion time 1 ms, gain 1x..2048x
+ *	@exp 12..19	gain 2048x, conversion time 2 ms..256 ms
+ *
+ * Gain is raised first, so bright light is measured with the shortest
+ * conversions and the conversion time only grows once the gain is maxed out.
+ *
+ * After each sample, the brightest channel decides the next exposure: the
+ * exposure is lowered when the peak is above 3/4 of full scale or the sensor
+ * flagged an overflow, and raised when it is below 1/8 of full scale.
+ * Results are normalized to the default exposure (as sensitive as gain 2x,
+ * 64 ms), so thresholds keep the same meaning whatever the range. They carry
+ * LIGHT_NORM_SHIFT fractional bits, which keeps the extra resolution of the
+ * long dark conversions.
+ */
+typedef struct light_range* light_range_t;
+
+struct light_range
+{
+    int exp;
+};
+
+/*
+ * Default exposure, 2^7: the sensitivity of the sensor reset state (CREG1 =
+ * 0xA6, gain 2x, 64 ms). On the scale above it is gain 128x, 1 ms, so
+ * light_range_creg1() gives 0x40 for it, not the reset value.
+ */
+#define LIGHT_EXP_DEFAULT   (7)
+#define LIGHT_EXP_MAX       (19)
+
+/* Fractional bits of normalized results */
+#define LIGHT_NORM_SHIFT    (8)
+
+/* STATUS bits reporting a saturated conversion */
+#define LIGHT_RANGE_OVERFLOW    (0xE0)
+
+/*
+ * light_range_init - Initialize the ranging state
+ * @range: State to initialize
+ * @exp: Starting exposure, 0 to LIGHT_EXP_MAX
+ *
+ * Return: -1 if @range is NULL or if @exp is out of range. 0 if @range was
+ * successfully initialized.
+ */
+int light_range_init(light_range_t range, int exp);
+
+/*
+ * light_range_update - Pick the exposure for the next sample
+ * @range: Ranging state
+ * @peak: Largest of the three channel counts of the last sample
+ * @status: STATUS register of the last sample
+ *
+ * Return: -1 if @range is NULL. 1 if the exposure changed and CREG1 must be
+ * rewritten. 0 otherwise.
+ */
+int light_range_update(light_range_t range, uint16_t peak, uint8_t status);
+
+/*
+ * light_range_creg1 - CREG1 value for an exposure
+ * @exp: Exposure, 0 to LIGHT_EXP_MAX
+ *
+ * Return: GAIN in bits 7:4 and TIME in bits 3:0.
+ */
+uint8_t light_range_creg1(int exp);
+
+/*
+ * light_range_tconv_ms - Conversion time of an exposure
+ * @exp: Exposure, 0 to LIGHT_EXP_MAX
+ *
+ * Return: TCONV in ms, at the 1.024 MHz conversion clock.
+ */
+uint32_t light_range_tconv_ms(int exp);
+
+/*
+ * light_range_normalize - Scale counts to the default exposure
+ * @exp: Exposure the counts were measured with
+ * @counts: Raw channel counts
+ *
+ * Return: @counts as they would read at LIGHT_EXP_DEFAULT, in units of
+ * 2^-LIGHT_NORM_SHIFT counts, rounded when scaled down.
+ */
+uint32_t light_range_normalize(int exp, uint16_t counts);
+
+#endif /* _LIGHTRANGE_H */
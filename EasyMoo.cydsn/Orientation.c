@@ -0,0 +1,320 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "Orientation.h"
+
+#define ORIENT_PI               (3.14159265f)
+
+/* asin(k / 32) for k = 0 to 32, in centi-degrees */
+static const int16_t orient_asin[33] =
+{
+    0, 179, 358, 538, 718, 899, 1081, 1264,
+    1448, 1633, 1821, 2011, 2202, 2397, 2594, 2795,
+    3000, 3209, 3423, 3642, 3868, 4101, 4343, 4595,
+    4859, 5138, 5434, 5754, 6104, 6499, 6964, 7564,
+    9000,
+};
+
+int orientation_init(struct orientation *o, float dps_per_count, float rate)
+{
+    if (!o || dps_per_count <= 0.0f || rate <= 0.0f)
+    {
+        return -1;
+    }
+
+    memset(o, 0, sizeof(*o));
+    o->q[0] = 1.0f;
+    o->gyro_scale = dps_per_count * ORIENT_PI / 180.0f;
+    o->dt = 1.0f / rate;
+    return 0;
+}
+
+int orientation_update(struct orientation *o, const int16_t *gyro,
+                       const int16_t *acc)
+{
+    float q0, q1, q2, q3, gx, gy, gz, ax, ay, az, n;
+    float d0, d1, d2, d3, s0, s1, s2, s3;
+
+    if (!o || !gyro || !acc)
+    {
+        return -1;
+    }
+
+    q0 = o->q[0];
+    q1 = o->q[1];
+    q2 = o->q[2];
+    q3 = o->q[3];
+    gx = gyro[0] * o->gyro_scale;
+    gy = gyro[1] * o->gyro_scale;
+    gz = gyro[2] * o->gyro_scale;
+
+    /* Rate of change from the gyroscope, dq = q * (0, g) / 2 */
+    d0 = 0.5f * (-q1 * gx - q2 * gy - q3 * gz);
+    d1 = 0.5f * (q0 * gx + q2 * gz - q3 * gy);
+    d2 = 0.5f * (q0 * gy - q1 * gz + q3 * gx);
+    d3 = 0.5f * (q0 * gz + q1 * gy - q2 * gx);
+
+    ax = acc[0];
+    ay = acc[1];
+    az = acc[2];
+    n = ax * ax + ay * ay + az * az;
+    if (n > 0.0f)
+    {
+        n = 1.0f / sqrtf(n);
+        ax *= n;
+        ay *= n;
+        az *= n;
+
+        /* Gradient of the gap between the estimated and measured gravity */
+        s0 = 4.0f * q0 * (q1 * q1 + q2 * q2) + 2.0f * (q2 * ax - q1 * ay);
+        s1 = 4.0f * q1 * (q0 * q0 + q3 * q3) - 2.0f * (q3 * ax + q0 * ay) +
+             8.0f * q1 * (q1 * q1 + q2 * q2) - 4.0f * q1 + 4.0f * q1 * az;
+        s2 = 4.0f * q2 * (q0 * q0 + q3 * q3) + 2.0f * (q0 * ax - q3 * ay) +
+             8.0f * q2 * (q1 * q1 + q2 * q2) - 4.0f * q2 + 4.0f * q2 * az;
+        s3 = 4.0f * q3 * (q1 * q1 + q2 * q2) - 2.0f * (q1 * ax + q2 * ay);
+        n = s0 * s0 + s1 * s1 + s2 * s2 + s3 * s3;
+        if (n > 0.0f)
+        {
+            /* One step of gradient descent along it */
+            n = ORIENT_BETA / sqrtf(n);
+            d0 -= n * s0;
+            d1 -= n * s1;
+            d2 -= n * s2;
+            d3 -= n * s3;
+        }
+    }
+
+    q0 += d0 * o->dt;
+    q1 += d1 * o->dt;
+    q2 += d2 * o->dt;
+    q3 += d3 * o->dt;
+    n = 1.0f / sqrtf(q0 * q0 + q1 * q1 + q2 * q2 + q3 * q3);
+    o->q[0] = q0 * n;
+    o->q[1] = q1 * n;
+    o->q[2] = q2 * n;
+    o->q[3] = q3 * n;
+    return 0;
+}
+
+int orientation_up(const struct orientation *o, int16_t *up)
+{
+    const float *q;
+
+    if (!o || !up)
+    {
+        return -1;
+    }
+
+    q = o->q;
+    up[0] = (int16_t)(2.0f * (q[1] * q[3] - q[0] * q[2]) * ORIENT_Q14_ONE);
+    up[1] = (int16_t)(2.0f * (q[0] * q[1] + q[2] * q[3]) * ORIENT_Q14_ONE);
+    up[2] = (int16_t)((q[0] * q[0] - q[1] * q[1] - q[2] * q[2] +
+                       q[3] * q[3]) * ORIENT_Q14_ONE);
+    return 0;
+}
+
+static int32_t orient_mul(int32_t a, int32_t b)
+{
+    return (int32_t)(((int64_t)a * b) >> 30);
+}
+
+static uint32_t orient_sqrt(uint32_t v)
+{
+    uint32_t root = 0, bit = 1u << 30;
+
+    while (bit > v)
+    {
+        bit >>= 2;
+    }
+    while (bit)
+    {
+        if (v >= root + bit)
+        {
+            v -= root + bit;
+            root = (root >> 1) + bit;
+        }
+        else
+        {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    return root;
+}
+
+int orientation_q_init(struct orientation_q *o, float dps_per_count,
+                       float rate)
+{
+    if (!o || dps_per_count <= 0.0f || rate <= 0.0f)
+    {
+        return -1;
+    }
+
+    memset(o, 0, sizeof(*o));
+    o->q[0] = ORIENT_Q30_ONE;
+    o->gyro_step = (int32_t)(dps_per_count * ORIENT_PI / 180.0f / rate *
+                             ORIENT_Q30_ONE + 0.5f);
+    o->kp_step = (int32_t)(ORIENT_KP / rate * ORIENT_Q30_ONE + 0.5f);
+    return 0;
+}
+
+int orientation_q_update(struct orientation_q *o, const int16_t *gyro,
+                         const int16_t *acc)
+{
+    int32_t q0, q1, q2, q3, vx, vy, vz, ux, uy, uz, ex, ey, ez, hx, hy, hz, s;
+    uint32_t n;
+
+    if (!o || !gyro || !acc)
+    {
+        return -1;
+    }
+
+    q0 = o->q[0];
+    q1 = o->q[1];
+    q2 = o->q[2];
+    q3 = o->q[3];
+
+    /* Rotation over this update from the gyroscope, Q30 radians */
+    hx = gyro[0] * o->gyro_step;
+    hy = gyro[1] * o->gyro_step;
+    hz = gyro[2] * o->gyro_step;
+
+    n = orient_sqrt((uint32_t)(acc[0] * acc[0]) + (uint32_t)(acc[1] * acc[1]) +
+                    (uint32_t)(acc[2] * acc[2]));
+    if (n > 0u)
+    {
+        /* Measured gravity, Q15, and the one the quaternion expects, Q30 */
+        ux = ((int32_t)acc[0] * 32768) / (int32_t)n;
+        uy = ((int32_t)acc[1] * 32768) / (int32_t)n;
+        uz = ((int32_t)acc[2] * 32768) / (int32_t)n;
+        vx = 2 * (orient_mul(q1, q3) - orient_mul(q0, q2));
+        vy = 2 * (orient_mul(q0, q1) + orient_mul(q2, q3));
+        vz = orient_mul(q0, q0) - orient_mul(q1, q1) - orient_mul(q2, q2) +
+             orient_mul(q3, q3);
+
+        /* Turn towards the measured gravity by their cross product, Q30 */
+        ex = (int32_t)(((int64_t)uy * vz - (int64_t)uz * vy) >> 15);
+        ey = (int32_t)(((int64_t)uz * vx - (int64_t)ux * vz) >> 15);
+        ez = (int32_t)(((int64_t)ux * vy - (int64_t)uy * vx) >> 15);
+        hx += orient_mul(o->kp_step, ex);
+        hy += orient_mul(o->kp_step, ey);
+        hz += orient_mul(o->kp_step, ez);
+    }
+
+    /* q += q * (0, h) / 2 */
+    hx >>= 1;
+    hy >>= 1;
+    hz >>= 1;
+    o->q[0] = q0 - orient_mul(q1, hx) - orient_mul(q2, hy) - orient_mul(q3, hz);
+    o->q[1] = q1 + orient_mul(q0, hx) + orient_mul(q2, hz) - orient_mul(q3, hy);
+    o->q[2] = q2 + orient_mul(q0, hy) - orient_mul(q1, hz) + orient_mul(q3, hx);
+    o->q[3] = q3 + orient_mul(q0, hz) + orient_mul(q1, hy) - orient_mul(q2, hx);
+
+    /* Back to unit length: |q| stays close to 1, so one Newton step of
+       1 / sqrt(s) around 1, (3 - s) / 2, is enough */
+    s = orient_mul(o->q[0], o->q[0]) + orient_mul(o->q[1], o->q[1]) +
+        orient_mul(o->q[2], o->q[2]) + orient_mul(o->q[3], o->q[3]);
+    s = (int32_t)((((int64_t)3 << 30) - s) >> 1);
+    o->q[0] = orient_mul(o->q[0], s);
+    o->q[1] = orient_mul(o->q[1], s);
+    o->q[2] = orient_mul(o->q[2], s);
+    o->q[3] = orient_mul(o->q[3], s);
+    return 0;
+}
+
+int orientation_q_up(const struct orientation_q *o, int16_t *up)
+{
+    const int32_t *q;
+
+    if (!o || !up)
+    {
+        return -1;
+    }
+
+    q = o->q;
+    up[0] = (int16_t)((2 * (orient_mul(q[1], q[3]) -
+                            orient_mul(q[0], q[2]))) >> 16);
+    up[1] = (int16_t)((2 * (orient_mul(q[0], q[1]) +
+                            orient_mul(q[2], q[3]))) >> 16);
+    up[2] = (int16_t)((orient_mul(q[0], q[0]) - orient_mul(q[1], q[1]) -
+                       orient_mul(q[2], q[2]) + orient_mul(q[3], q[3])) >> 16);
+    return 0;
+}
+
+/* Angle of a Q14 sine, in degrees */
+static int orient_angle(int32_t sine)
+{
+    int32_t a, k, frac;
+    int neg = sine < 0;
+
+    a = neg ? -sine : sine;
+    if (a >= ORIENT_Q14_ONE)
+    {
+        a = ORIENT_Q14_ONE;
+    }
+    k = a >> 9;
+    frac = a & 511;
+    a = orient_asin[k];
+    if (k < 32)
+    {
+        a += ((orient_asin[k + 1] - orient_asin[k]) * frac) >> 9;
+    }
+    a = (a + 50) / 100;
+    return neg ? -a : a;
+}
+
+int posture_init(struct posture_state *p)
+{
+    if (!p)
+    {
+        return -1;
+    }
+
+    memset(p, 0, sizeof(*p));
+    p->posture = POSTURE_STANDING;
+    p->pending = POSTURE_STANDING;
+    return 0;
+}
+
+int posture_update(struct posture_state *p, const int16_t *up)
+{
+    int roll, seen;
+
+    if (!p || !up)
+    {
+        return -1;
+    }
+
+    p->head_down = orient_angle(-up[ORIENT_AXIS_NECK]);
+    roll = orient_angle(up[ORIENT_AXIS_SIDE]);
+    if (roll >= ORIENT_LYING_ROLL || roll <= -ORIENT_LYING_ROLL)
+    {
+        seen = POSTURE_LYING;
+    }
+    else if (p->head_down >= ORIENT_HEAD_DOWN)
+    {
+        seen = POSTURE_HEAD_DOWN;
+    }
+    else
+    {
+        seen = POSTURE_STANDING;
+    }
+
+    if (seen == p->posture)
+    {
+        p->hold = 0;
+    }
+    else if (seen != p->pending)
+    {
+        p->pending = seen;
+        p->hold = 1;
+    }
+    else if (++p->hold >= ORIENT_POSTURE_HOLD)
+    {
+        p->posture = seen;
+        p->hold = 0;
+    }
+    return p->posture;
+}
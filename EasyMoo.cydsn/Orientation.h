@@ -0,0 +1,191 @@
+#ifndef _ORIENTATION_H
+#define _ORIENTATION_H
+
+#include <stdint.h>
+
+/*
+ * Orientation filters and posture
+ *
+ * The gyroscope tracks how the collar turns but drifts; the accelerometer
+ * knows where down is but only while the cow is not accelerating. An
+ * orientation filter integrates the gyroscope into a unit quaternion and
+ * steers it towards the measured gravity, a little at every sample.
+ *
+ * Two filters are provided, with the same inputs: raw sensor counts from
+ * one FIFO record.
+ *
+ *	orientation	Madgwick's gradient descent filter in single precision,
+ *			for the CM4 and its FPU.
+ *	orientation_q	Mahony's complementary filter in Q30 integers, for
+ *			cores without an FPU such as the CM0+. It needs no
+ *			square root or division on the quaternion: the
+ *			quaternion is kept at unit length with one Newton
+ *			step per update.
+ *
+ * Both filters give the world "up" direction in sensor axes, as a Q14 unit
+ * vector, which a posture tracker turns into:
+ *
+ *	head down	the angle the neck axis (ORIENT_AXIS_NECK, pointing
+ *			towards the head) makes below the horizon.
+ *	posture		lying when the collar is rolled sideways by more than
+ *			ORIENT_LYING_ROLL, head down (grazing) when the head
+ *			is more than ORIENT_HEAD_DOWN below the horizon,
+ *			standing otherwise. A new posture has to hold for
+ *			ORIENT_POSTURE_HOLD updates before it is taken.
+ *
+ * The tracker only compares sines against constants, so it needs no
+ * floating point either. The thresholds are starting points, to be tuned
+ * on the herd.
+ */
+
+/* Sensor axes of the collar, 0 = x, 1 = y, 2 = z */
+#define ORIENT_AXIS_NECK        (0)     /* Along the neck, towards the head */
+#define ORIENT_AXIS_SIDE        (1)     /* Across the neck */
+
+/* Posture thresholds, in degrees, and hold time, in updates */
+#define ORIENT_HEAD_DOWN        (30)
+#define ORIENT_LYING_ROLL       (40)
+#define ORIENT_POSTURE_HOLD     (100)
+
+/* Madgwick gain, about the gyroscope noise in rad/s */
+#define ORIENT_BETA             (0.1f)
+
+/* Mahony proportional gain, in 1/s */
+#define ORIENT_KP               (1.0f)
+
+/* Unit vectors and sines */
+#define ORIENT_Q14_ONE          (1 << 14)
+#define ORIENT_Q30_ONE          (1 << 30)
+
+enum posture
+{
+    POSTURE_STANDING,
+    POSTURE_HEAD_DOWN,
+    POSTURE_LYING
+};
+
+/*
+ * orientation - Floating point filter state
+ * @q: Unit quaternion w, x, y, z, sensor to world
+ * @gyro_scale: Radians per gyroscope count
+ * @dt: Seconds between updates
+ */
+struct orientation
+{
+    float q[4];
+    float gyro_scale;
+    float dt;
+};
+
+/*
+ * orientation_q - Fixed point filter state
+ * @q: Unit quaternion w, x, y, z, sensor to world, Q30
+ * @gyro_step: Radians per gyroscope count and update, Q30
+ * @kp_step: Mahony gain times the update period, Q30
+ */
+struct orientation_q
+{
+    int32_t q[4];
+    int32_t gyro_step;
+    int32_t kp_step;
+};
+
+/*
+ * posture_state - Posture tracker
+ * @posture: Current posture, enum posture
+ * @pending: Posture seen last, not taken yet
+ * @hold: Updates @pending has been seen for
+ * @head_down: Last head down angle, in degrees, negative when the head is
+ * up
+ */
+struct posture_state
+{
+    int posture;
+    int pending;
+    int hold;
+    int head_down;
+};
+
+/*
+ * orientation_init - Initialize a floating point filter, level
+ * @o: Filter to initialize
+ * @dps_per_count: Gyroscope scale, in degrees per second per count
+ * @rate: Update rate, in Hz
+ *
+ * Return: -1 if @o is NULL or a scale is not positive. 0 otherwise.
+ */
+int orientation_init(struct orientation *o, float dps_per_count, float rate);
+
+/*
+ * orientation_update - Fuse one record into a floating point filter
+ * @o: Filter to update
+ * @gyro: Gyroscope counts, x, y, z
+ * @acc: Accelerometer counts, x, y, z, any scale
+ *
+ * An all zero @acc (free fall, or no reading) only integrates the gyroscope.
+ *
+ * Return: -1 if a pointer is NULL. 0 otherwise.
+ */
+int orientation_update(struct orientation *o, const int16_t *gyro,
+                       const int16_t *acc);
+
+/*
+ * orientation_up - World up in sensor axes, from a floating point filter
+ * @o: Filter to read
+ * @up: Receives the unit vector, Q14
+ *
+ * Return: -1 if a pointer is NULL. 0 otherwise.
+ */
+int orientation_up(const struct orientation *o, int16_t *up);
+
+/*
+ * orientation_q_init - Initialize a fixed point filter, level
+ * @o: Filter to initialize
+ * @dps_per_count: Gyroscope scale, in degrees per second per count
+ * @rate: Update rate, in Hz
+ *
+ * The scales are only used here, to work out the Q30 constants.
+ *
+ * Return: -1 if @o is NULL or a scale is not positive. 0 otherwise.
+ */
+int orientation_q_init(struct orientation_q *o, float dps_per_count,
+                       float rate);
+
+/*
+ * orientation_q_update - Fuse one record into a fixed point filter
+ * @o: Filter to update
+ * @gyro: Gyroscope counts, x, y, z
+ * @acc: Accelerometer counts, x, y, z, any scale
+ *
+ * Return: -1 if a pointer is NULL. 0 otherwise.
+ */
+int orientation_q_update(struct orientation_q *o, const int16_t *gyro,
+                         const int16_t *acc);
+
+/*
+ * orientation_q_up - World up in sensor axes, from a fixed point filter
+ * @o: Filter to read
+ * @up: Receives the unit vector, Q14
+ *
+ * Return: -1 if a pointer is NULL. 0 otherwise.
+ */
+int orientation_q_up(const struct orientation_q *o, int16_t *up);
+
+/*
+ * posture_init - Initialize a posture tracker, standing
+ * @p: Tracker to initialize
+ *
+ * Return: -1 if @p is NULL. 0 otherwise.
+ */
+int posture_init(struct posture_state *p);
+
+/*
+ * posture_update - Track the posture from the up direction
+ * @p: Tracker to update
+ * @up: World up in sensor axes, Q14 unit vector
+ *
+ * Return: -1 if a pointer is NULL. The current posture otherwise.
+ */
+int posture_update(struct posture_state *p, const int16_t *up);
+
+#endif /* _ORIENTATION_H */
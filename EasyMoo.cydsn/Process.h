@@ -0,0 +1,408 @@
+/******************************************************************************
+* File Name: Process.h
+*
+* Version: Beta
+*
+* Description: This file contains the data processing that runs on the CM4:
+* light and temperature clustering, motion samples and the happy score. It
+* consumes the samples acquired by the CM0+ (see CoreLink.h) and produces one
+* result per sample.
+*
+* Related Document: HappyCowReport.pdf
+* Hardware Dependency: CY8CKIT-063-BLE PSoC 6 BLE Pioneer kit
+*
+* Author(s):
+*	Yousef H. Akbar & and Cow Team
+*	Dept. Electrical and Computer Engineering
+*	University of California, Davis
+******************************************************************************/
+
+#include "project.h"
+#include "CoreLink.h"
+#include "Window.h"
+#include "Store.h"
+#include "LightRange.h"
+#include "Fixed.h"
+#include "Activity.h"
+#include "Classifier.h"
+#include "Gait.h"
+#include "Orientation.h"
+
+/* Happy Score Benchmarks */
+#define TARG_LIGHT_AVG  (200)
+#define TARG_TEMP_AVG   (25)
+
+/* The benchmarks in sample units (see Fixed.h), reduced by their greatest
+ * common divisor for fixed_happy_score() */
+#define TARG_COMMON     (100)
+#define TARG_LIGHT      ((TARG_LIGHT_AVG << LIGHT_NORM_SHIFT) / TARG_COMMON)
+#define TARG_TEMP       (TARG_TEMP_AVG * 100 / TARG_COMMON)
+#if (TARG_LIGHT_AVG << LIGHT_NORM_SHIFT) % TARG_COMMON || \
+    (TARG_TEMP_AVG * 100) % TARG_COMMON
+#error "TARG_COMMON must divide both happy score benchmarks"
+#endif
+
+/* Light/temperature thresholds are runtime settings (CONFIG_LIGHT_CUTOFF,
+ * CONFIG_CRIT_TEMP, CONFIG_CRIT_LIGHT), handed over by the CM0+. Light
+ * samples arrive normalized with LIGHT_NORM_SHIFT fractional bits, and are
+ * kept that way in the light window. */
+
+/* Number of light/temp samples the happy score is averaged over (1 hour at
+ * the 5 second tick). Window updates are O(1), so this can grow freely. */
+#define HISTORY_LEN     (720)
+
+/* Number of accelerometer/gyroscope samples kept for motion processing,
+ * 20 s at the 25 Hz FIFO rate */
+#define MOTION_LEN      (512)
+
+/* Motion records moved from the link to the stores at a time */
+#define MOTION_BATCH    (32)
+
+/* Activity feature window, 5 s at the 25 Hz FIFO rate, and zero-crossing
+ * hysteresis, 0.05 g */
+#define ACTIVITY_LEN    (128)
+#define ACTIVITY_HYST   (ACC_LSB_PER_G / 20)
+
+/* Records between two behaviour classifications, half a window */
+#define CLASSIFY_HOP    (ACTIVITY_LEN / 2)
+
+/* Behaviour classification and budgets, set to zero to leave them out, gait
+ * analysis with them. While the model is a placeholder (see
+ * classifier_provisional()), they are reported flagged as provisional */
+#define CLASSIFY_ENABLE     (1u)
+
+/* Gait analysis window, 10 s at the 25 Hz FIFO rate (a 0.1 Hz spectral
+ * resolution), and least dynamic RMS that counts as walking, 0.05 g */
+#define GAIT_LEN        (256)
+#define GAIT_MIN_RMS    (ACC_LSB_PER_G / 20.0f)
+
+/* Orientation filter, set to one to use the integer one on a core without
+ * an FPU, to zero to use the floating point one */
+#define ORIENT_USE_FIXED    (0u)
+
+/* Global Variables */
+int tempFlag, lightFlag;
+static int dark_count = 0;
+struct config settings;
+static int light_buf[HISTORY_LEN];
+static int temp_buf[HISTORY_LEN];
+static struct window_entry light_minq[HISTORY_LEN], light_maxq[HISTORY_LEN];
+static struct window_entry temp_minq[HISTORY_LEN], temp_maxq[HISTORY_LEN];
+static struct window light_win;
+static struct window temp_win;
+window_t light_window = &light_win;
+window_t temp_window  = &temp_win;
+static int16_t acc_x[MOTION_LEN], acc_y[MOTION_LEN], acc_z[MOTION_LEN];
+static int16_t gyro_x[MOTION_LEN], gyro_y[MOTION_LEN], gyro_z[MOTION_LEN];
+static uint32_t acc_t[MOTION_LEN], gyro_t[MOTION_LEN];
+static struct store acc_st;
+static struct store gyro_st;
+store_t acc_store  = &acc_st;
+store_t gyro_store = &gyro_st;
+static struct activity_entry activity_buf[ACTIVITY_LEN];
+static struct activity act;
+activity_t activity = &act;
+static int classify_count = 0;
+int behaviour = -1;
+struct behaviour_budget budget;
+static float gait_work[2 * GAIT_LEN];
+static int gait_due = 0;
+struct gait_set gait;
+static struct orientation orient;
+static struct orientation_q orient_q;
+struct posture_state posture;
+
+/* Function Name: processInit
+ *
+ * Summary:
+ * This function sets up the light/temperature windows and the motion stores.
+ * It must be called once before the first call to process_sample().
+ */
+void processInit(void)
+{
+	window_init(light_window, light_buf, light_minq, light_maxq, HISTORY_LEN);
+	window_init(temp_window, temp_buf, temp_minq, temp_maxq, HISTORY_LEN);
+	store_init(acc_store, acc_x, acc_y, acc_z, acc_t, MOTION_LEN);
+	store_init(gyro_store, gyro_x, gyro_y, gyro_z, gyro_t, MOTION_LEN);
+	activity_init(activity, activity_buf, ACTIVITY_LEN, ACTIVITY_HYST);
+	budget_init(&budget);
+	orientation_init(&orient, 1.0f / GYRO_LSB_PER_DPS, ACC_ODR_HZ);
+	orientation_q_init(&orient_q, 1.0f / GYRO_LSB_PER_DPS, ACC_ODR_HZ);
+	posture_init(&posture);
+	config_defaults(&settings);
+}
+
+/* Function Name: light_process_data
+ *
+ * Summary:
+ * This function performs the data clustering on the readings from the light
+ * sensor. This includes setting intermediate and critical flags based on the
+ * most recent readings. Namely, the three variables of interest are dark_count,
+ * lightFlag, and tempFlag. The first two check if the cow has not seen light in
+ * too long, and the last flag checks if the temperature is too high.
+ * dark_count runs on across samples, and across hibernate in the snapshot.
+ *
+ * Parameters:
+ *	@x:	the normalized xChannel (R) result
+ *	@y:	the normalized yChannel (G) result
+ *	@z:	the normalized zChannel (B) result
+ *	@temp:	the raw TEMP register
+ *	@tq:	sliding window for temperature results, in centi-degrees.
+ *	@lq:	sliding window for light results.
+ *
+ * Return:
+ *	None.
+ */
+void light_process_data(uint32_t x, uint32_t y, uint32_t z, uint16_t temp,
+		window_t tq, window_t lq)
+{
+	int chip_temp = fixed_temp_cdeg(temp);
+	int combined_light = x + y + z;
+	if (combined_light <
+			(settings.value[CONFIG_LIGHT_CUTOFF] << LIGHT_NORM_SHIFT))
+		dark_count++;
+	else
+		dark_count = 0;
+
+	window_push(lq, combined_light);
+	window_push(tq, chip_temp);
+
+	lightFlag   = dark_count >= settings.value[CONFIG_CRIT_LIGHT];
+	tempFlag    = chip_temp >= settings.value[CONFIG_CRIT_TEMP] * 100;
+}
+
+/* Function Name: classify_activity
+ *
+ * Summary:
+ * This function classifies the current activity feature window and makes
+ * the outcome the current behaviour.
+ */
+void classify_activity(void)
+{
+	struct activity_set set;
+	int32_t features[CLASSIFIER_FEATURES];
+
+	classify_count = 0;
+	if (activity_get(activity, &set) != 0)
+		return;
+	classifier_features(&set, features);
+	behaviour = classifier_predict(features);
+	gait_due = behaviour == BEHAVIOUR_WALKING;
+}
+
+/* Function Name: gait_process
+ *
+ * Summary:
+ * This function runs the gait analysis over the last GAIT_LEN accelerometer
+ * records. The indicators of the last window that looked like a gait are
+ * kept for the results, walking being when lameness shows.
+ */
+void gait_process(void)
+{
+	struct store_view view;
+	struct gait_set set;
+
+	gait_due = 0;
+	if (store_view(acc_store, GAIT_LEN, &view) != GAIT_LEN)
+		return;
+	if (gait_analyze(&view, ACC_ODR_HZ, GAIT_MIN_RMS, gait_work, &set) == 0)
+		gait = set;
+}
+
+/* Function Name: orientation_process
+ *
+ * Summary:
+ * This function fuses one FIFO record into the orientation filter and
+ * tracks the posture from it, at the sensor rate.
+ */
+void orientation_process(const struct moo_motion *m)
+{
+	int16_t up[3];
+
+	if (ORIENT_USE_FIXED) {
+		orientation_q_update(&orient_q, m->gyro, m->acc);
+		orientation_q_up(&orient_q, up);
+	} else {
+		orientation_update(&orient, m->gyro, m->acc);
+		orientation_up(&orient, up);
+	}
+	posture_update(&posture, up);
+}
+
+/* Function Name: motion_process_batch
+ *
+ * Summary:
+ * This function appends a batch of FIFO records from the CM0+ to the
+ * accelerometer and gyroscope stores, one bulk append per store, feeds
+ * the accelerometer samples to the activity features and every record to
+ * the orientation filter. Every CLASSIFY_HOP
+ * records, the full feature window is classified into the current
+ * behaviour, and gait analysed when walking.
+ *
+ * Parameters:
+ *	@m:	records, oldest first.
+ *	@n:	number of records, at most MOTION_BATCH.
+ *
+ * Return:
+ *	None.
+ */
+void motion_process_batch(const struct moo_motion *m, int n)
+{
+	static int16_t acc[3 * MOTION_BATCH], gyro[3 * MOTION_BATCH];
+	static uint32_t t[MOTION_BATCH];
+	int i;
+
+	for (i = 0; i < n; i++) {
+		acc[3 * i]      = m[i].acc[0];
+		acc[3 * i + 1]  = m[i].acc[1];
+		acc[3 * i + 2]  = m[i].acc[2];
+		gyro[3 * i]     = m[i].gyro[0];
+		gyro[3 * i + 1] = m[i].gyro[1];
+		gyro[3 * i + 2] = m[i].gyro[2];
+		t[i]            = m[i].t;
+		activity_push(activity, m[i].acc[0], m[i].acc[1], m[i].acc[2]);
+		orientation_process(&m[i]);
+		if (CLASSIFY_ENABLE && ++classify_count >= CLASSIFY_HOP &&
+				activity_length(activity) == ACTIVITY_LEN)
+			classify_activity();
+	}
+	store_append_bulk(acc_store, acc, t, n);
+	store_append_bulk(gyro_store, gyro, t, n);
+
+	/* Once the stores hold the records that were classified */
+	if (gait_due)
+		gait_process();
+}
+
+int update_happy_score(void)
+{
+    int avg_light_score = 0;
+    int avg_temp_score  = 0;
+
+    window_mean(light_window, &avg_light_score);
+    window_mean(temp_window, &avg_temp_score);
+
+    return fixed_happy_score(avg_light_score, TARG_LIGHT, avg_temp_score,
+		    TARG_TEMP, TARG_COMMON);
+}
+
+/* Function Name: process_window_state
+ *
+ * Summary:
+ * This function takes the statistics of a window for a snapshot.
+ *
+ * Parameters:
+ *	@win:	window to take them from.
+ *	@state:	receives them.
+ *
+ * Return:
+ *	None.
+ */
+void process_window_state(window_t win, struct snapshot_window *state)
+{
+	int mean = 0, min = 0, max = 0;
+
+	window_mean(win, &mean);
+	window_min(win, &min);
+	window_max(win, &max);
+	state->count = (uint16_t)window_count(win);
+	state->mean  = mean;
+	state->min   = min;
+	state->max   = max;
+}
+
+/* Function Name: processRestore
+ *
+ * Summary:
+ * This function carries the processing on from a hibernate snapshot, right
+ * after processInit(). The windows are refilled from their statistics (see
+ * window_seed()), and the time spent in hibernate goes to the behaviour
+ * current at the next sample.
+ *
+ * Parameters:
+ *	@snap:	snapshot taken before hibernate.
+ *
+ * Return:
+ *	None.
+ */
+void processRestore(const struct snapshot *snap)
+{
+	const struct snapshot_proc *p = &snap->proc;
+	int i;
+
+	window_seed(light_window, p->light.count, p->light.mean, p->light.min,
+			p->light.max);
+	window_seed(temp_window, p->temp.count, p->temp.mean, p->temp.min,
+			p->temp.max);
+	behaviour = p->behaviour;
+	dark_count = p->dark_count;
+	for (i = 0; i < BEHAVIOUR_COUNT; i++)
+		budget.seconds[i] = p->budget[i];
+	budget.last    = snap->time;
+	budget.started = 1;
+}
+
+/* Function Name: process_sample
+ *
+ * Summary:
+ * This function runs all the processing for one sample handed over by the
+ * CM0+ and fills in the result to send back.
+ *
+ * Parameters:
+ *	@s:	sample acquired by the CM0+.
+ *	@r:	result to fill in.
+ *
+ * Return:
+ *	None.
+ */
+void process_sample(const struct moo_sample *s, struct moo_result *r)
+{
+	int light_min = 0, light_max = 0;
+	struct activity_set act_set = {0};
+	uint32_t hour[BEHAVIOUR_COUNT];
+	int current, i;
+
+	light_process_data(s->xChannel, s->yChannel, s->zChannel,
+			s->temperature, temp_window, light_window);
+
+	window_min(light_window, &light_min);
+	window_max(light_window, &light_max);
+	activity_get(activity, &act_set);
+
+	/* While still, the FIFO is stopped and the cow is lying down */
+	current = s->still ? BEHAVIOUR_LYING : behaviour;
+
+	r->seq          = s->seq;
+	r->happy_score  = update_happy_score();
+	r->window_count = window_count(light_window);
+	r->light_min    = light_min >> LIGHT_NORM_SHIFT;
+	r->light_max    = light_max >> LIGHT_NORM_SHIFT;
+	r->lightFlag    = lightFlag;
+	r->tempFlag     = tempFlag;
+	r->odba         = act_set.odba;
+	r->jerk         = act_set.jerk;
+	r->zc           = act_set.zc[0] + act_set.zc[1] + act_set.zc[2];
+	r->behaviour    = current;
+	r->budget_hour  = -1;
+	r->provisional  = CLASSIFY_ENABLE && classifier_provisional();
+	r->stride_freq  = (uint16_t)(gait.stride_freq * 100.0f + 0.5f);
+	r->regularity   = (int8_t)(gait.stride_reg * 100.0f);
+	r->harmonic_ratio = gait.harmonic_ratio < 255.0f ?
+		(uint16_t)(gait.harmonic_ratio * 256.0f + 0.5f) : UINT16_MAX;
+	r->posture      = posture.posture;
+	r->head_down    = posture.head_down;
+	if (CLASSIFY_ENABLE && current >= 0 &&
+			budget_add(&budget, s->time, current, hour) == 1) {
+		r->budget_hour = (s->time / SECONDS_PER_HOUR + 23) % 24;
+		for (i = 0; i < BEHAVIOUR_COUNT; i++)
+			r->budget[i] = hour[i];
+	}
+
+	process_window_state(light_window, &r->state.light);
+	process_window_state(temp_window, &r->state.temp);
+	r->state.behaviour = (int8_t)behaviour;
+	r->state.dark_count = dark_count < UINT16_MAX ?
+		(uint16_t)dark_count : UINT16_MAX;
+	for (i = 0; i < BEHAVIOUR_COUNT; i++)
+		r->state.budget[i] = (uint16_t)budget.seconds[i];
+}
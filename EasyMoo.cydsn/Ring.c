@@ -0,0 +1,106 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Ring.h"
+
+/*
+ * The M0+ has no hardware divider, so positions are wrapped with a compare
+ * instead of a modulo.
+ */
+static int ring_wrap(ring_t ring, int pos)
+{
+    return pos >= ring->capacity ? pos - ring->capacity : pos;
+}
+
+int ring_init(ring_t ring, int *buf, int capacity, int mode)
+{
+    if (!ring || !buf || capacity <= 0)
+    {
+        return -1;
+    }
+
+    ring->buf = buf;
+    ring->capacity = capacity;
+    ring->head = 0;
+    ring->size = 0;
+    ring->mode = mode;
+    return 0;
+}
+
+int ring_enqueue(ring_t ring, int data)
+{
+    if (!ring)
+    {
+        return -1;
+    }
+
+    if (ring->size == ring->capacity)
+    {
+        if (ring->mode != RING_OVERWRITE)
+        {
+            return -1;
+        }
+        ring->buf[ring->head] = data;
+        ring->head = ring_wrap(ring, ring->head + 1);
+        return 1;
+    }
+
+    ring->buf[ring_wrap(ring, ring->head + ring->size)] = data;
+    ring->size++;
+    return 0;
+}
+
+int ring_dequeue(ring_t ring, int *data)
+{
+    if (!ring || !data || ring->size == 0)
+    {
+        return -1;
+    }
+
+    *data = ring->buf[ring->head];
+    ring->head = ring_wrap(ring, ring->head + 1);
+    ring->size--;
+    return 0;
+}
+
+int ring_peek(ring_t ring, int index, int *data)
+{
+    if (!ring || !data || index < 0 || index >= ring->size)
+    {
+        return -1;
+    }
+
+    *data = ring->buf[ring_wrap(ring, ring->head + index)];
+    return 0;
+}
+
+int ring_iterate(ring_t ring, ring_func_t func, void *arg, int *data)
+{
+    int i, pos;
+
+    if (!ring || !func)
+    {
+        return -1;
+    }
+
+    for (i = 0, pos = ring->head; i < ring->size;
+         i++, pos = ring_wrap(ring, pos + 1))
+    {
+        if (func(ring->buf[pos], arg) == 1)
+        {
+            if (data != NULL)
+            {
+                *data = ring->buf[pos];
+            }
+            break;
+        }
+    }
+
+    return 0;
+}
+
+int ring_length(ring_t ring)
+{
+    return ring ? ring->size : -1;
+}
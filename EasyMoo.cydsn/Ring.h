@@ -0,0 +1,116 @@
+#ifndef _RING_H
+#define _RING_H
+
+/*
+ * ring_t - Ring buffer type
+ *
+ * A ring is a fixed-capacity FIFO with the same semantics as queue_t, but its
+ * items live in a caller-supplied array instead of heap-allocated nodes.
+ * Nothing is ever malloc'd or freed, so a ring can run forever without
+ * fragmenting the heap.
+ *
+ * When the ring is full, enqueueing either rejects the new item or overwrites
+ * the oldest one, depending on the mode given to ring_init().
+ *
+ * Apart from iterate, all operations are O(1).
+ */
+typedef struct ring* ring_t;
+
+#define RING_REJECT     (0)     /* Enqueue fails when the ring is full */
+#define RING_OVERWRITE  (1)     /* Enqueue drops the oldest item when full */
+
+struct ring
+{
+    int *buf;
+    int capacity;
+    int head;
+    int size;
+    int mode;
+};
+
+/*
+ * ring_init - Initialize an empty ring
+ * @ring: Ring to initialize
+ * @buf: Storage for @capacity items, owned by the caller
+ * @capacity: Number of items @buf can hold
+ * @mode: RING_REJECT or RING_OVERWRITE
+ *
+ * Typically @ring and @buf are both statically allocated, eg:
+ *
+ *	static int samples[24];
+ *	static struct ring ring;
+ *	ring_init(&ring, samples, 24, RING_OVERWRITE);
+ *
+ * Return: -1 if @ring or @buf are NULL, or if @capacity is not positive. 0 if
+ * @ring was successfully initialized.
+ */
+int ring_init(ring_t ring, int *buf, int capacity, int mode);
+
+/*
+ * ring_enqueue - Enqueue data item
+ * @ring: Ring in which to enqueue item
+ * @data: Data item to enqueue
+ *
+ * Unlike queue_enqueue(), a @data of 0 is a valid item.
+ *
+ * Return: -1 if @ring is NULL, or if @ring is full and in RING_REJECT mode. 1
+ * if @ring was full and the oldest item was overwritten. 0 otherwise.
+ */
+int ring_enqueue(ring_t ring, int data);
+
+/*
+ * ring_dequeue - Dequeue data item
+ * @ring: Ring in which to dequeue item
+ * @data: Address where the item is received
+ *
+ * Remove the oldest item of ring @ring and assign this item to @data.
+ *
+ * Return: -1 if @ring or @data are NULL, or if the ring is empty. 0 if @data
+ * was set with the oldest item available in @ring.
+ */
+int ring_dequeue(ring_t ring, int *data);
+
+/*
+ * ring_peek - Read data item without removing it
+ * @ring: Ring to read from
+ * @index: Position of the item, 0 being the oldest
+ * @data: Address where the item is received
+ *
+ * Return: -1 if @ring or @data are NULL, or if @index is out of range. 0 if
+ * @data was set.
+ */
+int ring_peek(ring_t ring, int index, int *data);
+
+/*
+ * ring_func_t - Ring callback function type
+ * @data: Data item
+ * @arg: Extra argument
+ *
+ * Return: 0 to continue iterating, 1 to stop iterating at this particular item.
+ */
+typedef int (*ring_func_t)(int data, void *arg);
+
+/*
+ * ring_iterate - Iterate through a ring
+ * @ring: Ring to iterate through
+ * @func: Function to call on each ring item
+ * @arg: (Optional) Extra argument to be passed to the callback function
+ * @data: (Optional) Address where an item can be received
+ *
+ * Same contract as queue_iterate(): items are visited from the oldest to the
+ * newest, and if @func returns 1 the iteration stops and, if @data is not
+ * NULL, @data receives the item where the iteration was stopped.
+ *
+ * Return: -1 if @ring or @func are NULL, 0 otherwise.
+ */
+int ring_iterate(ring_t ring, ring_func_t func, void *arg, int *data);
+
+/*
+ * ring_length - Ring length
+ * @ring: Ring to get the length of
+ *
+ * Return: -1 if @ring is NULL. Number of items in @ring otherwise.
+ */
+int ring_length(ring_t ring);
+
+#endif /* _RING_H */
@@ -0,0 +1,168 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Sched.h"
+
+/* Whether @a is at or after @b, across wrap around */
+static int sched_reached(uint32_t a, uint32_t b)
+{
+    return (int32_t)(a - b) >= 0;
+}
+
+int sched_init(sched_t s, struct sched_task *tasks, int capacity)
+{
+    if (!s || !tasks || capacity <= 0 || capacity > SCHED_MAX_TASKS)
+    {
+        return -1;
+    }
+
+    s->tasks = tasks;
+    s->capacity = capacity;
+    s->count = 0;
+    return 0;
+}
+
+int sched_add(sched_t s, void (*run)(void *), void *arg, uint32_t period,
+              uint32_t deadline, uint32_t first)
+{
+    struct sched_task *t;
+
+    if (!s || !run || s->count == s->capacity)
+    {
+        return -1;
+    }
+
+    t = &s->tasks[s->count];
+    memset(t, 0, sizeof(*t));
+    t->run = run;
+    t->arg = arg;
+    t->period = period;
+    t->deadline = deadline;
+    t->release = first;
+    t->active = 1;
+    return s->count++;
+}
+
+int sched_set_period(sched_t s, int id, uint32_t period)
+{
+    struct sched_task *t;
+
+    if (!s || id < 0 || id >= s->count || period == 0 ||
+        s->tasks[id].period == 0)
+    {
+        return -1;
+    }
+
+    t = &s->tasks[id];
+    t->release = t->release - t->period + period;
+    t->period = period;
+    return 0;
+}
+
+int sched_wake(sched_t s, int id, uint32_t now)
+{
+    if (!s || id < 0 || id >= s->count)
+    {
+        return -1;
+    }
+
+    s->tasks[id].release = now;
+    s->tasks[id].active = 1;
+    return 0;
+}
+
+int sched_start(sched_t s, int id, uint32_t at)
+{
+    return sched_wake(s, id, at);
+}
+
+int sched_stop(sched_t s, int id)
+{
+    if (!s || id < 0 || id >= s->count)
+    {
+        return -1;
+    }
+
+    s->tasks[id].active = 0;
+    return 0;
+}
+
+int sched_run(sched_t s, uint32_t now)
+{
+    struct sched_task *t, *next;
+    uint32_t due = 0;
+    int i, n = 0;
+
+    if (!s)
+    {
+        return -1;
+    }
+
+    /* Tasks due at @now, so that tasks released by a task body wait */
+    for (i = 0; i < s->count; i++)
+    {
+        if (s->tasks[i].active && sched_reached(now, s->tasks[i].release))
+        {
+            due |= 1u << i;
+        }
+    }
+
+    while (due)
+    {
+        /* Earliest deadline first */
+        next = NULL;
+        for (i = 0; i < s->count; i++)
+        {
+            t = &s->tasks[i];
+            if ((due & (1u << i)) &&
+                (!next || !sched_reached(t->release + t->deadline,
+                                         next->release + next->deadline)))
+            {
+                next = t;
+            }
+        }
+        due &= ~(1u << (next - s->tasks));
+
+        if (!sched_reached(next->release + next->deadline, now))
+        {
+            next->misses++;
+        }
+        next->release += next->period;
+        if (next->period == 0)
+        {
+            /* One-shot, the body may arm it again */
+            next->active = 0;
+        }
+        else if (sched_reached(now, next->release))
+        {
+            /* More than a period behind, skip what was missed */
+            next->release = now + next->period;
+        }
+        next->runs++;
+        next->run(next->arg);
+        n++;
+    }
+    return n;
+}
+
+int sched_next(sched_t s, uint32_t *when)
+{
+    int i, armed = 0;
+
+    if (!s || !when)
+    {
+        return -1;
+    }
+
+    for (i = 0; i < s->count; i++)
+    {
+        if (s->tasks[i].active &&
+            (!armed || !sched_reached(s->tasks[i].release, *when)))
+        {
+            *when = s->tasks[i].release;
+            armed = 1;
+        }
+    }
+    return armed ? 0 : -1;
+}
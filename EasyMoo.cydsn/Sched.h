@@ -0,0 +1,161 @@
+#ifndef _SCHED_H
+#define _SCHED_H
+
+#include <stdint.h>
+
+/*
+ * sched_t - Cooperative multi-rate task scheduler
+ *
+ * A scheduler runs a fixed set of tasks, each at its own period, from one
+ * loop that sleeps in between: sched_run() runs every task that is due,
+ * most urgent deadline first, and sched_next() tells when the next one is
+ * due, so the wake up can be set for then and no time is spent polling.
+ *
+ * A task of period zero is a one-shot timer: it runs once at its release,
+ * then stays stopped until sched_start() or sched_wake() arm it again.
+ * Any task can be stopped with sched_stop().
+ *
+ * Time is in ticks of whatever clock the caller has, as long as it only
+ * moves forward. It may wrap around: releases are compared by distance, so
+ * periods must stay below 2^31 ticks.
+ *
+ * A task that runs more than its deadline after it was released counts a
+ * miss. A task that fell more than one period behind is not run again for
+ * every period it missed; it is released again one period after it ran.
+ *
+ * All storage is supplied by the caller, eg for 4 tasks:
+ *
+ *	static struct sched_task tasks[4];
+ *	static struct sched s;
+ *	sched_init(&s, tasks, 4);
+ *	light = sched_add(&s, light_task, NULL, 5, 1, now);
+ */
+typedef struct sched* sched_t;
+
+/* Most tasks a scheduler can run */
+#define SCHED_MAX_TASKS     (32)
+
+/*
+ * sched_task - One periodic task
+ * @run: Task body, given @arg
+ * @arg: Argument of @run
+ * @period: Ticks between two releases
+ * @deadline: Ticks after its release by which it must have run
+ * @release: Next release
+ * @active: Whether @release is armed
+ * @runs: Times run
+ * @misses: Times run later than @deadline
+ */
+struct sched_task
+{
+    void (*run)(void *arg);
+    void *arg;
+    uint32_t period;
+    uint32_t deadline;
+    uint32_t release;
+    int active;
+    uint32_t runs;
+    uint32_t misses;
+};
+
+struct sched
+{
+    struct sched_task *tasks;
+    int capacity;
+    int count;
+};
+
+/*
+ * sched_init - Initialize a scheduler with no tasks
+ * @s: Scheduler to initialize
+ * @tasks: Storage for @capacity tasks
+ * @capacity: Most tasks that can be added
+ *
+ * Return: -1 if @s or @tasks are NULL or if @capacity is not 1 to
+ * SCHED_MAX_TASKS. 0 if @s was successfully initialized.
+ */
+int sched_init(sched_t s, struct sched_task *tasks, int capacity);
+
+/*
+ * sched_add - Add a task
+ * @s: Scheduler to add to
+ * @run: Task body
+ * @arg: Argument of @run
+ * @period: Ticks between two releases, zero for a one-shot timer
+ * @deadline: Ticks after its release by which it must have run
+ * @first: First release
+ *
+ * Return: -1 if @s or @run are NULL or if @s is full. The task id
+ * otherwise.
+ */
+int sched_add(sched_t s, void (*run)(void *), void *arg, uint32_t period,
+              uint32_t deadline, uint32_t first);
+
+/*
+ * sched_set_period - Change the period of a task
+ * @s: Scheduler
+ * @id: Task id
+ * @period: New period, positive
+ *
+ * The next release moves by the difference, so it stays one period after
+ * the last one.
+ *
+ * Return: -1 if @s is NULL, if @id is unknown or if @period or the current
+ * period is zero. 0 otherwise.
+ */
+int sched_set_period(sched_t s, int id, uint32_t period);
+
+/*
+ * sched_start - Arm a task for a given release
+ * @s: Scheduler
+ * @id: Task id
+ * @at: Release
+ *
+ * Return: -1 if @s is NULL or if @id is unknown. 0 otherwise.
+ */
+int sched_start(sched_t s, int id, uint32_t at);
+
+/*
+ * sched_stop - Disarm a task
+ * @s: Scheduler
+ * @id: Task id
+ *
+ * Return: -1 if @s is NULL or if @id is unknown. 0 otherwise.
+ */
+int sched_stop(sched_t s, int id);
+
+/*
+ * sched_wake - Release a task now, ahead of its period
+ * @s: Scheduler
+ * @id: Task id
+ * @now: Current time
+ *
+ * For work signalled by an interrupt. The period restarts from @now.
+ *
+ * Return: -1 if @s is NULL or if @id is unknown. 0 otherwise.
+ */
+int sched_wake(sched_t s, int id, uint32_t now);
+
+/*
+ * sched_run - Run every due task
+ * @s: Scheduler
+ * @now: Current time
+ *
+ * Due tasks run once each, earliest deadline first. Tasks a task body
+ * wakes or starts are left for the next call.
+ *
+ * Return: -1 if @s is NULL. Number of tasks run otherwise.
+ */
+int sched_run(sched_t s, uint32_t now);
+
+/*
+ * sched_next - Time the next task is due
+ * @s: Scheduler
+ * @when: Receives the earliest release
+ *
+ * Return: -1 if a pointer is NULL or if no task is armed. 0 if @when was
+ * set.
+ */
+int sched_next(sched_t s, uint32_t *when);
+
+#endif /* _SCHED_H */
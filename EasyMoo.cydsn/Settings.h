@@ -0,0 +1,202 @@
+/******************************************************************************
+* File Name: Settings.h
+*
+* Version: Beta
+*
+* Description: This file contains the runtime settings of the collar (see
+* Config.h): loading them from flash at start up, changing them from the BLE
+* inbound characteristic, saving them back and handing them to the CM4. The
+* task periods are taken from them by the main loop.
+*
+* Related Document: Technical Reference Manual, Flash Memory Programming
+* Hardware Dependency: CY8CKIT-063-BLE PSoC 6 BLE Pioneer kit
+*
+* Author(s):
+*	Yousef H. Akbar & and Cow Team
+*	Dept. Electrical and Computer Engineering
+*	University of California, Davis
+*******************************************************************************
+* The settings are saved as a configuration frame (see Frame.h) in one flash
+* row of the emulated EEPROM region, so the version and CRC of the frame tell
+* a saved configuration from an erased or torn row. A row that does not check
+* loads the defaults.
+*
+* Commands arrive from the BLE event handler and only change the settings in
+* RAM. The main loop then saves and applies them in settingsCommit(): a row
+* write blocks for a few milliseconds and must not run from an interrupt.
+******************************************************************************/
+
+#ifndef SETTINGS_H
+#define SETTINGS_H
+
+#include "stdio.h"
+#include "string.h"
+#include "project.h"
+#include "Config.h"
+#include "Frame.h"
+#include "CoreLink.h"
+
+/* Flash row holding the saved settings, erased (all zero) in the image */
+CY_SECTION(".cy_em_eeprom") CY_ALIGN(CY_FLASH_SIZEOF_ROW)
+static const uint8_t settingsRow[CY_FLASH_SIZEOF_ROW] = { 0u };
+
+struct config settings;
+static volatile int settingsDirty = 0;
+static volatile int settingsPending = 0;
+
+/******************************************************************************
+* Function Name: settingsApply
+*******************************************************************************
+*
+* Summary:
+*  This function hands the settings over to the CM4. If the CM4 has not
+*  taken the last ones yet, they are handed over again from the next
+*  settingsCommit().
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+******************************************************************************/
+void settingsApply(void)
+{
+    struct config cfg;
+    uint32_t intr;
+
+    intr = Cy_SysLib_EnterCriticalSection();
+    cfg = settings;
+    Cy_SysLib_ExitCriticalSection(intr);
+
+    settingsPending = coreLinkPushConfig(&cfg) != 0;
+}
+
+/******************************************************************************
+* Function Name: settingsLoad
+*******************************************************************************
+*
+* Summary:
+*  This function loads the saved settings, or the defaults if none are
+*  saved, and applies them. It must be called once, after init_RTC() and
+*  coreLinkInit().
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+******************************************************************************/
+void settingsLoad(void)
+{
+    static uint8_t row[CY_FLASH_SIZEOF_ROW];
+    const volatile uint8_t *flash = settingsRow;
+    struct frame_header hdr;
+    uint32_t i, len;
+
+    /* Read through a volatile pointer, the compiler only knows the row as
+       it is in the image */
+    for (i = 0; i < sizeof(row); i++)
+        row[i] = flash[i];
+
+    /* The frame is as long as the settings it was saved with */
+    len = FRAME_CONFIG_LEN(row[FRAME_HEADER_LEN]);
+    if (len > sizeof(row))
+        len = sizeof(row);
+
+    config_defaults(&settings);
+    if (frame_decode_config(row, len, &hdr, &settings) < 0)
+        printf("No saved settings, using the defaults.\r\n");
+    settingsApply();
+}
+
+/******************************************************************************
+* Function Name: settingsSet
+*******************************************************************************
+*
+* Summary:
+*  This function changes one setting, to be saved and applied from the main
+*  loop. Called from the BLE event handler.
+*
+* Parameters:
+*  key: enum config_key
+*  value: new value
+*
+* Return:
+*  0 if the setting was changed, -1 if the key is unknown or the value out
+*  of range
+*
+******************************************************************************/
+int settingsSet(int key, int32_t value)
+{
+    if (config_set(&settings, key, value) != 0)
+        return -1;
+    settingsDirty = 1;
+    return 0;
+}
+
+/******************************************************************************
+* Function Name: settingsDefaults
+*******************************************************************************
+*
+* Summary:
+*  This function resets every setting to its default, to be saved and
+*  applied from the main loop. Called from the BLE event handler.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+******************************************************************************/
+void settingsDefaults(void)
+{
+    config_defaults(&settings);
+    settingsDirty = 1;
+}
+
+/******************************************************************************
+* Function Name: settingsCommit
+*******************************************************************************
+*
+* Summary:
+*  This function saves changed settings to flash and applies them. Called
+*  from the main loop; it does nothing if nothing changed.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+******************************************************************************/
+void settingsCommit(void)
+{
+    static uint32_t row[CY_FLASH_SIZEOF_ROW / sizeof(uint32_t)];
+    struct frame_header hdr = { FRAME_VERSION, FRAME_TYPE_CONFIG, 0,
+        RtcSeconds() };
+    struct config cfg;
+    uint32_t intr;
+
+    if (!settingsDirty)
+    {
+        if (settingsPending)
+            settingsApply();
+        return;
+    }
+
+    intr = Cy_SysLib_EnterCriticalSection();
+    cfg = settings;
+    settingsDirty = 0;
+    Cy_SysLib_ExitCriticalSection(intr);
+
+    memset(row, 0, sizeof(row));
+    frame_encode_config(&hdr, &cfg, (uint8_t *)row, sizeof(row));
+    if (Cy_Flash_WriteRow((uint32_t)settingsRow, row) != CY_FLASH_DRV_SUCCESS)
+        printf("Failed to save settings.\r\n");
+    settingsApply();
+}
+
+#endif /* SETTINGS_H */
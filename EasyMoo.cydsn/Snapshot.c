@@ -0,0 +1,135 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Snapshot.h"
+#include "Frame.h"
+
+/* Bytes packed: magic, version, fields, CRC */
+#define SNAPSHOT_LEN        (2 + 20 + 2 * 14 + 1 + 2 * BEHAVIOUR_COUNT + 2 + 2)
+
+/* The bytes must fit the backup registers. BEHAVIOUR_COUNT is an enum, out
+ * of reach of #if, so a negative array size stops the build instead */
+typedef char snapshot_len_check[SNAPSHOT_LEN <= SNAPSHOT_WORDS * 4 ? 1 : -1];
+
+static uint8_t *snapshot_put16(uint8_t *p, uint16_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    return p + 2;
+}
+
+static uint8_t *snapshot_put32(uint8_t *p, uint32_t v)
+{
+    p = snapshot_put16(p, (uint16_t)v);
+    return snapshot_put16(p, (uint16_t)(v >> 16));
+}
+
+static uint16_t snapshot_get16(const uint8_t *p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t snapshot_get32(const uint8_t *p)
+{
+    return snapshot_get16(p) | ((uint32_t)snapshot_get16(p + 2) << 16);
+}
+
+static uint8_t *snapshot_put_window(uint8_t *p, const struct snapshot_window *w)
+{
+    p = snapshot_put16(p, w->count);
+    p = snapshot_put32(p, (uint32_t)w->mean);
+    p = snapshot_put32(p, (uint32_t)w->min);
+    return snapshot_put32(p, (uint32_t)w->max);
+}
+
+static const uint8_t *snapshot_get_window(const uint8_t *p,
+                                          struct snapshot_window *w)
+{
+    w->count = snapshot_get16(p);
+    w->mean = (int32_t)snapshot_get32(p + 2);
+    w->min = (int32_t)snapshot_get32(p + 6);
+    w->max = (int32_t)snapshot_get32(p + 10);
+    return p + 14;
+}
+
+int snapshot_encode(const struct snapshot *s, uint32_t *words)
+{
+    uint8_t buf[SNAPSHOT_WORDS * 4];
+    uint8_t *p = buf;
+    int i;
+
+    if (!s || !words)
+    {
+        return -1;
+    }
+
+    memset(buf, 0, sizeof(buf));
+    *p++ = SNAPSHOT_MAGIC;
+    *p++ = SNAPSHOT_VERSION;
+    p = snapshot_put32(p, s->time);
+    p = snapshot_put32(p, s->sample_seq);
+    p = snapshot_put32(p, s->history_seq);
+    p = snapshot_put32(p, s->last_motion);
+    p = snapshot_put16(p, (uint16_t)s->happy_score);
+    *p++ = s->state;
+    *p++ = s->inactive;
+    p = snapshot_put_window(p, &s->proc.light);
+    p = snapshot_put_window(p, &s->proc.temp);
+    *p++ = (uint8_t)s->proc.behaviour;
+    for (i = 0; i < BEHAVIOUR_COUNT; i++)
+    {
+        p = snapshot_put16(p, s->proc.budget[i]);
+    }
+    p = snapshot_put16(p, s->proc.dark_count);
+    snapshot_put16(p, frame_crc16(buf, (uint32_t)(p - buf)));
+
+    for (i = 0; i < SNAPSHOT_WORDS; i++)
+    {
+        words[i] = snapshot_get32(&buf[4 * i]);
+    }
+    return 0;
+}
+
+int snapshot_decode(const uint32_t *words, struct snapshot *s)
+{
+    uint8_t buf[SNAPSHOT_WORDS * 4];
+    const uint8_t *p = buf + 2;
+    struct snapshot out;
+    int i;
+
+    if (!words || !s)
+    {
+        return -1;
+    }
+
+    for (i = 0; i < SNAPSHOT_WORDS; i++)
+    {
+        snapshot_put32(&buf[4 * i], words[i]);
+    }
+    if (buf[0] != SNAPSHOT_MAGIC || buf[1] != SNAPSHOT_VERSION ||
+        frame_crc16(buf, SNAPSHOT_LEN - 2) !=
+            snapshot_get16(&buf[SNAPSHOT_LEN - 2]))
+    {
+        return -1;
+    }
+
+    out.time = snapshot_get32(p);
+    out.sample_seq = snapshot_get32(p + 4);
+    out.history_seq = snapshot_get32(p + 8);
+    out.last_motion = snapshot_get32(p + 12);
+    out.happy_score = (int16_t)snapshot_get16(p + 16);
+    out.state = p[18];
+    out.inactive = p[19];
+    p = snapshot_get_window(p + 20, &out.proc.light);
+    p = snapshot_get_window(p, &out.proc.temp);
+    out.proc.behaviour = (int8_t)*p++;
+    for (i = 0; i < BEHAVIOUR_COUNT; i++)
+    {
+        out.proc.budget[i] = snapshot_get16(p + 2 * i);
+    }
+    out.proc.dark_count = snapshot_get16(p + 2 * BEHAVIOUR_COUNT);
+
+    *s = out;
+    return 0;
+}
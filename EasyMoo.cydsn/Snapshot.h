@@ -0,0 +1,101 @@
+#ifndef _SNAPSHOT_H
+#define _SNAPSHOT_H
+
+#include <stdint.h>
+
+#include "Classifier.h"
+
+/*
+ * Application state kept across hibernate
+ *
+ * Hibernate loses the RAM of both cores, and waking up from it is a reset.
+ * A snapshot is what the collar needs to carry on from where it stopped
+ * instead of starting over: the counters that number what it sends, the
+ * state machine, and the statistics of the light and temperature windows
+ * rather than their samples (see window_seed()).
+ *
+ * A snapshot packs into SNAPSHOT_WORDS words, the size of the backup
+ * registers, with a version and a CRC-16 so that a wake up without a valid
+ * snapshot starts over. The settings are not part of it, they are saved in
+ * flash on their own (see Config.h).
+ */
+
+#define SNAPSHOT_WORDS      (16)
+#define SNAPSHOT_MAGIC      (0x4D)
+#define SNAPSHOT_VERSION    (2)
+
+/*
+ * snapshot_window - Statistics of a sliding window
+ * @count: Number of samples
+ * @mean: Mean of the samples
+ * @min: Smallest sample
+ * @max: Largest sample
+ */
+struct snapshot_window
+{
+    uint16_t count;
+    int32_t mean;
+    int32_t min;
+    int32_t max;
+};
+
+/*
+ * snapshot_proc - State of the processing on the CM4
+ * @light: Light window
+ * @temp: Temperature window
+ * @behaviour: enum behaviour, -1 if unknown
+ * @budget: Seconds per behaviour of the hour in progress
+ * @dark_count: Samples in a row without light
+ */
+struct snapshot_proc
+{
+    struct snapshot_window light;
+    struct snapshot_window temp;
+    int8_t behaviour;
+    uint16_t budget[BEHAVIOUR_COUNT];
+    uint16_t dark_count;
+};
+
+/*
+ * snapshot - State to carry on from
+ * @time: RTC time of day it was taken at, seconds
+ * @sample_seq: Samples acquired
+ * @history_seq: Sequence number of the next history record
+ * @last_motion: RTC time of day of the last motion, seconds
+ * @happy_score: Last happy score
+ * @state: enum STATES of the state machine
+ * @inactive: Whether the cow was lying still
+ * @proc: Processing state
+ */
+struct snapshot
+{
+    uint32_t time;
+    uint32_t sample_seq;
+    uint32_t history_seq;
+    uint32_t last_motion;
+    int16_t happy_score;
+    uint8_t state;
+    uint8_t inactive;
+    struct snapshot_proc proc;
+};
+
+/*
+ * snapshot_encode - Pack a snapshot
+ * @s: Snapshot to pack
+ * @words: Receives SNAPSHOT_WORDS words
+ *
+ * Return: -1 if a pointer is NULL. 0 otherwise.
+ */
+int snapshot_encode(const struct snapshot *s, uint32_t *words);
+
+/*
+ * snapshot_decode - Unpack a snapshot
+ * @words: SNAPSHOT_WORDS words
+ * @s: Receives the snapshot
+ *
+ * Return: -1 if a pointer is NULL or if @words hold no snapshot of this
+ * version, @s being left as it was. 0 otherwise.
+ */
+int snapshot_decode(const uint32_t *words, struct snapshot *s);
+
+#endif /* _SNAPSHOT_H */
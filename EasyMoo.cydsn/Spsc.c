@@ -0,0 +1,109 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Spsc.h"
+
+/*
+ * Each side publishes its index with release semantics and reads the other
+ * side's index with acquire semantics, so a record is fully copied before the
+ * other side can see it. On the M0+ and M4 these are plain loads and stores
+ * fenced with a DMB; no exclusive access instructions are needed.
+ */
+#define SPSC_LOAD(p)        __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define SPSC_STORE(p, v)    __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+
+int spsc_init(spsc_t ring, void *buf, uint32_t elem_size, uint32_t capacity)
+{
+    if (!ring || !buf || elem_size == 0 || capacity == 0 ||
+        (capacity & (capacity - 1)) != 0)
+    {
+        return -1;
+    }
+
+    ring->head = 0;
+    ring->tail = 0;
+    ring->mask = capacity - 1;
+    ring->elem_size = elem_size;
+    ring->buf = buf;
+    ring->dropped = 0;
+    return 0;
+}
+
+int spsc_push(spsc_t ring, const void *elem)
+{
+    uint32_t tail, head;
+
+    if (!ring || !elem)
+    {
+        return -1;
+    }
+
+    tail = ring->tail;
+    head = SPSC_LOAD(&ring->head);
+    if (tail - head > ring->mask)
+    {
+        ring->dropped++;
+        return -1;
+    }
+
+    memcpy(ring->buf + (tail & ring->mask) * ring->elem_size, elem,
+           ring->elem_size);
+    SPSC_STORE(&ring->tail, tail + 1);
+    return 0;
+}
+
+int spsc_peek(spsc_t ring, void *elem)
+{
+    uint32_t head, tail;
+
+    if (!ring || !elem)
+    {
+        return -1;
+    }
+
+    head = ring->head;
+    tail = SPSC_LOAD(&ring->tail);
+    if (head == tail)
+    {
+        return -1;
+    }
+
+    memcpy(elem, ring->buf + (head & ring->mask) * ring->elem_size,
+           ring->elem_size);
+    return 0;
+}
+
+int spsc_pop(spsc_t ring, void *elem)
+{
+    uint32_t head, tail;
+
+    if (!ring)
+    {
+        return -1;
+    }
+
+    head = ring->head;
+    tail = SPSC_LOAD(&ring->tail);
+    if (head == tail)
+    {
+        return -1;
+    }
+
+    if (elem != NULL)
+    {
+        memcpy(elem, ring->buf + (head & ring->mask) * ring->elem_size,
+               ring->elem_size);
+    }
+    SPSC_STORE(&ring->head, head + 1);
+    return 0;
+}
+
+uint32_t spsc_length(spsc_t ring)
+{
+    if (!ring)
+    {
+        return 0;
+    }
+    return SPSC_LOAD(&ring->tail) - SPSC_LOAD(&ring->head);
+}
@@ -0,0 +1,89 @@
+#ifndef _SPSC_H
+#define _SPSC_H
+
+#include <stdint.h>
+
+/*
+ * spsc_t - Single-producer/single-consumer ring type
+ *
+ * An spsc ring passes fixed-size records from exactly one producer to exactly
+ * one consumer without locks. The producer only ever writes @tail and the
+ * consumer only ever writes @head, so the two sides can run on different
+ * cores (or in an interrupt and the main loop) as long as each side is a
+ * single context.
+ *
+ * Indices are free-running 32-bit counters and the capacity is a power of
+ * two, so the fill level is simply @tail - @head and no slot is wasted.
+ *
+ * The ring descriptor and its storage must be placed in memory visible to
+ * both sides, eg SRAM shared by the CM0+ and the CM4.
+ *
+ * All operations are O(1).
+ */
+typedef struct spsc* spsc_t;
+
+struct spsc
+{
+    volatile uint32_t head;     /* Next slot to read, written by consumer */
+    volatile uint32_t tail;     /* Next slot to write, written by producer */
+    uint32_t mask;
+    uint32_t elem_size;
+    uint8_t *buf;
+    uint32_t dropped;           /* Pushes rejected because the ring was full */
+};
+
+/*
+ * spsc_init - Initialize an empty ring
+ * @ring: Ring to initialize
+ * @buf: Storage for @capacity records of @elem_size bytes each
+ * @elem_size: Size in bytes of one record
+ * @capacity: Number of records, must be a power of two
+ *
+ * Must be called before either side uses the ring.
+ *
+ * Return: -1 if @ring or @buf are NULL, if @elem_size is 0, or if @capacity
+ * is not a power of two. 0 if @ring was successfully initialized.
+ */
+int spsc_init(spsc_t ring, void *buf, uint32_t elem_size, uint32_t capacity);
+
+/*
+ * spsc_push - Append a record (producer side)
+ * @ring: Ring to push into
+ * @elem: Record of @ring->elem_size bytes to copy in
+ *
+ * Return: -1 if @ring or @elem are NULL, or if the ring is full. 0 if @elem
+ * was pushed.
+ */
+int spsc_push(spsc_t ring, const void *elem);
+
+/*
+ * spsc_peek - Copy the oldest record without removing it (consumer side)
+ * @ring: Ring to read from
+ * @elem: Address where the record is copied
+ *
+ * Return: -1 if @ring or @elem are NULL, or if the ring is empty. 0 if @elem
+ * was set.
+ */
+int spsc_peek(spsc_t ring, void *elem);
+
+/*
+ * spsc_pop - Remove the oldest record (consumer side)
+ * @ring: Ring to pop from
+ * @elem: (Optional) Address where the record is copied
+ *
+ * Return: -1 if @ring is NULL or if the ring is empty. 0 if a record was
+ * removed.
+ */
+int spsc_pop(spsc_t ring, void *elem);
+
+/*
+ * spsc_length - Number of records in the ring
+ * @ring: Ring to query
+ *
+ * The result is a snapshot; the other side may change it at any time.
+ *
+ * Return: 0 if @ring is NULL. Number of records otherwise.
+ */
+uint32_t spsc_length(spsc_t ring);
+
+#endif /* _SPSC_H */
@@ -0,0 +1,147 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Store.h"
+
+static int store_wrap(store_t store, int pos)
+{
+    return pos >= store->capacity ? pos - store->capacity : pos;
+}
+
+int store_init(store_t store, int16_t *x, int16_t *y, int16_t *z, uint32_t *t,
+               int capacity)
+{
+    if (!store || !x || !y || !z || !t || capacity <= 0)
+    {
+        return -1;
+    }
+
+    store->x = x;
+    store->y = y;
+    store->z = z;
+    store->t = t;
+    store->capacity = capacity;
+    store->head = 0;
+    store->size = 0;
+    return 0;
+}
+
+int store_append(store_t store, int16_t x, int16_t y, int16_t z, uint32_t t)
+{
+    int pos;
+
+    if (!store)
+    {
+        return -1;
+    }
+
+    pos = store_wrap(store, store->head + store->size);
+    store->x[pos] = x;
+    store->y[pos] = y;
+    store->z[pos] = z;
+    store->t[pos] = t;
+
+    if (store->size == store->capacity)
+    {
+        store->head = store_wrap(store, store->head + 1);
+        return 1;
+    }
+    store->size++;
+    return 0;
+}
+
+int store_append_bulk(store_t store, const int16_t *xyz, const uint32_t *t,
+                      int n)
+{
+    int overwritten, pos, run, i;
+
+    if (!store || !xyz || !t || n < 0)
+    {
+        return -1;
+    }
+
+    overwritten = store->size + n - store->capacity;
+    if (overwritten < 0)
+    {
+        overwritten = 0;
+    }
+
+    /* Only the newest @capacity samples of the batch can survive */
+    if (n > store->capacity)
+    {
+        xyz += 3 * (n - store->capacity);
+        t += n - store->capacity;
+        n = store->capacity;
+    }
+
+    pos = store_wrap(store, store->head + store->size);
+    while (n > 0)
+    {
+        run = store->capacity - pos;
+        if (run > n)
+        {
+            run = n;
+        }
+        for (i = 0; i < run; i++)
+        {
+            store->x[pos + i] = xyz[3 * i];
+            store->y[pos + i] = xyz[3 * i + 1];
+            store->z[pos + i] = xyz[3 * i + 2];
+        }
+        memcpy(&store->t[pos], t, run * sizeof(*t));
+
+        xyz += 3 * run;
+        t += run;
+        n -= run;
+        store->size += run;
+        pos = store_wrap(store, pos + run);
+    }
+
+    if (store->size > store->capacity)
+    {
+        store->head = store_wrap(store, store->head +
+                                 (store->size - store->capacity));
+        store->size = store->capacity;
+    }
+    return overwritten;
+}
+
+int store_view(store_t store, int n, struct store_view *view)
+{
+    int start, first;
+
+    if (!store || !view || n < 0)
+    {
+        return -1;
+    }
+
+    if (n > store->size)
+    {
+        n = store->size;
+    }
+    start = store_wrap(store, store->head + (store->size - n));
+    first = store->capacity - start;
+    if (first > n)
+    {
+        first = n;
+    }
+
+    view->x[0] = &store->x[start];
+    view->y[0] = &store->y[start];
+    view->z[0] = &store->z[start];
+    view->t[0] = &store->t[start];
+    view->len[0] = first;
+
+    view->x[1] = store->x;
+    view->y[1] = store->y;
+    view->z[1] = store->z;
+    view->t[1] = store->t;
+    view->len[1] = n - first;
+    return n;
+}
+
+int store_length(store_t store)
+{
+    return store ? store->size : -1;
+}
@@ -0,0 +1,105 @@
+#ifndef _STORE_H
+#define _STORE_H
+
+#include <stdint.h>
+
+/*
+ * store_t - Multi-axis sample store type
+ *
+ * A store keeps the most recent N three-axis samples (eg accelerometer or
+ * gyroscope x/y/z) with a timestamp each. Samples are laid out as a structure
+ * of arrays: one int16_t array per axis plus one uint32_t array of
+ * timestamps, so an axis is a contiguous run of memory that a processing
+ * loop can walk with no stride. A sample costs 6 bytes of axis data plus
+ * its timestamp, and nothing is allocated on the heap.
+ *
+ * Once full, appending overwrites the oldest samples.
+ *
+ * Because the arrays wrap around, a window of the most recent samples is
+ * returned as a store_view of at most two contiguous segments.
+ */
+typedef struct store* store_t;
+
+struct store
+{
+    int16_t *x, *y, *z;
+    uint32_t *t;
+    int capacity;
+    int head;
+    int size;
+};
+
+/*
+ * store_view - Window over the most recent samples of a store
+ *
+ * Segment 0 holds the older samples and segment 1 the newer ones. @len[1] is
+ * 0 when the window did not wrap. The pointers alias the store and are only
+ * valid until the next append.
+ */
+struct store_view
+{
+    const int16_t *x[2], *y[2], *z[2];
+    const uint32_t *t[2];
+    int len[2];
+};
+
+/*
+ * store_init - Initialize an empty store
+ * @store: Store to initialize
+ * @x, @y, @z: Storage for @capacity samples of each axis
+ * @t: Storage for @capacity timestamps
+ * @capacity: Number of samples the store holds
+ *
+ * Return: -1 if any pointer is NULL or if @capacity is not positive. 0 if
+ * @store was successfully initialized.
+ */
+int store_init(store_t store, int16_t *x, int16_t *y, int16_t *z, uint32_t *t,
+               int capacity);
+
+/*
+ * store_append - Append one sample
+ * @store: Store to append to
+ * @x, @y, @z: Sample
+ * @t: Timestamp of the sample
+ *
+ * Return: -1 if @store is NULL. 1 if the oldest sample was overwritten. 0
+ * otherwise.
+ */
+int store_append(store_t store, int16_t x, int16_t y, int16_t z, uint32_t t);
+
+/*
+ * store_append_bulk - Append a batch of samples
+ * @store: Store to append to
+ * @xyz: @n interleaved x/y/z triples, as read from a sensor burst
+ * @t: @n timestamps
+ * @n: Number of samples
+ *
+ * The batch is split into the axis arrays in at most two contiguous runs. If
+ * @n exceeds the capacity, only the newest samples are kept.
+ *
+ * Return: -1 if @store, @xyz or @t are NULL, or if @n is negative. Number of
+ * samples overwritten otherwise.
+ */
+int store_append_bulk(store_t store, const int16_t *xyz, const uint32_t *t,
+                      int n);
+
+/*
+ * store_view - Get a window over the most recent samples
+ * @store: Store to look into
+ * @n: Number of samples wanted, clamped to the store length
+ * @view: Receives the window
+ *
+ * Return: -1 if @store or @view are NULL, or if @n is negative. Number of
+ * samples in @view otherwise.
+ */
+int store_view(store_t store, int n, struct store_view *view);
+
+/*
+ * store_length - Store length
+ * @store: Store to get the length of
+ *
+ * Return: -1 if @store is NULL. Number of samples in @store otherwise.
+ */
+int store_length(store_t store);
+
+#endif /* _STORE_H */
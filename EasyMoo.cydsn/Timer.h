@@ -0,0 +1,195 @@
+/******************************************************************************
+* File Name: Timer.h
+*
+* Version: Beta
+*
+* Description: This file contains the low power timer the scheduler runs on
+* (see Sched.h): a millisecond time line and a wake up from deep sleep at any
+* millisecond on it, both on the multi-counter watchdog (MCWDT). The RTC only
+* keeps the time of day.
+*
+* Related Document: Technical Reference Manual, Watchdog Timer
+* Hardware Dependency: CY8CKIT-063-BLE PSoC 6 BLE Pioneer kit
+*
+* Author(s):
+*	Yousef H. Akbar & and Cow Team
+*	Dept. Electrical and Computer Engineering
+*	University of California, Davis
+*******************************************************************************
+* The MCWDT counts LFCLK, sourced from the 32.768 kHz WCO like the RTC, and
+* keeps counting in deep sleep. Its three counters are used as:
+*
+*  - Counter 0 clears every TIMER_PRESCALE cycles, so it ticks counter 1 at
+*    1024 Hz, just under a millisecond.
+*  - Counter 1 free runs at 1024 Hz. Its match interrupt is the wake up, set
+*    up to TIMER_MAX_SLEEP ahead; the 16-bit counter wraps after 64 s.
+*  - Counter 2 free runs at 32768 Hz on its own. timerNow() turns the count
+*    into milliseconds; the 32-bit counter wraps after 36 hours.
+*
+* A write to a counter register takes up to three LFCLK cycles to land,
+* TIMER_SYNC_US are waited after each.
+******************************************************************************/
+
+#ifndef TIMER_H
+#define TIMER_H
+
+#include "project.h"
+
+/* Macros */
+#define TIMER_HW            MCWDT_STRUCT0
+#define TIMER_IRQ           srss_interrupt_mcwdt_0_IRQn
+#define TIMER_MUX           NvicMux5_IRQn
+#define TIMER_LFCLK_HZ      (32768u)
+#define TIMER_PRESCALE      (32u)       // LFCLK cycles per counter 1 tick
+#define TIMER_TICK_HZ       (TIMER_LFCLK_HZ / TIMER_PRESCALE)
+#define TIMER_MAX_SLEEP     (60000u)    // ms, longer sleeps wake up once
+#define TIMER_SYNC_US       (93u)       // Three LFCLK cycles
+
+/* Set by the counter 1 match interrupt */
+volatile int timerFlag = 0;
+
+/* timerNow() time line: milliseconds, the counter 2 count it was last read
+   at and the LFCLK cycles not yet a whole millisecond, times 1000 */
+static uint32_t timerMs = 0u;
+static uint32_t timerLast = 0u;
+static uint32_t timerFrac = 0u;
+
+/******************************************************************************
+* Function Name: timerInterruptHandler
+*******************************************************************************
+*
+* Summary:
+*  This function clears the counter 1 match interrupt. Waking up is all it
+*  is for, the main loop reads the time again.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+******************************************************************************/
+void timerInterruptHandler(void)
+{
+    Cy_MCWDT_ClearInterrupt(TIMER_HW, CY_MCWDT_CTR1);
+    timerFlag = 1;
+}
+
+/******************************************************************************
+* Function Name: timerInit
+*******************************************************************************
+*
+* Summary:
+*  This function starts the MCWDT counters and the wake up interrupt. It must
+*  be called once, before timerNow().
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+******************************************************************************/
+void timerInit(void)
+{
+    const cy_stc_mcwdt_config_t config = {
+        .c0Match        = TIMER_PRESCALE - 1u,
+        .c1Match        = 0u,
+        .c0Mode         = CY_MCWDT_MODE_NONE,
+        .c1Mode         = CY_MCWDT_MODE_INT,
+        .c2ToggleBit    = 31u,
+        .c2Mode         = CY_MCWDT_MODE_NONE,
+        .c0ClearOnMatch = true,
+        .c1ClearOnMatch = false,
+        .c0c1Cascade    = true,
+        .c1c2Cascade    = false,
+    };
+    const cy_stc_sysint_t timerIrq = {
+        .intrSrc      = TIMER_MUX,
+        .cm0pSrc      = TIMER_IRQ,
+        .intrPriority = 3u,
+    };
+
+    if (Cy_MCWDT_Init(TIMER_HW, &config) != CY_MCWDT_SUCCESS)
+    {
+        /* If operation fails, halt */
+        CY_ASSERT(0u);
+    }
+    Cy_MCWDT_Enable(TIMER_HW, CY_MCWDT_CTR0 | CY_MCWDT_CTR1 | CY_MCWDT_CTR2,
+            TIMER_SYNC_US);
+
+    /* The first match is a whole counter 1 wrap away, until timerWakeAt() */
+    Cy_MCWDT_ClearInterrupt(TIMER_HW, CY_MCWDT_CTR1);
+    Cy_MCWDT_SetInterruptMask(TIMER_HW, CY_MCWDT_CTR1);
+    Cy_SysInt_Init(&timerIrq, timerInterruptHandler);
+    NVIC_EnableIRQ(TIMER_MUX);
+
+    /* The timerNow() time line starts now */
+    timerLast = Cy_MCWDT_GetCount(TIMER_HW, CY_MCWDT_COUNTER2);
+}
+
+/******************************************************************************
+* Function Name: timerNow
+*******************************************************************************
+*
+* Summary:
+*  This function returns the milliseconds since timerInit(). The time line
+*  wraps after 49 days, compare times by their difference. It must be called
+*  at least once every 36 hours.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  Milliseconds since timerInit()
+*
+******************************************************************************/
+uint32_t timerNow(void)
+{
+    uint32_t count = Cy_MCWDT_GetCount(TIMER_HW, CY_MCWDT_COUNTER2);
+    uint64_t cycles;
+
+    /* Carry the remainder, so the time line does not drift */
+    cycles = (uint64_t)(count - timerLast) * 1000u + timerFrac;
+    timerLast = count;
+    timerMs += (uint32_t)(cycles / TIMER_LFCLK_HZ);
+    timerFrac = (uint32_t)(cycles % TIMER_LFCLK_HZ);
+    return timerMs;
+}
+
+/******************************************************************************
+* Function Name: timerWakeAt
+*******************************************************************************
+*
+* Summary:
+*  This function sets the wake up for a timerNow() time. A time already
+*  passed sets it for the next counter 1 tick; one more than TIMER_MAX_SLEEP
+*  ahead wakes up TIMER_MAX_SLEEP from now. The wake up may come up to one
+*  tick early, the caller checks the time again.
+*
+* Parameters:
+*  ms: timerNow() time to wake up at
+*
+* Return:
+*  None
+*
+******************************************************************************/
+void timerWakeAt(uint32_t ms)
+{
+    uint32_t ahead = ms - timerNow();
+    uint32_t ticks, match;
+
+    if ((int32_t)ahead <= 0)
+        ahead = 1u;
+    if (ahead > TIMER_MAX_SLEEP)
+        ahead = TIMER_MAX_SLEEP;
+    ticks = (ahead * TIMER_TICK_HZ + 999u) / 1000u;
+
+    match = (Cy_MCWDT_GetCount(TIMER_HW, CY_MCWDT_COUNTER1) + ticks) & 0xFFFFu;
+    Cy_MCWDT_SetMatch(TIMER_HW, CY_MCWDT_COUNTER1, match, TIMER_SYNC_US);
+    timerFlag = 0;
+}
+
+#endif /* TIMER_H */
+
+/* [] END OF FILE */
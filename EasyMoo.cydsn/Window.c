@@ -0,0 +1,179 @@
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "Window.h"
+
+static int window_wrap(window_t win, int pos)
+{
+    return pos >= win->capacity ? pos - win->capacity : pos;
+}
+
+static int window_back(window_t win, int head, int size)
+{
+    return window_wrap(win, head + size - 1);
+}
+
+int window_init(window_t win, int *samples, struct window_entry *minq,
+                struct window_entry *maxq, int capacity)
+{
+    if (!win || !minq || !maxq)
+    {
+        return -1;
+    }
+    if (ring_init(&win->samples, samples, capacity, RING_REJECT) != 0)
+    {
+        return -1;
+    }
+
+    win->minq = minq;
+    win->maxq = maxq;
+    win->min_head = win->min_size = 0;
+    win->max_head = win->max_size = 0;
+    win->capacity = capacity;
+    win->seq = 0;
+    win->sum = 0;
+    return 0;
+}
+
+int window_push(window_t win, int value)
+{
+    int evicted = 0;
+    int old;
+    int pos;
+
+    if (!win)
+    {
+        return -1;
+    }
+
+    /* Evict the oldest sample, and drop it from the deques if it leads them */
+    if (ring_length(&win->samples) == win->capacity &&
+        ring_dequeue(&win->samples, &old) == 0)
+    {
+        uint32_t old_seq = win->seq - (uint32_t)win->capacity;
+
+        win->sum -= old;
+        if (win->min_size && win->minq[win->min_head].seq == old_seq)
+        {
+            win->min_head = window_wrap(win, win->min_head + 1);
+            win->min_size--;
+        }
+        if (win->max_size && win->maxq[win->max_head].seq == old_seq)
+        {
+            win->max_head = window_wrap(win, win->max_head + 1);
+            win->max_size--;
+        }
+        evicted = 1;
+    }
+
+    ring_enqueue(&win->samples, value);
+    win->sum += value;
+
+    /* Samples that can no longer be the minimum or maximum leave the deques */
+    while (win->min_size &&
+           win->minq[window_back(win, win->min_head, win->min_size)].value >= value)
+    {
+        win->min_size--;
+    }
+    pos = window_wrap(win, win->min_head + win->min_size);
+    win->minq[pos].value = value;
+    win->minq[pos].seq = win->seq;
+    win->min_size++;
+
+    while (win->max_size &&
+           win->maxq[window_back(win, win->max_head, win->max_size)].value <= value)
+    {
+        win->max_size--;
+    }
+    pos = window_wrap(win, win->max_head + win->max_size);
+    win->maxq[pos].value = value;
+    win->maxq[pos].seq = win->seq;
+    win->max_size++;
+
+    win->seq++;
+    return evicted;
+}
+
+int window_count(window_t win)
+{
+    return win ? ring_length(&win->samples) : -1;
+}
+
+int64_t window_sum(window_t win)
+{
+    return win ? win->sum : 0;
+}
+
+int window_mean(window_t win, int *mean)
+{
+    int count = window_count(win);
+
+    if (!mean || count <= 0)
+    {
+        return -1;
+    }
+    *mean = (int)(win->sum / count);
+    return 0;
+}
+
+int window_min(window_t win, int *min)
+{
+    if (!win || !min || win->min_size == 0)
+    {
+        return -1;
+    }
+    *min = win->minq[win->min_head].value;
+    return 0;
+}
+
+int window_max(window_t win, int *max)
+{
+    if (!win || !max || win->max_size == 0)
+    {
+        return -1;
+    }
+    *max = win->maxq[win->max_head].value;
+    return 0;
+}
+
+int window_seed(window_t win, int count, int mean, int min, int max)
+{
+    int64_t rest;
+    int64_t fill;
+    int extra;
+    int i;
+
+    if (!win || ring_length(&win->samples) != 0 || count < 0 ||
+        count > win->capacity || min > mean || mean > max)
+    {
+        return -1;
+    }
+    if (count == 0)
+    {
+        return 0;
+    }
+    if (count == 1)
+    {
+        return window_push(win, mean) < 0 ? -1 : 0;
+    }
+
+    /* The extremes, then what is left of the sum spread over the others */
+    window_push(win, min);
+    window_push(win, max);
+    rest = (int64_t)mean * count - min - max;
+    if (count == 2)
+    {
+        return 0;
+    }
+    fill = rest / (count - 2);
+    if (fill * (count - 2) > rest)
+    {
+        fill--;
+    }
+    extra = (int)(rest - fill * (count - 2));
+    for (i = 0; i < count - 2; i++)
+    {
+        window_push(win, (int)fill + (i < extra));
+    }
+    return 0;
+}
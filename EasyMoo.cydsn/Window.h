@@ -0,0 +1,138 @@
+#ifndef _WINDOW_H
+#define _WINDOW_H
+
+#include <stdint.h>
+
+#include "Ring.h"
+
+/*
+ * window_t - Sliding window statistics type
+ *
+ * A window keeps the sum, count, minimum and maximum of the last N samples
+ * pushed into it. Pushing a sample evicts the oldest one once N samples are
+ * held. The statistics are updated as samples come and go, so reading them
+ * never walks the window.
+ *
+ * The minimum and maximum are tracked with monotonic deques: each deque only
+ * keeps the samples that can still become the extremum before they are
+ * evicted. Every sample enters and leaves each deque at most once, so a push
+ * is amortized O(1) no matter how large N is.
+ *
+ * All storage is supplied by the caller, eg for a 720 sample window:
+ *
+ *	static int samples[720];
+ *	static struct window_entry minq[720], maxq[720];
+ *	static struct window win;
+ *	window_init(&win, samples, minq, maxq, 720);
+ */
+typedef struct window* window_t;
+
+struct window_entry
+{
+    int value;
+    uint32_t seq;
+};
+
+struct window
+{
+    struct ring samples;
+    struct window_entry *minq;
+    struct window_entry *maxq;
+    int min_head, min_size;
+    int max_head, max_size;
+    int capacity;
+    uint32_t seq;
+    int64_t sum;
+};
+
+/*
+ * window_init - Initialize an empty window
+ * @win: Window to initialize
+ * @samples: Storage for @capacity samples
+ * @minq: Storage for @capacity minimum deque entries
+ * @maxq: Storage for @capacity maximum deque entries
+ * @capacity: Number of samples the window spans
+ *
+ * Return: -1 if any pointer is NULL or if @capacity is not positive. 0 if
+ * @win was successfully initialized.
+ */
+int window_init(window_t win, int *samples, struct window_entry *minq,
+                struct window_entry *maxq, int capacity);
+
+/*
+ * window_push - Add a sample to the window
+ * @win: Window to push into
+ * @value: Sample value
+ *
+ * If the window is full, the oldest sample is evicted first.
+ *
+ * Return: -1 if @win is NULL. 1 if a sample was evicted. 0 otherwise.
+ */
+int window_push(window_t win, int value);
+
+/*
+ * window_count - Number of samples in the window
+ * @win: Window to query
+ *
+ * Return: -1 if @win is NULL. Number of samples in @win otherwise.
+ */
+int window_count(window_t win);
+
+/*
+ * window_sum - Sum of the samples in the window
+ * @win: Window to query
+ *
+ * Return: 0 if @win is NULL or empty. Sum of the samples otherwise.
+ */
+int64_t window_sum(window_t win);
+
+/*
+ * window_mean - Mean of the samples in the window
+ * @win: Window to query
+ * @mean: Address where the mean, truncated toward zero, is received
+ *
+ * Return: -1 if @win or @mean are NULL, or if @win is empty. 0 if @mean was
+ * set.
+ */
+int window_mean(window_t win, int *mean);
+
+/*
+ * window_min - Smallest sample in the window
+ * @win: Window to query
+ * @min: Address where the minimum is received
+ *
+ * Return: -1 if @win or @min are NULL, or if @win is empty. 0 if @min was
+ * set.
+ */
+int window_min(window_t win, int *min);
+
+/*
+ * window_max - Largest sample in the window
+ * @win: Window to query
+ * @max: Address where the maximum is received
+ *
+ * Return: -1 if @win or @max are NULL, or if @win is empty. 0 if @max was
+ * set.
+ */
+int window_max(window_t win, int *max);
+
+/*
+ * window_seed - Refill an empty window from its statistics
+ * @win: Window to refill, empty
+ * @count: Number of samples it held
+ * @mean: Their mean
+ * @min: Their minimum
+ * @max: Their maximum
+ *
+ * For a window whose samples were lost but whose statistics were kept. The
+ * samples pushed have the count, minimum and maximum given and a sum of
+ * @count times @mean (two samples can only be the minimum and maximum), so
+ * the window reads the same and then moves on as new samples evict the made
+ * up ones.
+ *
+ * Return: -1 if @win is NULL or not empty, if @count is negative or over
+ * the capacity or if @mean is not between @min and @max. 0 otherwise.
+ */
+int window_seed(window_t win, int count, int mean, int min, int max);
+
+#endif /* _WINDOW_H */
@@ -1,28 +1,28 @@
-/* ========================================
- *
- * Copyright YOUR COMPANY, THE YEAR
- * All Rights Reserved
- * UNPUBLISHED, LICENSED SOFTWARE.
- *
- * CONFIDENTIAL AND PROPRIETARY INFORMATION
- * WHICH IS THE PROPERTY OF your company.
- *
- * ========================================
-*/
-#ifndef CYAPICALLBACKS_H
-#define CYAPICALLBACKS_H
-    
-
-#if CY_CPU_CORTEX_M0P
-    /*Define your Cortex-M0P macro callbacks here */
-#endif
-
-#if CY_CPU_CORTEX_M4
-    /*Define your Cortex-M4 macro callbacks here */
-#endif
-
-    /*For more information, refer to the Writing Code topic in the PSoC Creator Help.*/
-
-    
-#endif /* CYAPICALLBACKS_H */   
-/* [] */
+/* ========================================
+ *
+ * Copyright YOUR COMPANY, THE YEAR
+ * All Rights Reserved
+ * UNPUBLISHED, LICENSED SOFTWARE.
+ *
+ * CONFIDENTIAL AND PROPRIETARY INFORMATION
+ * WHICH IS THE PROPERTY OF your company.
+ *
+ * ========================================
+*/
+#ifndef CYAPICALLBACKS_H
+#define CYAPICALLBACKS_H
+    
+
+#if CY_CPU_CORTEX_M0P
+    /*Define your Cortex-M0P macro callbacks here */
+#endif
+
+#if CY_CPU_CORTEX_M4
+    /*Define your Cortex-M4 macro callbacks here */
+#endif
+
+    /*For more information, refer to the Writing Code topic in the PSoC Creator Help.*/
+
+    
+#endif /* CYAPICALLBACKS_H */   
+/* [] */
@@ -1,151 +1,434 @@
-/******************************************************************************
-* File Name: main_cm0p.c
-*
-* Version: Beta
-*
-* Description: This is the main firmware file for the EasyMoo capstone project.
-* This PSoC project is for a cow physical health monitor product, utilizing SoC
-* circuitry, including sensors and a battery powered module.
-*
-* Related Document: TrueColor_LightSensor.pdf
-* Hardware Dependency:  CY8CKIT-063-BLE PSoC 6 BLE Pioneer kit
-*                       AS73211 True Color Sensor
-*
-* Author(s):
-*	Yousef H. Akbar & and Cow Team
-*	Dept. Electrical and Computer Engineering
-*	University of California, Davis
-******************************************************************************/
-
-#include "project.h"
-#include "stdio.h"
-
-/* Project Firmware Dependencies */
-#include "FSM.h"
-
-#include "Light.h"
-#include "Accelerometer.h"
-#include "RTC_Alarm.h"
-#include "Queue.h"
-
-/* Happy Score Benchmarks */
-#define TARG_LIGHT_AVG  (200)
-#define TARG_TEMP_AVG   (25)
-
-/* Global Variables */
-uint16_t xChannel, yChannel, zChannel, temperature;	// Light Sensor Vars
-uint16_t accX, accY, accZ;				// Accelerometer
-uint16_t gyroX, gyroY, gyroZ;				// Gyroscope
-int tempFlag    = 0;
-int accInactive = 0;
-int lightFlag   = 0;
-queue_t light_queue = NULL;
-queue_t temp_queue  = NULL;
-queue_t acc_queue   = NULL;
-queue_t gyro_queue  = NULL;
-int data_count = 0;
-
-#include "BLE.h"
-
-int update_happy_score(void)
-{
-    int avg_light_score = 0;
-    int avg_temp_score  = 0;
-    int count           = queue_length(light_queue);
-    int tmp             = 0;
-    
-    for (int i = 0; i < count; i++) {
-        queue_dequeue(light_queue, &tmp);
-        avg_light_score += tmp;
-        queue_enqueue(light_queue, tmp);
-        
-        queue_dequeue(temp_queue, &tmp);
-        avg_temp_score += tmp;
-        queue_enqueue(temp_queue, tmp);
-    }
-    
-    avg_light_score = avg_light_score / count;
-    avg_temp_score  = avg_temp_score / count;
-    
-    float happy_light_score = (float)avg_light_score / TARG_LIGHT_AVG * 100.0;
-    if (happy_light_score > 100.0)
-	    happy_light_score = 100.0;
-
-    float happy_temp_score = (float)avg_temp_score / TARG_TEMP_AVG * 100.0;
-    if (happy_temp_score > 100.0)
-	    happy_temp_score = 100.0;
-    
-    return (happy_light_score + happy_temp_score) / 2.0; //temp
-}
-
-int main(void)
-{
-    __enable_irq(); /* Enable global interrupts. */
-    Cy_SysEnableCM4(CY_CORTEX_M4_APPL_ADDR);
-
-    /* UART Initialization */
-    UART_Start();
-    setvbuf(stdin,NULL,_IONBF,0);
-    
-    /* initiate I2C */
-    I2C_Start();
-    
-    CyDelay(5000);
-    
-    init_RTC();
-    
-    light_queue = queue_create();
-    temp_queue  = queue_create();
-    acc_queue   = queue_create();
-    gyro_queue  = queue_create();
-    int *lightdata;
-    int happy_score;
-    FSM fsm;
-    
-    for(;;)
-    {
-        lightMeasure(&xChannel, &yChannel, &zChannel, &temperature);
-        lightPrint(xChannel, yChannel, zChannel);
-        light_process_data(xChannel, yChannel, zChannel, temp_queue, light_queue);
-        printf("Current FIFO Queue Sizes: %d\r\n", light_queue->size);
-        data_count++;
-        
-        accMeasure(&accX, &accY, &accZ, xChannel+yChannel+zChannel);
-        accPrint(accX, accY, accZ);
-        
-        //gyroMeasure(&gyroX, &gyroY, &gyroZ, xChannel+yChannel+zChannel);
-        //gyroPrint(gyroX, gyroY, gyroZ);
-        
-        CyDelay(500);
-        
-        /* If the alarm flag is set, clear it, toggle the LED, and step */
-        if(alarmFlag)  /* the flag is set, meaning time has expired */
-        {
-			/* We have handled this alarm */
-			alarmFlag = 0u;	
-            
-            /* Configure the next RTC alarm, add the interval to the time
-               for the next alarm */
-            RtcStepAlarm();
-        }
-
-        happy_score = update_happy_score();
-        printf("\r\nHappy Score: %d\r\n", happy_score);
-        if (light_queue->size > 23) {
-            int tmp = 0;
-            queue_dequeue(light_queue, &tmp);
-            queue_dequeue(temp_queue, &tmp);
-            printf("readjusted queue sizes\r\n");
-        }
-        
-        //updateFSM(&fsm, accInactive, lightFlag, tempFlag);
-        if (data_count % 15 == 0)
-            broadcastBLE(happy_score);
-            
-        CyDelay(500);
-        
-        
-        /* Go to Deep Sleep mode until next interrupt  */
-        Cy_SysPm_DeepSleep(CY_SYSPM_WAIT_FOR_INTERRUPT);
-    }
-}
+/******************************************************************************
+* File Name: main_cm0p.c
+*
+* Version: Beta
+*
+* Description: This is the main firmware file for the EasyMoo capstone project.
+* This PSoC project is for a cow physical health monitor product, utilizing SoC
+* circuitry, including sensors and a battery powered module.
+*
+* Related Document: TrueColor_LightSensor.pdf
+* Hardware Dependency:  CY8CKIT-063-BLE PSoC 6 BLE Pioneer kit
+*                       AS73211 True Color Sensor
+*
+* Author(s):
+*	Yousef H. Akbar & and Cow Team
+*	Dept. Electrical and Computer Engineering
+*	University of California, Davis
+******************************************************************************/
+
+#include "project.h"
+#include "stdio.h"
+
+/* Project Firmware Dependencies */
+#include "FSM.h"
+
+#include "Light.h"
+#include "Accelerometer.h"
+#include "RTC_Alarm.h"
+#include "CoreLink.h"
+#include "Settings.h"
+#include "Sched.h"
+#include "Timer.h"
+#include "Hibernate.h"
+
+/* Global Variables */
+uint16_t xChannel, yChannel, zChannel, temperature;	// Light Sensor Vars
+uint8_t lightExposure = LIGHT_EXP_DEFAULT;		// Light Sensor Range
+int16_t accX, accY, accZ;				// Accelerometer
+int16_t gyroX, gyroY, gyroZ;				// Gyroscope
+int tempFlag    = 0;
+int accInactive = 0;
+int lightFlag   = 0;
+int provisionalFlag = 0;				// Behaviour from a placeholder model
+int data_count = 0;
+uint32_t lastMotion = 0;				// RTC seconds of the last motion
+
+#include "BLE.h"
+
+/* Scheduler tasks, in the order they are added. Periods and deadlines are
+   in timerNow() milliseconds; the light, accelerometer and report periods
+   are runtime settings (see Config.h) */
+enum TASKS{TASK_ACCEL, TASK_FIFO, TASK_LIGHT, TASK_LIGHT_READ, TASK_RESULTS,
+           TASK_REPORT, TASK_FLUSH, TASK_HIBERNATE, NUM_TASKS};
+#define TASK_FLUSH_PERIOD   (60000u)    // Backstop, BLE commands wake it
+#define TASK_DEADLINE       (50u)       // Sensor tasks, late past this
+#define REPORT_DEADLINE     (5000u)
+#define RESULTS_DELAY       (200u)      // CM4 processing time of a sample
+
+static struct sched_task taskBuf[NUM_TASKS];
+static struct sched sched;
+
+int happy_score = 0;
+struct moo_result result = { .behaviour = -1 };
+FSM fsm;
+
+/* Function Name: fifoTask
+ *
+ * Summary:
+ * This function moves the motion records batched in the accelerometer FIFO
+ * over to the CM4. It runs every ACC_FIFO_PERIOD, before the FIFO fills up,
+ * and is stopped while the cow lies still.
+ */
+void fifoTask(void *arg)
+{
+    static struct moo_motion motion[ACC_FIFO_BURST];
+    int motion_count;
+    
+    (void)arg;
+    
+    while ((motion_count = accFifoDrain(motion, ACC_FIFO_BURST)) > 0)
+        coreLinkPushMotion(motion, motion_count);
+}
+
+/* Function Name: accelTask
+ *
+ * Summary:
+ * This function services INT1, shared by wake on motion and the FIFO
+ * overflow, switches batching on and off with the motion, and takes one
+ * reading for the next sample. INT1 is checked by its level on every run,
+ * it only interrupts in the low power mode, where it wakes this task early.
+ */
+void accelTask(void *arg)
+{
+    int accStatus;
+    
+    (void)arg;
+    
+    if (accIntFlag || Cy_GPIO_Read(ACC_INT_PORT, ACC_INT_PIN))
+    {
+        accIntFlag = 0;
+        accStatus = accIntStatus();
+        if (accStatus & ACC_INT_WOM)
+        {
+            lastMotion = RtcSeconds();
+            if (accInactive)
+            {
+                /* Moving again, restart batching */
+                accInactive = 0;
+                accSetLowPower(0);
+                sched_start(&sched, TASK_FIFO, timerNow() + ACC_FIFO_PERIOD);
+            }
+        }
+        
+        /* The full FIFO kept its records, move them over before dropping
+           the partial record it ends on */
+        if (accStatus & ACC_INT_OVERFLOW)
+        {
+            printf("Accelerometer FIFO overflow.\r\n");
+            fifoTask(NULL);
+            accFifoReset();
+        }
+    }
+    
+    /* No motion interrupt for CONFIG_INACTIVE seconds: the cow is lying
+       still. Only wake on motion is left running on the sensor, once the
+       records batched so far are moved over */
+    if (!accInactive && RtcElapsed(lastMotion) >=
+            (uint32_t)settings.value[CONFIG_INACTIVE])
+    {
+        fifoTask(NULL);
+        sched_stop(&sched, TASK_FIFO);
+        accInactive = 1;
+        accSetLowPower(1);
+    }
+    
+    if (!accInactive)
+    {
+        accMeasure(&accX, &accY, &accZ, &gyroX, &gyroY, &gyroZ);
+        accPrint(accX, accY, accZ);
+        gyroPrint(gyroX, gyroY, gyroZ);
+    }
+}
+
+/* Function Name: lightTask
+ *
+ * Summary:
+ * This function starts a light measurement. The CPU sleeps until READY wakes
+ * lightReadTask() up, which also runs on its own once READY is overdue.
+ */
+void lightTask(void *arg)
+{
+    (void)arg;
+    
+    lightArm();
+    sched_start(&sched, TASK_LIGHT_READ, timerNow() + lightReadyTimeout());
+}
+
+/* Function Name: lightReadTask
+ *
+ * Summary:
+ * This function reads the light sensor and hands one sample, with the last
+ * motion reading, over to the CM4 for processing. Results are collected
+ * RESULTS_DELAY after it. If READY was missed there is no sample this period.
+ */
+void lightReadTask(void *arg)
+{
+    struct moo_sample sample;
+    
+    (void)arg;
+    
+    if (lightCollect(&xChannel, &yChannel, &zChannel, &temperature,
+            &lightExposure) != 0)
+        return;
+    lightPrint(xChannel, yChannel, zChannel);
+    data_count++;
+    
+    /* Processing runs on the CM4, we only hand the sample over */
+    sample = (struct moo_sample){ data_count,
+        light_range_normalize(lightExposure, xChannel),
+        light_range_normalize(lightExposure, yChannel),
+        light_range_normalize(lightExposure, zChannel),
+        temperature, accX, accY, accZ, gyroX, gyroY, gyroZ,
+        lightExposure, RtcSeconds(), accInactive };
+    if (coreLinkPushSample(&sample) != 0)
+        printf("Failed to hand sample to CM4.\r\n");
+    sched_start(&sched, TASK_RESULTS, timerNow() + RESULTS_DELAY);
+}
+
+/* Function Name: resultsTask
+ *
+ * Summary:
+ * This function collects whatever the CM4 has finished processing, the
+ * happy score among it, and steps the state machine.
+ */
+void resultsTask(void *arg)
+{
+    (void)arg;
+    
+    while (coreLinkPopResult(&result) == 0)
+    {
+        happy_score = result.happy_score;
+        lightFlag   = result.lightFlag;
+        tempFlag    = result.tempFlag;
+        provisionalFlag = result.provisional;
+        bleAdvUpdate(&result);
+        printf("\r\nHappy Score: %d\r\n", happy_score);
+        printf("Current Window Sizes: %d\r\n", (int)result.window_count);
+        printf("Light Range: %d - %d\r\n", (int)result.light_min,
+               (int)result.light_max);
+        printf("Activity: ODBA %d, Jerk %d, Crossings %d\r\n",
+               (int)result.odba, (int)result.jerk, (int)result.zc);
+        printf("Behaviour: %d%s\r\n", (int)result.behaviour,
+               result.provisional ? " (provisional)" : "");
+        printf("Gait: stride %d cHz, regularity %d%%, harmonic ratio "
+               "%d/256\r\n", (int)result.stride_freq,
+               (int)result.regularity, (int)result.harmonic_ratio);
+        printf("Posture: %d, head down %d deg\r\n", (int)result.posture,
+               (int)result.head_down);
+        if (result.budget_hour >= 0)
+            printf("Hour %d budget (s): grazing %d, ruminating %d, "
+                   "lying %d, walking %d\r\n", (int)result.budget_hour,
+                   result.budget[BEHAVIOUR_GRAZING],
+                   result.budget[BEHAVIOUR_RUMINATING],
+                   result.budget[BEHAVIOUR_LYING],
+                   result.budget[BEHAVIOUR_WALKING]);
+    }
+    
+    updateFSM(&fsm, accInactive, lightFlag, tempFlag);
+}
+
+/* Function Name: reportTask
+ *
+ * Summary:
+ * This function records the latest result in the history and queues a
+ * report for BLE.
+ */
+void reportTask(void *arg)
+{
+    (void)arg;
+    
+    bleAddHistory(&result);
+    broadcastBLE(happy_score);
+}
+
+/* Function Name: taskPeriods
+ *
+ * Summary:
+ * This function sets the periods that are runtime settings, the report
+ * one being a number of light periods.
+ */
+void taskPeriods(void)
+{
+    uint32_t tick = (uint32_t)settings.value[CONFIG_TICK];
+    
+    sched_set_period(&sched, TASK_ACCEL,
+            (uint32_t)settings.value[CONFIG_ACC_TICK]);
+    sched_set_period(&sched, TASK_LIGHT, tick);
+    sched_set_period(&sched, TASK_RESULTS, tick);
+    sched_set_period(&sched, TASK_REPORT,
+            tick * (uint32_t)settings.value[CONFIG_REPORT_EVERY]);
+    sched_set_period(&sched, TASK_HIBERNATE, tick);
+}
+
+/* Function Name: flushTask
+ *
+ * Summary:
+ * This function saves and applies settings changed over BLE, the task
+ * periods among them.
+ */
+void flushTask(void *arg)
+{
+    (void)arg;
+    
+    settingsCommit();
+    taskPeriods();
+}
+
+/* Function Name: hibernateTask
+ *
+ * Summary:
+ * This function hibernates for CONFIG_HIBERNATE seconds at a time while the
+ * cow lies still in the dark: no motion for CONFIG_INACTIVE seconds, every
+ * sample in the light window below CONFIG_LIGHT_CUTOFF. Nothing must be
+ * left half done: no central connected, the settings saved, and every
+ * sample processed by the CM4, whose state comes back with its result.
+ */
+void hibernateTask(void *arg)
+{
+    uint32_t seconds = (uint32_t)settings.value[CONFIG_HIBERNATE];
+    struct snapshot snap;
+    
+    (void)arg;
+    
+    if (seconds == 0u || !accInactive ||
+            result.light_max >= settings.value[CONFIG_LIGHT_CUTOFF] ||
+            result.seq != (uint32_t)data_count || !coreLinkIdle() ||
+            bleConnected || settingsDirty || settingsPending)
+        return;
+    
+    snap = (struct snapshot){ RtcSeconds(), (uint32_t)data_count,
+        history_next_seq(&bleHistory), lastMotion, (int16_t)happy_score,
+        (uint8_t)fsm.curr->id, (uint8_t)accInactive, result.state };
+    printf("Hibernating for %u s.\r\n", (unsigned)seconds);
+    
+    lightStop();
+    if (hibernateEnter(&snap, seconds) != 0)
+    {
+        printf("Failed to hibernate.\r\n");
+        lightInit();
+    }
+}
+
+/* Function Name: resumeState
+ *
+ * Summary:
+ * This function carries the CM0+ side on from a hibernate snapshot: the
+ * sample and history numbering, the inactivity timer and the state machine.
+ */
+void resumeState(const struct snapshot *snap)
+{
+    data_count  = (int)snap->sample_seq;
+    happy_score = snap->happy_score;
+    accInactive = snap->inactive;
+    lastMotion  = snap->last_motion;
+    bleHistoryResume(snap->history_seq);
+    if (snap->state < NUM_STATES)
+        setCurrState(&fsm, snap->state);
+}
+
+int main(void)
+{
+    struct snapshot snap;
+    uint32_t now, wake;
+    uint32_t intr;
+    int resumed;
+    
+    __enable_irq(); /* Enable global interrupts. */
+    
+    /* A wake up from hibernate carries on from its snapshot */
+    resumed = hibernateResume(&snap) == 0;
+    Cy_SysEnableCM4(CY_CORTEX_M4_APPL_ADDR);
+
+    /* UART Initialization */
+    UART_Start();
+    setvbuf(stdin,NULL,_IONBF,0);
+    
+    /* initiate I2C and the interrupt driven transfer engine */
+    I2C_Start();
+    i2cAsyncInit();
+    
+    /* The accelerometer kept power and configuration through hibernate, and
+       the RTC kept the time. The light sensor was powered down by lightStop()
+       and is set up again by lightInit() below */
+    if (!resumed)
+        CyDelay(5000);
+    
+    /* light sensor converts continuously from here on */
+    lightInit();
+    if (resumed)
+    {
+        accResume();
+        RtcResume();
+    }
+    else
+    {
+        accInit();
+        init_RTC();
+    }
+    timerInit();
+    
+    /* Hand the sample/result rings over to the CM4 */
+    coreLinkInit(resumed ? &snap : NULL);
+    
+    /* Saved settings retune the periods, reporting and thresholds */
+    settingsLoad();
+    
+    /* The BLE stack stays on from here, reports are only queued */
+    bleInit();
+    
+    /* Inactivity is timed from start up until the first motion */
+    lastMotion = RtcSeconds();
+    
+    initFSM(&fsm);
+    if (resumed)
+        resumeState(&snap);
+    
+    /* Results are collected shortly after the sample, once the CM4 is done
+       with it */
+    now = timerNow();
+    sched_init(&sched, taskBuf, NUM_TASKS);
+    sched_add(&sched, accelTask, NULL, 1u, TASK_DEADLINE, now);
+    sched_add(&sched, fifoTask, NULL, ACC_FIFO_PERIOD, TASK_DEADLINE,
+            now + ACC_FIFO_PERIOD);
+    sched_add(&sched, lightTask, NULL, 1u, TASK_DEADLINE, now);
+    sched_add(&sched, lightReadTask, NULL, 0u, TASK_DEADLINE, 0u);
+    sched_stop(&sched, TASK_LIGHT_READ);
+    sched_add(&sched, resultsTask, NULL, 1u, TASK_DEADLINE,
+            now + RESULTS_DELAY);
+    sched_add(&sched, reportTask, NULL, 1u, REPORT_DEADLINE,
+            now + RESULTS_DELAY);
+    sched_add(&sched, flushTask, NULL, TASK_FLUSH_PERIOD, TASK_FLUSH_PERIOD,
+            now + TASK_FLUSH_PERIOD);
+    sched_add(&sched, hibernateTask, NULL, 1u, TASK_FLUSH_PERIOD,
+            now + RESULTS_DELAY);
+    taskPeriods();
+    if (accInactive)
+        sched_stop(&sched, TASK_FIFO);
+    
+    for(;;)
+    {
+        /* INT1 has the accelerometer serviced right away, READY the light
+           sensor read, and settings changed over BLE are saved right away */
+        now = timerNow();
+        if (accIntFlag)
+            sched_wake(&sched, TASK_ACCEL, now);
+        if (lightReadyFlag)
+            sched_wake(&sched, TASK_LIGHT_READ, now);
+        if (settingsDirty || settingsPending)
+            sched_wake(&sched, TASK_FLUSH, now);
+        sched_run(&sched, now);
+        
+        /* Go to Deep Sleep mode until the next task is due, or an
+           interrupt. Masked, so an interrupt after the checks still wakes */
+        intr = Cy_SysLib_EnterCriticalSection();
+        sched_next(&sched, &wake);
+        if (!accIntFlag && !lightReadyFlag && !settingsDirty &&
+            (int32_t)(wake - timerNow()) > 0)
+        {
+            timerWakeAt(wake);
+            Cy_SysPm_DeepSleep(CY_SYSPM_WAIT_FOR_INTERRUPT);
+        }
+        Cy_SysLib_ExitCriticalSection(intr);
+    }
+}
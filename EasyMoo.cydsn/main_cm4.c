@@ -1,28 +1,73 @@
-/* ========================================
- *
- * Copyright YOUR COMPANY, THE YEAR
- * All Rights Reserved
- * UNPUBLISHED, LICENSED SOFTWARE.
- *
- * CONFIDENTIAL AND PROPRIETARY INFORMATION
- * WHICH IS THE PROPERTY OF your company.
- *
- * ========================================
-*/
-#include "project.h"
-
-int main(void)
-{
-    __enable_irq(); /* Enable global interrupts. */
-
-    /* Place your initialization/startup code here (e.g. MyInst_Start()) */
-    
-    Cy_SysPm_CpuEnterSleep(CY_SYSPM_WAIT_FOR_INTERRUPT);
-
-    for(;;)
-    {
-        /* Place your application code here. */
-    }
-}
-
-/* [] END OF FILE */
+/* ========================================
+ *
+ * Copyright YOUR COMPANY, THE YEAR
+ * All Rights Reserved
+ * UNPUBLISHED, LICENSED SOFTWARE.
+ *
+ * CONFIDENTIAL AND PROPRIETARY INFORMATION
+ * WHICH IS THE PROPERTY OF your company.
+ *
+ * ========================================
+*/
+#include "project.h"
+
+/* Project Firmware Dependencies */
+#include "CoreLink.h"
+#include "Process.h"
+
+int main(void)
+{
+    struct core_link *link;
+    struct moo_sample sample;
+    struct moo_result result;
+    static struct moo_motion motion[MOTION_BATCH];
+    int n;
+
+    __enable_irq(); /* Enable global interrupts. */
+
+    /* Wait for the CM0+ to publish the sample/result rings */
+    link = coreLinkAttach();
+    processInit();
+    
+    /* Woken up from hibernate, carry on where the CM0+ snapshot left off */
+    if (link->resumed)
+        processRestore(&link->resume);
+
+    for(;;)
+    {
+        /* Settings changed on the CM0+ apply from the next sample on */
+        while (spsc_pop(&link->config, &settings) == 0)
+            ;
+
+        /* Process everything the CM0+ has acquired since the last wake up.
+           A sample only leaves its ring once its result is in, so a full
+           result ring holds samples back rather than losing results */
+        while (spsc_length(&link->results) < CORE_LINK_RESULTS &&
+               spsc_peek(&link->samples, &sample) == 0)
+        {
+            process_sample(&sample, &result);
+            spsc_push(&link->results, &result);
+            spsc_pop(&link->samples, NULL);
+        }
+
+        /* Batched accelerometer/gyroscope records go to the motion stores */
+        do
+        {
+            for (n = 0; n < MOTION_BATCH; n++)
+                if (spsc_pop(&link->motion, &motion[n]) != 0)
+                    break;
+            motion_process_batch(motion, n);
+        } while (n == MOTION_BATCH);
+
+        /* Sleep until the next push, or until the CM0+ makes room for
+           results; masked so a late notify still wakes */
+        uint32_t intr = Cy_SysLib_EnterCriticalSection();
+        if ((spsc_length(&link->samples) == 0 ||
+             spsc_length(&link->results) == CORE_LINK_RESULTS) &&
+            spsc_length(&link->motion) == 0)
+            Cy_SysPm_CpuEnterDeepSleep(CY_SYSPM_WAIT_FOR_INTERRUPT);
+        Cy_SysLib_ExitCriticalSection(intr);
+    }
+}
+
+/* [] END OF FILE */
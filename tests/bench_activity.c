@@ -0,0 +1,66 @@
+/*
+ * Activity feature benchmark
+ *
+ * Host time and cycles of a push, and of a push followed by reading the
+ * features, for the Process.h window and the largest one. A push is O(1),
+ * so the cost must not grow with the window. The cycles are those of the
+ * host core, counted by test_cycles() at the clock printed, not of the
+ * CM4: they compare the two lengths, not the host with the target.
+ */
+
+#include "test.h"
+
+#include "Activity.h"
+
+#define PUSHES      (5000000)
+
+static struct activity_entry buf[ACTIVITY_MAX_LEN];
+
+int main(void)
+{
+    static const int lengths[] = { 128, ACTIVITY_MAX_LEN };
+    struct activity f;
+    struct activity_set set;
+    uint32_t seed = 1u, r;
+    uint64_t check = 0;
+    uint64_t c, push_cycles, get_cycles;
+    double t, push_ns, get_ns;
+    int i, k;
+
+    for (k = 0; k < (int)(sizeof(lengths) / sizeof(lengths[0])); k++)
+    {
+        activity_init(&f, buf, lengths[k], 40);
+
+        t = test_now();
+        c = test_cycles();
+        for (i = 0; i < PUSHES; i++)
+        {
+            r = test_rand(&seed);
+            activity_push(&f, (int16_t)r, (int16_t)(r >> 8),
+                          (int16_t)(r >> 16));
+        }
+        push_cycles = (test_cycles() - c) / PUSHES;
+        push_ns = (test_now() - t) / PUSHES * 1e9;
+
+        t = test_now();
+        c = test_cycles();
+        for (i = 0; i < PUSHES; i++)
+        {
+            r = test_rand(&seed);
+            activity_push(&f, (int16_t)r, (int16_t)(r >> 8),
+                          (int16_t)(r >> 16));
+            activity_get(&f, &set);
+            check += set.odba + set.var[0];
+        }
+        get_cycles = (test_cycles() - c) / PUSHES;
+        get_ns = (test_now() - t) / PUSHES * 1e9;
+
+        printf("activity %4d: %5.1f ns, %3u cycles per push; %5.1f ns, %3u "
+               "cycles with the features\n", lengths[k], push_ns,
+               (unsigned)push_cycles, get_ns, (unsigned)get_cycles);
+    }
+    printf("activity: host cycles at %.2f GHz\n", push_cycles / push_ns);
+
+    /* Keeps the loops from being optimized away */
+    return check == 0;
+}
@@ -0,0 +1,118 @@
+/*
+ * Classifier benchmark
+ *
+ * The cost of an inference is bounded by the model: at most
+ * CLASSIFIER_MAX_DEPTH comparisons in each of the CLASSIFIER_TREES trees.
+ * The benchmark checks that the generated tables keep to that bound, then
+ * times inferences on random feature vectors and on the feature vectors
+ * of activity windows, as Process.h runs them. The cycles are those of the
+ * host core at the clock printed (test_cycles()), not of the CM4.
+ */
+
+#include "test.h"
+
+#include "Activity.h"
+#include "Classifier.h"
+#include "ClassifierModel.h"
+
+#define CALLS       (2000000)
+#define NODES       ((int)(sizeof(classifier_nodes) / \
+                           sizeof(classifier_nodes[0])))
+
+/* Comparisons on the deepest path below @node, -1 if the tree is broken */
+static int tree_depth(int node, int limit)
+{
+    const struct classifier_node *n = &classifier_nodes[node];
+    int left, right;
+
+    if (n->feature < 0)
+    {
+        return n->left < BEHAVIOUR_COUNT ? 0 : -1;
+    }
+    if (limit == 0 || n->feature >= CLASSIFIER_FEATURES ||
+        n->left >= NODES || n->right >= NODES)
+    {
+        return -1;
+    }
+    left = tree_depth(n->left, limit - 1);
+    right = tree_depth(n->right, limit - 1);
+    if (left < 0 || right < 0)
+    {
+        return -1;
+    }
+    return 1 + (left > right ? left : right);
+}
+
+int main(void)
+{
+    static int32_t features[1024][CLASSIFIER_FEATURES];
+    static struct activity_entry buf[128];
+    struct activity f;
+    struct activity_set set;
+    uint32_t seed = 14u, r;
+    int64_t check = 0;
+    uint64_t c, random_cycles, window_cycles;
+    double t, random_ns, window_ns;
+    int i, k, depth, comparisons = 0;
+
+    for (i = 0; i < CLASSIFIER_TREES; i++)
+    {
+        depth = tree_depth(classifier_roots[i], CLASSIFIER_MAX_DEPTH);
+        if (depth < 0)
+        {
+            printf("classifier: tree %d is deeper than %d or broken\n", i,
+                   CLASSIFIER_MAX_DEPTH);
+            return 1;
+        }
+        comparisons += depth;
+    }
+
+    for (i = 0; i < 1024; i++)
+    {
+        for (k = 0; k < CLASSIFIER_FEATURES; k++)
+        {
+            r = test_rand(&seed);
+            features[i][k] = k < CLASSIFIER_MEAN_X ? (int32_t)(r % 2000000) :
+                             (int32_t)(r % 16384) - 8192;
+        }
+    }
+    t = test_now();
+    c = test_cycles();
+    for (i = 0; i < CALLS; i++)
+    {
+        check += classifier_predict(features[i & 1023]);
+    }
+    random_cycles = (test_cycles() - c) / CALLS;
+    random_ns = (test_now() - t) / CALLS * 1e9;
+
+    /* Motion through a 128-sample window, as the CM4 classifies it */
+    activity_init(&f, buf, 128, 409);
+    for (i = 0; i < 1024; i++)
+    {
+        r = test_rand(&seed);
+        activity_push(&f, (int16_t)((r & 0xFFF) - 0x800),
+                      (int16_t)(((r >> 12) & 0xFFF) - 0x800),
+                      (int16_t)(8192 + ((r >> 24) << 4)));
+        activity_get(&f, &set);
+        classifier_features(&set, features[i]);
+    }
+    t = test_now();
+    c = test_cycles();
+    for (i = 0; i < CALLS; i++)
+    {
+        check += classifier_predict(features[i & 1023]);
+    }
+    window_cycles = (test_cycles() - c) / CALLS;
+    window_ns = (test_now() - t) / CALLS * 1e9;
+
+    printf("classifier: %d trees, at most %d comparisons\n", CLASSIFIER_TREES,
+           comparisons);
+    printf("classifier: %.1f ns, %u cycles on random features; %.1f ns, %u "
+           "cycles on windows\n", random_ns, (unsigned)random_cycles,
+           window_ns, (unsigned)window_cycles);
+    printf("classifier: host cycles at %.2f GHz\n",
+           random_cycles / random_ns);
+
+    /* Keeps the loops from being optimized away */
+    return check < 0;
+}
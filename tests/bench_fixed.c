@@ -0,0 +1,80 @@
+/*
+ * Fixed-point benchmark
+ *
+ * Host time and cycles of the happy score against the float code it
+ * replaced, over the same averages. The host has an FPU and a divider, the
+ * CM0+ neither, so the host numbers only bound the integer version. On the
+ * CM0+ the cost is in the run-time helpers each version calls: the integer
+ * score a single __aeabi_idiv, the float one 13 soft float routines.
+ */
+
+#include "test.h"
+
+#include "Fixed.h"
+
+#define CALLS       (10000000)
+
+/* The float version, with the averages in the units Fixed.h takes */
+static int float_score(int light, int temp)
+{
+    float light_score = (float)light / 256 / 200 * 100.0f;
+    float temp_score = (float)temp / 100 / 25 * 100.0f;
+
+    if (light_score > 100.0f)
+    {
+        light_score = 100.0f;
+    }
+    if (temp_score > 100.0f)
+    {
+        temp_score = 100.0f;
+    }
+    return (int)((light_score + temp_score) / 2.0f);
+}
+
+int main(void)
+{
+    static int32_t lights[1024], temps[1024];
+    uint32_t seed = 1u;
+    int64_t sum = 0;
+    uint64_t c, fixed_cycles, float_cycles;
+    double t, fixed_ns, float_ns;
+    int i;
+
+    for (i = 0; i < 1024; i++)
+    {
+        lights[i] = (int32_t)(test_rand(&seed) % 70000);
+        temps[i] = (int32_t)(test_rand(&seed) % 4000);
+    }
+
+    t = test_now();
+    c = test_cycles();
+    for (i = 0; i < CALLS; i++)
+    {
+        sum += fixed_happy_score(lights[i & 1023], 512, temps[i & 1023], 25,
+                                 100);
+    }
+    fixed_cycles = (test_cycles() - c) / CALLS;
+    fixed_ns = (test_now() - t) / CALLS * 1e9;
+
+    t = test_now();
+    c = test_cycles();
+    for (i = 0; i < CALLS; i++)
+    {
+        sum += float_score(lights[i & 1023], temps[i & 1023]);
+    }
+    float_cycles = (test_cycles() - c) / CALLS;
+    float_ns = (test_now() - t) / CALLS * 1e9;
+
+    printf("happy score on the host: fixed %.2f ns, %u cycles; float "
+           "%.2f ns, %u cycles\n", fixed_ns, (unsigned)fixed_cycles,
+           float_ns, (unsigned)float_cycles);
+
+    /* Three divides, four multiplies (dividing by 256 and 2 among them)
+       and an add in float, two conversions from int and one back, two
+       compares */
+    printf("happy score on the CM0+: fixed 1 helper call (__aeabi_idiv), "
+           "float 13 (__aeabi_f*)\n");
+
+    /* Keeps the loops from being optimized away */
+    return sum == 0;
+}
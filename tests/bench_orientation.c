@@ -0,0 +1,175 @@
+/*
+ * Orientation filter benchmark
+ *
+ * Accuracy: a synthetic head motion is integrated into a true attitude,
+ * and both filters are fed what the sensors would read, with noise and a
+ * gyroscope bias, at the Process.h rate. The error is the angle between
+ * the true and the estimated up direction, once the filters settled. The
+ * benchmark fails if a filter strays past ERR_MEAN or ERR_MAX degrees.
+ *
+ * Speed: host time and cycles of one update of each filter, the cycles
+ * those of the host core at the clock printed (test_cycles()). The host
+ * has an FPU, so the float filter is not slower there; on a core without
+ * one, every float operation of it becomes a library call.
+ */
+
+#include "test.h"
+
+#include <math.h>
+
+#include "Orientation.h"
+
+#define PI          (3.14159265358979323846)
+#define RATE        (1125.0 / 45.0)     /* CoreLink.h: ACC_ODR_HZ */
+#define LSB_PER_G   (8192.0)
+#define LSB_PER_DPS (65.5)
+#define SECONDS     (600)
+#define SETTLE      (10)                /* Seconds left out of the error */
+#define ERR_MEAN    (3.0)
+#define ERR_MAX     (10.0)
+#define UPDATES     (5000000)
+
+struct quat
+{
+    double w, x, y, z;
+};
+
+static struct quat quat_mul(struct quat a, struct quat b)
+{
+    struct quat r = {
+        a.w * b.w - a.x * b.x - a.y * b.y - a.z * b.z,
+        a.w * b.x + a.x * b.w + a.y * b.z - a.z * b.y,
+        a.w * b.y - a.x * b.z + a.y * b.w + a.z * b.x,
+        a.w * b.z + a.x * b.y - a.y * b.x + a.z * b.w
+    };
+
+    return r;
+}
+
+static double noise(uint32_t *seed)
+{
+    return (int)(test_rand(seed) % 20001) / 10000.0 - 1.0;
+}
+
+/* Angle between a Q14 estimate and the true unit vector, in degrees */
+static double error_deg(const int16_t *up, const double *truth)
+{
+    double dot = 0.0, norm = 0.0;
+    int k;
+
+    for (k = 0; k < 3; k++)
+    {
+        dot += up[k] * truth[k];
+        norm += (double)up[k] * up[k];
+    }
+    dot /= sqrt(norm);
+    return acos(dot > 1.0 ? 1.0 : dot) * 180.0 / PI;
+}
+
+static int accuracy(void)
+{
+    struct orientation o;
+    struct orientation_q oq;
+    struct quat q = { 1.0, 0.0, 0.0, 0.0 }, dq;
+    uint32_t seed = 16u;
+    double t, n, w[3], truth[3], e, sum = 0, sum_q = 0, max = 0, max_q = 0;
+    int16_t gyro[3], acc[3], up[3];
+    int i, k, count = 0;
+
+    orientation_init(&o, (float)(1.0 / LSB_PER_DPS), (float)RATE);
+    orientation_q_init(&oq, (float)(1.0 / LSB_PER_DPS), (float)RATE);
+    for (i = 0; i < SECONDS * RATE; i++)
+    {
+        /* Grazing, chewing and looking around, in rad/s */
+        t = i / RATE;
+        w[0] = 0.8 * sin(0.3 * t);
+        w[1] = 0.6 * sin(0.17 * t + 1.0);
+        w[2] = 0.4 * cos(0.23 * t);
+
+        dq.w = 1.0;
+        dq.x = w[0] / RATE / 2;
+        dq.y = w[1] / RATE / 2;
+        dq.z = w[2] / RATE / 2;
+        q = quat_mul(q, dq);
+        n = sqrt(q.w * q.w + q.x * q.x + q.y * q.y + q.z * q.z);
+        q.w /= n;
+        q.x /= n;
+        q.y /= n;
+        q.z /= n;
+
+        truth[0] = 2 * (q.x * q.z - q.w * q.y);
+        truth[1] = 2 * (q.w * q.x + q.y * q.z);
+        truth[2] = q.w * q.w - q.x * q.x - q.y * q.y + q.z * q.z;
+        for (k = 0; k < 3; k++)
+        {
+            gyro[k] = (int16_t)lround(w[k] * 180.0 / PI * LSB_PER_DPS +
+                                      3.0 * noise(&seed) + 5.0);
+            acc[k] = (int16_t)lround(truth[k] * LSB_PER_G +
+                                     300.0 * noise(&seed));
+        }
+
+        orientation_update(&o, gyro, acc);
+        orientation_q_update(&oq, gyro, acc);
+        if (t < SETTLE)
+        {
+            continue;
+        }
+
+        orientation_up(&o, up);
+        e = error_deg(up, truth);
+        sum += e;
+        max = e > max ? e : max;
+
+        orientation_q_up(&oq, up);
+        e = error_deg(up, truth);
+        sum_q += e;
+        max_q = e > max_q ? e : max_q;
+        count++;
+    }
+
+    printf("orientation: error %.2f mean, %.2f max degrees float; "
+           "%.2f mean, %.2f max fixed\n", sum / count, max, sum_q / count,
+           max_q);
+    return sum / count > ERR_MEAN || max > ERR_MAX ||
+           sum_q / count > ERR_MEAN || max_q > ERR_MAX;
+}
+
+int main(void)
+{
+    struct orientation o;
+    struct orientation_q oq;
+    int16_t gyro[3] = { 100, -50, 20 }, acc[3] = { 100, 200, 8000 };
+    uint64_t c, float_cycles, fixed_cycles;
+    double t, float_ns, fixed_ns;
+    int i, failed;
+
+    failed = accuracy();
+
+    orientation_init(&o, (float)(1.0 / LSB_PER_DPS), (float)RATE);
+    orientation_q_init(&oq, (float)(1.0 / LSB_PER_DPS), (float)RATE);
+    t = test_now();
+    c = test_cycles();
+    for (i = 0; i < UPDATES; i++)
+    {
+        gyro[0] ^= (int16_t)(i & 1);
+        orientation_update(&o, gyro, acc);
+    }
+    float_cycles = (test_cycles() - c) / UPDATES;
+    float_ns = (test_now() - t) / UPDATES * 1e9;
+
+    t = test_now();
+    c = test_cycles();
+    for (i = 0; i < UPDATES; i++)
+    {
+        gyro[0] ^= (int16_t)(i & 1);
+        orientation_q_update(&oq, gyro, acc);
+    }
+    fixed_cycles = (test_cycles() - c) / UPDATES;
+    fixed_ns = (test_now() - t) / UPDATES * 1e9;
+
+    printf("orientation: per update %.1f ns, %u cycles float; %.1f ns, %u "
+           "cycles fixed\n", float_ns, (unsigned)float_cycles, fixed_ns,
+           (unsigned)fixed_cycles);
+    printf("orientation: host cycles at %.2f GHz\n", float_cycles / float_ns);
+    return failed;
+}
@@ -0,0 +1,86 @@
+/*
+ * Ring benchmark
+ *
+ * A million enqueue/dequeue pairs through a ring and through the malloc'd
+ * queue it replaces, counting the heap allocations of each. The program is
+ * linked with malloc() wrapped (ld --wrap), so every call Queue.c and
+ * Ring.c make goes through the counter below.
+ */
+
+#include "test.h"
+
+#include <stdlib.h>
+
+#include "Queue.h"
+#include "Ring.h"
+
+static long heap_allocs = 0;
+
+void *__real_malloc(size_t size);
+
+void *__wrap_malloc(size_t size)
+{
+    heap_allocs++;
+    return __real_malloc(size);
+}
+
+#define OPS         (1000000)
+#define DEPTH       (24)        /* Items kept queued, as the light history */
+
+int main(void)
+{
+    static int buf[DEPTH + 1];
+    struct ring ring;
+    queue_t queue;
+    long allocs;
+    double t;
+    int i, data = 0;
+    long sum = 0;
+
+    /* Ring */
+    ring_init(&ring, buf, DEPTH + 1, RING_REJECT);
+    for (i = 0; i < DEPTH; i++)
+    {
+        ring_enqueue(&ring, i);
+    }
+    allocs = heap_allocs;
+    t = test_now();
+    for (i = 0; i < OPS; i++)
+    {
+        ring_enqueue(&ring, i);
+        ring_dequeue(&ring, &data);
+        sum += data;
+    }
+    t = test_now() - t;
+    printf("ring:  %8.1f Mops/s, %ld heap allocations\n",
+           2.0 * OPS / t / 1e6, heap_allocs - allocs);
+    if (heap_allocs != allocs)
+    {
+        return 1;
+    }
+
+    /* Queue */
+    queue = queue_create();
+    for (i = 0; i < DEPTH; i++)
+    {
+        queue_enqueue(queue, i + 1);
+    }
+    allocs = heap_allocs;
+    t = test_now();
+    for (i = 0; i < OPS; i++)
+    {
+        queue_enqueue(queue, i + 1);
+        queue_dequeue(queue, &data);
+        sum += data;
+    }
+    t = test_now() - t;
+    printf("queue: %8.1f Mops/s, %ld heap allocations\n",
+           2.0 * OPS / t / 1e6, heap_allocs - allocs);
+    while (queue_dequeue(queue, &data) == 0)
+    {
+    }
+    queue_destroy(queue);
+
+    /* Keeps the loops from being optimized away */
+    return sum == 0;
+}
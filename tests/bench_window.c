@@ -0,0 +1,65 @@
+/*
+ * Window benchmark
+ *
+ * The cost of one push and read of every statistic as the window grows,
+ * against recomputing them over the samples each tick as the queues did.
+ */
+
+#include "test.h"
+
+#include "Window.h"
+
+#define MAX_CAPACITY    (5760)      /* 8 hours at the 5 second tick */
+#define PUSHES          (200000)
+
+int main(void)
+{
+    static const int capacities[] = { 23, 720, MAX_CAPACITY };
+    static int samples[MAX_CAPACITY];
+    static struct window_entry minq[MAX_CAPACITY], maxq[MAX_CAPACITY];
+    struct window win;
+    uint32_t seed = 1u;
+    double t, window_ns, brute_ns;
+    int64_t sum, check = 0;
+    int i, j, k, n, min, max, mean;
+
+    for (k = 0; k < (int)(sizeof(capacities) / sizeof(capacities[0])); k++)
+    {
+        n = capacities[k];
+        window_init(&win, samples, minq, maxq, n);
+
+        t = test_now();
+        for (i = 0; i < PUSHES; i++)
+        {
+            window_push(&win, (int)(test_rand(&seed) % 100000));
+            window_mean(&win, &mean);
+            window_min(&win, &min);
+            window_max(&win, &max);
+            check += mean + min + max;
+        }
+        window_ns = (test_now() - t) / PUSHES * 1e9;
+
+        /* The window is full, walk its samples as a queue would */
+        t = test_now();
+        for (i = 0; i < PUSHES / 100; i++)
+        {
+            sum = 0;
+            min = max = samples[0];
+            for (j = 0; j < n; j++)
+            {
+                sum += samples[j];
+                min = samples[j] < min ? samples[j] : min;
+                max = samples[j] > max ? samples[j] : max;
+            }
+            samples[i % n]++;
+            check += sum / n + min + max;
+        }
+        brute_ns = (test_now() - t) / (PUSHES / 100) * 1e9;
+
+        printf("window %4d: %6.1f ns per push, %8.1f ns per recompute\n",
+               n, window_ns, brute_ns);
+    }
+
+    /* Keeps the loops from being optimized away */
+    return check == 0;
+}
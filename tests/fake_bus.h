@@ -0,0 +1,196 @@
+#ifndef _FAKE_BUS_H
+#define _FAKE_BUS_H
+
+/*
+ * Fake I2C bus
+ *
+ * The bus shim of I2C_Async.h, in place of the SCB of I2C_Bus.h, on a bus
+ * of slaves the test models at register level. Include it before the
+ * drivers. A transfer is done at once, but like on the SCB it is only
+ * reported by the I2C interrupt, which fake_bus_irq() runs: the test calls
+ * it from fake_irq(), so the engine sees its events while it sleeps.
+ *
+ * A transaction is counted at each START, repeated starts aside, so a
+ * register read (write, RESTART, read) is one. A slave can be made to NAK
+ * its address for a number of transfers, and the bus to refuse them.
+ */
+
+#include <string.h>
+
+#include "project.h"
+
+#define I2C_BUS_FAKE
+#include "I2C_Async.h"
+
+/* i2cBusError() after a NAK, and the refusal of a busy bus */
+#define FAKE_BUS_NAK        (0x100u)
+#define FAKE_BUS_BUSY       (0x1u)
+
+/*
+ * fake_slave - Register model of one slave
+ * @addr: 7 bit address
+ * @write: Stores @len bytes written from register @reg on
+ * @read: Fills @len bytes read from register @reg on
+ * @naks: Transfers left to NAK the address of
+ * @reg: Register pointer, set by the first byte written
+ */
+struct fake_slave
+{
+    uint8_t addr;
+    void (*write)(uint8_t reg, const uint8_t *data, uint32_t len);
+    void (*read)(uint8_t reg, uint8_t *data, uint32_t len);
+    uint32_t naks;
+    uint8_t reg;
+};
+
+/*
+ * fake_bus - Bus state and counts
+ * @slaves: Slaves on the bus
+ * @count: Number of @slaves
+ * @refuse: Transfers left to refuse to start
+ * @transactions: STARTs
+ * @naks: Transfers NAKed
+ * @bytes: Bytes on the bus, addresses included
+ */
+struct fake_bus
+{
+    struct fake_slave *slaves;
+    int count;
+    uint32_t refuse;
+    uint32_t transactions;
+    uint32_t naks;
+    uint32_t bytes;
+    int open;
+    uint32_t event;
+    uint32_t error;
+    i2c_bus_event_t handler;
+};
+
+static struct fake_bus fake_bus;
+
+/* START (or RESTART) and address. Return: the slave, NULL on a NAK */
+static struct fake_slave *fake_bus_address(uint8_t addr)
+{
+    int i;
+
+    if (!fake_bus.open)
+    {
+        fake_bus.transactions++;
+    }
+    fake_bus.bytes++;
+    for (i = 0; i < fake_bus.count; i++)
+    {
+        if (fake_bus.slaves[i].addr != addr)
+        {
+            continue;
+        }
+        if (fake_bus.slaves[i].naks == 0u)
+        {
+            return &fake_bus.slaves[i];
+        }
+        fake_bus.slaves[i].naks--;
+        break;
+    }
+
+    /* The master sends a STOP */
+    fake_bus.naks++;
+    fake_bus.open = 0;
+    fake_bus.event = I2C_BUS_ERROR;
+    fake_bus.error = FAKE_BUS_NAK;
+    return NULL;
+}
+
+static void i2cBusInit(i2c_bus_event_t handler)
+{
+    fake_bus.handler = handler;
+}
+
+static uint32_t i2cBusWrite(uint8_t addr, uint8_t *buf, uint32_t len,
+                            int pending)
+{
+    struct fake_slave *slave;
+
+    if (fake_bus.refuse > 0u)
+    {
+        fake_bus.refuse--;
+        return FAKE_BUS_BUSY;
+    }
+    if (fake_bus.event != 0u)
+    {
+        return FAKE_BUS_BUSY;
+    }
+    slave = fake_bus_address(addr);
+    if (slave == NULL)
+    {
+        return 0;
+    }
+    slave->reg = buf[0];
+    if (len > 1u)
+    {
+        slave->write(slave->reg, &buf[1], len - 1u);
+    }
+    fake_bus.bytes += len;
+    fake_bus.open = pending;
+    fake_bus.event = I2C_BUS_WR_DONE;
+    return 0;
+}
+
+static uint32_t i2cBusRead(uint8_t addr, uint8_t *buf, uint32_t len)
+{
+    struct fake_slave *slave;
+
+    if (fake_bus.event != 0u)
+    {
+        return FAKE_BUS_BUSY;
+    }
+    slave = fake_bus_address(addr);
+    if (slave == NULL)
+    {
+        return 0;
+    }
+    slave->read(slave->reg, buf, len);
+    fake_bus.bytes += len;
+    fake_bus.open = 0;
+    fake_bus.event = I2C_BUS_RD_DONE;
+    return 0;
+}
+
+static uint32_t i2cBusError(void)
+{
+    return fake_bus.error;
+}
+
+/*
+ * fake_bus_init - Empty the bus and put slaves on it
+ * @slaves: Slaves on the bus
+ * @count: Number of @slaves
+ */
+static inline void fake_bus_init(struct fake_slave *slaves, int count)
+{
+    i2c_bus_event_t handler = fake_bus.handler;
+
+    memset(&fake_bus, 0, sizeof(fake_bus));
+    fake_bus.slaves = slaves;
+    fake_bus.count = count;
+    fake_bus.handler = handler;
+}
+
+/*
+ * fake_bus_irq - Run the I2C interrupt
+ *
+ * Return: 1 if a transfer was reported, 0 if the bus was idle.
+ */
+static inline int fake_bus_irq(void)
+{
+    uint32_t event = fake_bus.event;
+
+    if (event == 0u || fake_bus.handler == NULL)
+    {
+        return 0;
+    }
+    fake_bus.event = 0u;
+    fake_bus.handler(event);
+    return 1;
+}
+
+#endif /* _FAKE_BUS_H */
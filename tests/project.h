@@ -0,0 +1,185 @@
+#ifndef _PROJECT_H
+#define _PROJECT_H
+
+/*
+ * Host stand-in for project.h
+ *
+ * PSoC Creator generates project.h with the whole PDL behind it; the host
+ * tests of the drivers get this instead: the few PDL types and calls those
+ * drivers use, as simple models. Delays are counted, not spent. Sleeping
+ * runs whatever interrupt the test raises from fake_irq(), the way WFI
+ * returns after an interrupt; a sleep that nothing would wake up from ends
+ * the test instead of hanging it. The I2C engine does not reach the SCB
+ * here but the bus of fake_bus.h.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/*
+ * GPIO port, one bit per pin
+ * @level: Input level the test drives
+ * @mask: Interrupt mask
+ * @intr: Interrupt flags, set by the test, cleared by the driver
+ */
+typedef struct
+{
+    uint32_t level;
+    uint32_t mask;
+    uint32_t intr;
+} GPIO_PRT_Type;
+
+/*
+ * fake_psoc - What the drivers asked of the core
+ * @delays: Busy waits, of any length
+ * @sleeps: WFI sleeps
+ * @gpio: Ports 9 and 10
+ */
+struct fake_psoc
+{
+    uint32_t delays;
+    uint32_t sleeps;
+    GPIO_PRT_Type gpio[2];
+};
+
+static struct fake_psoc fake_psoc;
+
+/* Runs the interrupt that ends a sleep. Return: 0 if none would come */
+static int (*fake_irq)(void);
+
+/* SysLib */
+static inline void CyDelay(uint32_t ms)
+{
+    (void)ms;
+    fake_psoc.delays++;
+}
+
+static inline void Cy_SysLib_Delay(uint32_t ms)
+{
+    (void)ms;
+    fake_psoc.delays++;
+}
+
+static inline void Cy_SysLib_DelayUs(uint16_t us)
+{
+    (void)us;
+    fake_psoc.delays++;
+}
+
+static inline uint32_t Cy_SysLib_EnterCriticalSection(void)
+{
+    return 0;
+}
+
+static inline void Cy_SysLib_ExitCriticalSection(uint32_t saved)
+{
+    (void)saved;
+}
+
+/* SysPm */
+typedef enum
+{
+    CY_SYSPM_WAIT_FOR_INTERRUPT,
+    CY_SYSPM_WAIT_FOR_EVENT
+} cy_en_syspm_waitfor_t;
+
+typedef enum
+{
+    CY_SYSPM_SUCCESS,
+    CY_SYSPM_FAIL
+} cy_en_syspm_status_t;
+
+static inline cy_en_syspm_status_t Cy_SysPm_CpuEnterSleep(
+    cy_en_syspm_waitfor_t wait)
+{
+    (void)wait;
+    fake_psoc.sleeps++;
+    if (fake_irq == NULL || !fake_irq())
+    {
+        printf("project.h: sleeping with no interrupt to come\n");
+        exit(1);
+    }
+    return CY_SYSPM_SUCCESS;
+}
+
+/* SysInt, the handlers are the test's to call */
+typedef int IRQn_Type;
+typedef void (*cy_israddress)(void);
+
+typedef struct
+{
+    IRQn_Type intrSrc;
+    IRQn_Type cm0pSrc;
+    uint32_t intrPriority;
+} cy_stc_sysint_t;
+
+#define ioss_interrupts_gpio_9_IRQn     (9)
+#define ioss_interrupts_gpio_10_IRQn    (10)
+#define NvicMux6_IRQn                   (6)
+#define NvicMux7_IRQn                   (7)
+
+static inline int Cy_SysInt_Init(const cy_stc_sysint_t *config,
+                                 cy_israddress handler)
+{
+    (void)config;
+    (void)handler;
+    return 0;
+}
+
+static inline void NVIC_EnableIRQ(IRQn_Type irq)
+{
+    (void)irq;
+}
+
+static inline void NVIC_ClearPendingIRQ(IRQn_Type irq)
+{
+    (void)irq;
+}
+
+/* GPIO */
+#define GPIO_PRT9           (&fake_psoc.gpio[0])
+#define GPIO_PRT10          (&fake_psoc.gpio[1])
+
+#define CY_GPIO_DM_HIGHZ    (8u)
+#define HSIOM_SEL_GPIO      (0u)
+#define CY_GPIO_INTR_RISING     (1u)
+#define CY_GPIO_INTR_FALLING    (2u)
+
+static inline void Cy_GPIO_Pin_FastInit(GPIO_PRT_Type *port, uint32_t pin,
+                                        uint32_t mode, uint32_t value,
+                                        uint32_t hsiom)
+{
+    (void)port;
+    (void)pin;
+    (void)mode;
+    (void)value;
+    (void)hsiom;
+}
+
+static inline void Cy_GPIO_SetInterruptEdge(GPIO_PRT_Type *port,
+                                            uint32_t pin, uint32_t edge)
+{
+    (void)port;
+    (void)pin;
+    (void)edge;
+}
+
+static inline void Cy_GPIO_SetInterruptMask(GPIO_PRT_Type *port,
+                                            uint32_t pin, uint32_t value)
+{
+    port->mask = (port->mask & ~(1u << pin)) | ((value & 1u) << pin);
+}
+
+static inline void Cy_GPIO_ClearInterrupt(GPIO_PRT_Type *port, uint32_t pin)
+{
+    port->intr &= ~(1u << pin);
+}
+
+static inline uint32_t Cy_GPIO_Read(GPIO_PRT_Type *port, uint32_t pin)
+{
+    return (port->level >> pin) & 1u;
+}
+
+#endif /* _PROJECT_H */
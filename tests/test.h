@@ -0,0 +1,96 @@
+#ifndef _TEST_H
+#define _TEST_H
+
+/*
+ * Host test helpers
+ *
+ * Must be included first, it asks for the POSIX clock. CHECK() reports a
+ * failed check with its line and carries on, so one run lists every
+ * failure; test_done() sums up and gives the exit status.
+ */
+
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+
+static int test_failures = 0;
+
+#define CHECK(cond)                                                         \
+    do                                                                      \
+    {                                                                       \
+        if (!(cond))                                                        \
+        {                                                                   \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            test_failures++;                                                \
+        }                                                                   \
+    } while (0)
+
+/*
+ * test_done - Sum up a test
+ * @name: Test name
+ *
+ * Return: 0 if every check passed, 1 otherwise, for main() to return.
+ */
+static inline int test_done(const char *name)
+{
+    printf("%s: %s\n", name, test_failures ? "FAILED" : "ok");
+    return test_failures != 0;
+}
+
+/*
+ * test_now - Monotonic time
+ *
+ * Return: Seconds from an arbitrary origin.
+ */
+static inline double test_now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/*
+ * test_cycles - Host cycle counter
+ *
+ * The x86 time stamp counter, which runs at the nominal core clock
+ * whatever the power state; 0 on other hosts. These are host cycles: the
+ * benchmarks compare builds and window lengths with them, they do not
+ * stand for Cortex-M cycles.
+ *
+ * Return: Cycles from an arbitrary origin.
+ */
+static inline uint64_t test_cycles(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    uint32_t lo, hi;
+
+    __asm__ __volatile__("rdtsc" : "=a"(lo), "=d"(hi));
+    return ((uint64_t)hi << 32) | lo;
+#else
+    return 0;
+#endif
+}
+
+/*
+ * test_rand - Deterministic pseudo-random numbers (xorshift32)
+ * @state: Generator state, any non-zero seed
+ *
+ * The same seed gives the same sequence on every host, unlike rand().
+ *
+ * Return: Next 32-bit number.
+ */
+static inline uint32_t test_rand(uint32_t *state)
+{
+    uint32_t x = *state;
+
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+#endif /* _TEST_H */
@@ -0,0 +1,275 @@
+/*
+ * Accelerometer driver test
+ *
+ * Accelerometer.h on the fake bus, with a register model of the ICM-20948:
+ * four user banks switched through REG_BANK_SEL, which every bank has,
+ * a register pointer that moves on after each byte but at FIFO_R_W, where
+ * reads pop the FIFO, a big endian FIFO_COUNT, status registers cleared
+ * when read and a reset through PWR_MGMT_1. accInit() must find the device
+ * by WHOAMI and write each register in its own bank, switching only when
+ * needed; accMeasure() must read the 12 bytes from 0x2D in one burst and
+ * decode them as big endian signed values; accFifoDrain() must move every
+ * whole record out, in order and numbered, within the room it is given.
+ */
+
+#include "test.h"
+
+#include "fake_bus.h"
+#include "Accelerometer.h"
+
+/* ICM-20948 */
+static uint8_t regs[4][128];
+static uint8_t bank, whoami = WHOAMI_VALUE;
+static uint32_t bank_writes;
+static uint8_t fifo[ACC_FIFO_BYTES];
+static uint32_t fifo_len, fifo_head;
+
+static void icm_reset(void)
+{
+    memset(regs, 0, sizeof(regs));
+    regs[0][WHOAMI] = whoami;
+    regs[0][PWR_MGMT_1] = 0x41;
+    regs[0][LP_CONFIG] = LP_CONFIG_DEFAULT;
+    bank = 0;
+    fifo_len = 0;
+}
+
+static uint8_t icm_read_byte(uint8_t reg)
+{
+    uint32_t count = fifo_len - fifo_head;
+    uint8_t v;
+
+    if (reg == REG_BANK_SEL)
+    {
+        return (uint8_t)(bank << 4);
+    }
+    if (bank != 0)
+    {
+        return regs[bank][reg];
+    }
+    switch (reg)
+    {
+    case FIFO_COUNTH:
+        return (uint8_t)(count >> 8);
+    case FIFO_COUNTH + 1:
+        return (uint8_t)count;
+    case FIFO_R_W:
+        return fifo_head < fifo_len ? fifo[fifo_head++] : 0xFF;
+    case INT_STATUS:
+    case INT_STATUS + 1:
+    case INT_STATUS_2:
+    case INT_STATUS_3:
+        v = regs[0][reg];
+        regs[0][reg] = 0;
+        return v;
+    default:
+        return regs[0][reg];
+    }
+}
+
+static void icm_read(uint8_t reg, uint8_t *data, uint32_t len)
+{
+    uint32_t i;
+
+    for (i = 0; i < len; i++)
+    {
+        data[i] = icm_read_byte(reg);
+        if (!(bank == 0 && reg == FIFO_R_W))
+        {
+            reg = (reg + 1u) & 0x7Fu;
+        }
+    }
+}
+
+static void icm_write(uint8_t reg, const uint8_t *data, uint32_t len)
+{
+    uint32_t i;
+
+    for (i = 0; i < len; i++, reg = (reg + 1u) & 0x7Fu)
+    {
+        if (reg == REG_BANK_SEL)
+        {
+            bank = (data[i] >> 4) & 3u;
+            bank_writes++;
+        }
+        else if (bank == 0 && reg == PWR_MGMT_1 &&
+                 (data[i] & PWR_MGMT_1_RESET))
+        {
+            icm_reset();
+        }
+        else if (bank == 0 && reg == FIFO_RST && (data[i] & 0x1F))
+        {
+            fifo_len = fifo_head = 0;
+        }
+        else
+        {
+            regs[bank][reg] = data[i];
+        }
+    }
+}
+
+static struct fake_slave icm = { ACC_ADDRESS, icm_write, icm_read, 0, 0 };
+
+/* Big endian, as the ICM-20948 stores its outputs */
+static void put16(uint8_t *p, int16_t v)
+{
+    p[0] = (uint8_t)((uint16_t)v >> 8);
+    p[1] = (uint8_t)v;
+}
+
+static const int16_t values[6] = { -12345, 32767, -32768, 1, -1, 0x1234 };
+
+/* A record of the FIFO, every axis offset by @n */
+static void fifo_push(int n)
+{
+    int i;
+
+    for (i = 0; i < 6; i++)
+    {
+        put16(&fifo[fifo_len + 2u * i], (int16_t)(values[i] + n));
+    }
+    fifo_len += MOTION_BURST_LEN;
+}
+
+static void test_init(void)
+{
+    fake_bus_init(&icm, 1);
+    icm_reset();
+    bank = 3;
+    bank_writes = 0;
+    CHECK(accInit() == 0);
+
+    /* Bank 0, reset, bank 2 for the rates and filters, bank 0 again */
+    CHECK(bank_writes == 3u && bank == 0 && accBank == 0);
+    CHECK(regs[2][GYRO_SMPLRT_DIV] == GYRO_SMPLRT_DIV_VALUE);
+    CHECK(regs[2][GYRO_CONFIG_1] == GYRO_CONFIG_VALUE);
+    CHECK(regs[2][ACCEL_SMPLRT_DIV_2] == ACC_SMPLRT_DIV);
+    CHECK(regs[2][ACCEL_CONFIG] == ACC_CONFIG_VALUE);
+    CHECK(regs[2][ACCEL_WOM_THR] == ACC_WOM_MG / 4u);
+    CHECK(regs[2][ACCEL_INTEL_CTRL] == ACCEL_INTEL_WOM);
+    CHECK(regs[0][ACCEL_CONFIG] == 0 && regs[0][ACCEL_WOM_THR] == 0);
+    CHECK(regs[0][PWR_MGMT_1] == PWR_MGMT_1_CLK_AUTO);
+    CHECK(regs[0][FIFO_EN_2] == FIFO_EN_2_ACCEL_GYRO);
+    CHECK(regs[0][USER_CTRL] == USER_CTRL_FIFO_EN);
+    CHECK(regs[0][INT_ENABLE] == INT_WOM && regs[0][INT_ENABLE_2] == INT_FIFO0);
+    CHECK(!(GPIO_PRT10->mask & (1u << ACC_INT_PIN)));
+
+    /* Cached, no traffic for the bank in use */
+    bank_writes = 0;
+    accSelectBank(0);
+    CHECK(bank_writes == 0u);
+
+    /* Anything else answering at the address is not taken for it */
+    fake_bus_init(&icm, 1);
+    whoami = 0x71;
+    icm_reset();
+    CHECK(accInit() == -1);
+    CHECK(regs[0][FIFO_EN_2] == 0);
+    whoami = WHOAMI_VALUE;
+
+    /* Nor is silence */
+    icm.naks = 100u;
+    CHECK(accInit() == -1);
+    icm.naks = 0;
+    icm_reset();
+    CHECK(accInit() == 0);
+}
+
+static void test_measure(void)
+{
+    int16_t ax = 0, ay = 0, az = 0, gx = 0, gy = 0, gz = 0;
+    int i;
+
+    for (i = 0; i < 6; i++)
+    {
+        put16(&regs[0][XACCEL_H + 2 * i], values[i]);
+    }
+
+    /* From another bank: one switch, then a single 12 byte burst */
+    accSelectBank(2);
+    fake_bus_init(&icm, 1);
+    accMeasure(&ax, &ay, &az, &gx, &gy, &gz);
+    CHECK(bank == 0 && fake_bus.transactions == 1u + 1u);
+    CHECK(icm.reg == XACCEL_H);
+    CHECK(fake_bus.bytes == (1u + 2u) + (1u + 1u + 1u + MOTION_BURST_LEN));
+    CHECK(ax == values[0] && ay == values[1] && az == values[2]);
+    CHECK(gx == values[3] && gy == values[4] && gz == values[5]);
+
+    /* A failed read leaves the results alone */
+    icm.naks = 100u;
+    regs[0][XACCEL_H] = 0;
+    accMeasure(&ax, &ay, &az, &gx, &gy, &gz);
+    CHECK(ax == values[0] && gz == values[5]);
+    icm.naks = 0;
+}
+
+static void test_fifo(void)
+{
+    struct moo_motion motion[64];
+    uint32_t seq = accFifoSeq;
+    int i, n;
+
+    /* 40 records and half of one, drained in bursts of ACC_FIFO_BURST */
+    fifo_len = fifo_head = 0;
+    for (i = 0; i < 40; i++)
+    {
+        fifo_push(i);
+    }
+    fifo_len += MOTION_BURST_LEN / 2u;
+    fake_bus_init(&icm, 1);
+    n = accFifoDrain(motion, 64);
+    CHECK(n == 40);
+    CHECK(fake_bus.transactions == 1u + (40u + ACC_FIFO_BURST - 1u) /
+                                        ACC_FIFO_BURST);
+    CHECK(fifo_len - fifo_head == MOTION_BURST_LEN / 2u);
+    for (i = 0; i < n; i++)
+    {
+        CHECK(motion[i].t == seq + (uint32_t)i);
+        CHECK(motion[i].acc[0] == (int16_t)(values[0] + i));
+        CHECK(motion[i].acc[1] == (int16_t)(values[1] + i));
+        CHECK(motion[i].acc[2] == (int16_t)(values[2] + i));
+        CHECK(motion[i].gyro[0] == (int16_t)(values[3] + i));
+        CHECK(motion[i].gyro[1] == (int16_t)(values[4] + i));
+        CHECK(motion[i].gyro[2] == (int16_t)(values[5] + i));
+    }
+    CHECK(accFifoDrain(motion, 64) == 0);
+
+    /* A full FIFO, the 13 bit count past one byte, in less room */
+    accFifoReset();
+    for (i = 0; i < (int)ACC_FIFO_RECORDS; i++)
+    {
+        fifo_push(i);
+    }
+    CHECK(accFifoDrain(motion, 10) == 10);
+    CHECK(motion[9].acc[0] == (int16_t)(values[0] + 9));
+    n = accFifoDrain(motion, 64);
+    CHECK(n == (int)ACC_FIFO_RECORDS - 10);
+    CHECK(motion[0].acc[0] == (int16_t)(values[0] + 10));
+    CHECK(motion[0].t == seq + 40u + 10u);
+    CHECK(fifo_head == fifo_len);
+}
+
+static void test_status(void)
+{
+    regs[0][INT_STATUS] = INT_WOM;
+    regs[0][INT_STATUS_2] = INT_FIFO0;
+    fake_bus_init(&icm, 1);
+    CHECK(accIntStatus() == (ACC_INT_WOM | ACC_INT_OVERFLOW));
+    CHECK(fake_bus.transactions == 1u && accFifoOverflows == 1u);
+    CHECK(accIntStatus() == 0);
+
+    regs[0][INT_STATUS] = INT_WOM;
+    CHECK(accIntStatus() == ACC_INT_WOM && accFifoOverflows == 1u);
+}
+
+int main(void)
+{
+    fake_irq = fake_bus_irq;
+    i2cAsyncInit();
+
+    test_init();
+    test_measure();
+    test_fifo();
+    test_status();
+    return test_done("accel");
+}
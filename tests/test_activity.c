@@ -0,0 +1,136 @@
+/*
+ * Activity feature test
+ *
+ * Random motion with bursts and still spells, every feature of every
+ * window checked against a brute-force model that keeps the whole stream:
+ * the mean and variance over the window, and the ODBA, jerk and crossings
+ * of each sample taken against the window as it was when it arrived.
+ */
+
+#include "test.h"
+
+#include <stdlib.h>
+
+#include "Activity.h"
+
+#define CAPACITY    (128)
+#define HYST        (400)
+#define SAMPLES     (20000)
+
+static int16_t stream[SAMPLES][3];
+static uint32_t odba[SAMPLES], jerk[SAMPLES];
+static uint8_t crossed[SAMPLES];
+
+static int16_t next_value(uint32_t *seed, int t, int axis)
+{
+    int amplitude = (t / 1000) % 3 == 0 ? 50 : 12000;
+    int gravity = axis == 2 ? 8192 : 0;
+
+    return (int16_t)(gravity + (int)(test_rand(seed) % (2 * amplitude + 1)) -
+                     amplitude);
+}
+
+static void test_edges(void)
+{
+    static struct activity_entry buf[4];
+    struct activity f;
+    struct activity_set set;
+
+    CHECK(activity_init(NULL, buf, 4, 0) == -1);
+    CHECK(activity_init(&f, NULL, 4, 0) == -1);
+    CHECK(activity_init(&f, buf, 0, 0) == -1);
+    CHECK(activity_init(&f, buf, ACTIVITY_MAX_LEN + 1, 0) == -1);
+    CHECK(activity_init(&f, buf, 4, -1) == -1);
+    CHECK(activity_init(&f, buf, 4, 0) == 0);
+    CHECK(activity_get(&f, &set) == -1);
+    CHECK(activity_push(NULL, 0, 0, 0) == -1);
+    CHECK(activity_length(&f) == 0);
+    CHECK(activity_length(NULL) == -1);
+
+    /* One sample has no jerk */
+    activity_push(&f, 5, 6, 7);
+    CHECK(activity_get(&f, &set) == 0);
+    CHECK(set.count == 1 && set.mean[2] == 7 && set.var[2] == 0);
+    CHECK(set.odba == 0 && set.jerk == 0);
+}
+
+static void test_model(void)
+{
+    static struct activity_entry buf[CAPACITY];
+    struct activity f;
+    struct activity_set set;
+    uint32_t seed = 13u;
+    int64_t sum, sumsq, n;
+    uint64_t odba_sum, jerk_sum;
+    int t, k, i, first, before, zc, d;
+    int sign[3] = { 0, 0, 0 };
+
+    activity_init(&f, buf, CAPACITY, HYST);
+    for (t = 0; t < SAMPLES; t++)
+    {
+        /* The terms of sample t, against the samples before it that the
+         * window still holds once it made room */
+        before = t < CAPACITY ? t : CAPACITY - 1;
+        odba[t] = jerk[t] = 0;
+        crossed[t] = 0;
+        for (i = 0; i < 3; i++)
+        {
+            stream[t][i] = next_value(&seed, t, i);
+            if (before == 0)
+            {
+                continue;
+            }
+            for (k = t - before, sum = 0; k < t; k++)
+            {
+                sum += stream[k][i];
+            }
+            d = stream[t][i] - (int)(sum / before);
+            odba[t] += (uint32_t)abs(d);
+            jerk[t] += (uint32_t)abs(stream[t][i] - stream[t - 1][i]);
+            if (abs(d) > HYST)
+            {
+                if (sign[i] && (d > 0 ? 1 : -1) != sign[i])
+                {
+                    crossed[t] |= 1u << i;
+                }
+                sign[i] = d > 0 ? 1 : -1;
+            }
+        }
+        activity_push(&f, stream[t][0], stream[t][1], stream[t][2]);
+
+        first = t + 1 < CAPACITY ? 0 : t + 1 - CAPACITY;
+        n = t + 1 - first;
+        CHECK(activity_get(&f, &set) == 0 && set.count == n);
+        for (i = 0; i < 3; i++)
+        {
+            for (k = first, sum = 0, sumsq = 0, zc = 0; k <= t; k++)
+            {
+                sum += stream[k][i];
+                sumsq += (int64_t)stream[k][i] * stream[k][i];
+                zc += (crossed[k] >> i) & 1;
+            }
+            CHECK(set.mean[i] == (int16_t)(sum / n));
+            CHECK(set.var[i] == (uint32_t)((n * sumsq - sum * sum) / (n * n)));
+            CHECK(set.zc[i] == zc);
+        }
+        for (k = first, odba_sum = 0, jerk_sum = 0; k <= t; k++)
+        {
+            odba_sum += odba[k];
+            jerk_sum += jerk[k];
+        }
+        CHECK(set.odba == odba_sum / n);
+        CHECK(set.jerk == (t == 0 ? 0 : jerk_sum / (first > 0 ? n : n - 1)));
+        if (test_failures)
+        {
+            printf("sample %d\n", t);
+            return;
+        }
+    }
+}
+
+int main(void)
+{
+    test_edges();
+    test_model();
+    return test_done("activity");
+}
@@ -0,0 +1,251 @@
+/*
+ * Configuration test
+ *
+ * The defaults and the range of every setting, configuration frames (a
+ * round trip, frames of an older firmware with fewer settings or settings
+ * in seconds, corrupted and erased ones), then the configuration commands
+ * as the Device Inbound handler takes them, each answered by the frame a
+ * client decodes.
+ */
+
+#include "test.h"
+
+#include <string.h>
+
+#include "Config.h"
+#include "Frame.h"
+
+/* Expected default and range of every setting */
+static const int32_t limits[CONFIG_KEYS][3] =
+{
+    [CONFIG_TICK]         = { CONFIG_TICK_DEFAULT, 100, 59000 },
+    [CONFIG_REPORT_EVERY] = { CONFIG_REPORT_DEFAULT, 1, 720 },
+    [CONFIG_INACTIVE]     = { CONFIG_INACTIVE_DEFAULT, 10, 86400 },
+    [CONFIG_LIGHT_CUTOFF] = { CONFIG_LIGHT_CUTOFF_DEFAULT, 0, 65535 },
+    [CONFIG_CRIT_TEMP]    = { CONFIG_CRIT_TEMP_DEFAULT, -40, 85 },
+    [CONFIG_CRIT_LIGHT]   = { CONFIG_CRIT_LIGHT_DEFAULT, 1, 720 },
+    [CONFIG_ACC_TICK]     = { CONFIG_ACC_TICK_DEFAULT, 100, 59000 },
+    [CONFIG_HIBERNATE]    = { CONFIG_HIBERNATE_DEFAULT, 0, 3600 },
+};
+
+/* The settings of the collar, and whether a configuration frame is due */
+static struct config settings;
+static int config_due;
+
+/* Recompute the CRC after editing a frame of @len bytes */
+static void reseal(uint8_t *buf, int len)
+{
+    uint16_t crc = frame_crc16(buf, (uint32_t)len - FRAME_CRC_LEN);
+
+    buf[len - 2] = (uint8_t)crc;
+    buf[len - 1] = (uint8_t)(crc >> 8);
+}
+
+/* The Device Inbound write handler of BLE.h, sync commands aside */
+static void command(const uint8_t *val, uint32_t len)
+{
+    int32_t value;
+    int key;
+
+    if (frame_decode_set(val, len, &key, &value) == 0)
+    {
+        config_set(&settings, key, value);
+        config_due = 1;
+    }
+    else if (len == 1u && val[0] == FRAME_CMD_GET)
+    {
+        config_due = 1;
+    }
+    else if (len == 1u && val[0] == FRAME_CMD_DEFAULTS)
+    {
+        config_defaults(&settings);
+        config_due = 1;
+    }
+}
+
+/* Send a command and decode the answer, as a client */
+static int ask(const uint8_t *val, uint32_t len, struct config *seen)
+{
+    struct frame_header hdr = { 0, 0, 1, 0 };
+    uint8_t buf[FRAME_CONFIG_LEN(CONFIG_KEYS)];
+    int n;
+
+    config_due = 0;
+    command(val, len);
+    if (!config_due)
+    {
+        return -1;
+    }
+    n = frame_encode_config(&hdr, &settings, buf, sizeof(buf));
+    CHECK(n == FRAME_CONFIG_LEN(CONFIG_KEYS));
+    memset(seen, 0, sizeof(*seen));
+    return frame_decode_config(buf, (uint32_t)n, &hdr, seen);
+}
+
+static void test_limits(void)
+{
+    struct config c;
+    int32_t value;
+    int key;
+
+    CHECK(config_defaults(NULL) == -1);
+    CHECK(config_defaults(&c) == 0);
+    CHECK(config_set(NULL, CONFIG_TICK, 1000) == -1);
+    CHECK(config_set(&c, -1, 0) == -1);
+    CHECK(config_set(&c, CONFIG_KEYS, 0) == -1);
+    CHECK(config_get(&c, CONFIG_KEYS, &value) == -1);
+    CHECK(config_get(&c, CONFIG_TICK, NULL) == -1);
+
+    for (key = 0; key < CONFIG_KEYS; key++)
+    {
+        CHECK(config_get(&c, key, &value) == 0 && value == limits[key][0]);
+        CHECK(value >= limits[key][1] && value <= limits[key][2]);
+
+        /* Out of range leaves the setting as it was */
+        CHECK(config_set(&c, key, limits[key][1] - 1) == -1);
+        CHECK(config_set(&c, key, limits[key][2] + 1) == -1);
+        CHECK(config_set(&c, key, INT32_MIN) == -1);
+        CHECK(config_set(&c, key, INT32_MAX) == -1);
+        CHECK(c.value[key] == limits[key][0]);
+
+        CHECK(config_set(&c, key, limits[key][1]) == 0);
+        CHECK(config_get(&c, key, &value) == 0 && value == limits[key][1]);
+        CHECK(config_set(&c, key, limits[key][2]) == 0);
+        CHECK(config_get(&c, key, &value) == 0 && value == limits[key][2]);
+    }
+}
+
+static void test_frames(void)
+{
+    struct frame_header hdr = { 0, 0, 7, 99 }, out_hdr;
+    struct config c, d;
+    uint8_t buf[FRAME_CONFIG_LEN(CONFIG_KEYS)];
+    int key, len, bit;
+
+    config_defaults(&c);
+    for (key = 0; key < CONFIG_KEYS; key++)
+    {
+        config_set(&c, key, key & 1 ? limits[key][1] : limits[key][2]);
+    }
+    CHECK(frame_encode_config(&hdr, &c, buf, sizeof(buf) - 1) == -1);
+    len = frame_encode_config(&hdr, &c, buf, sizeof(buf));
+    CHECK(len == FRAME_CONFIG_LEN(CONFIG_KEYS));
+    CHECK(buf[0] == (FRAME_VERSION << 4 | FRAME_TYPE_CONFIG));
+    CHECK(buf[7] == CONFIG_KEYS);
+
+    config_defaults(&d);
+    CHECK(frame_decode_config(buf, (uint32_t)len, &out_hdr, &d) ==
+          CONFIG_KEYS);
+    CHECK(memcmp(&c, &d, sizeof(c)) == 0);
+    CHECK(out_hdr.type == FRAME_TYPE_CONFIG && out_hdr.seq == 7);
+    CHECK(out_hdr.time == 99);
+
+    /* Corrupted, truncated: nothing is taken */
+    for (bit = 0; bit < len * 8; bit++)
+    {
+        buf[bit / 8] ^= (uint8_t)(1u << (bit % 8));
+        config_defaults(&d);
+        CHECK(frame_decode_config(buf, (uint32_t)len, &out_hdr, &d) == -1);
+        CHECK(d.value[CONFIG_TICK] == CONFIG_TICK_DEFAULT);
+        buf[bit / 8] ^= (uint8_t)(1u << (bit % 8));
+    }
+    CHECK(frame_decode_config(buf, (uint32_t)len - 1, &out_hdr, &d) == -1);
+
+    /* Saved by an older firmware, knowing three settings */
+    buf[7] = 3;
+    reseal(buf, FRAME_CONFIG_LEN(3));
+    config_defaults(&d);
+    CHECK(frame_decode_config(buf, FRAME_CONFIG_LEN(3), &out_hdr, &d) == 3);
+    CHECK(frame_decode_config(buf, FRAME_CONFIG_LEN(4), &out_hdr, &d) == -1);
+    for (key = 0; key < CONFIG_KEYS; key++)
+    {
+        CHECK(d.value[key] == (key < 3 ? c.value[key] : limits[key][0]));
+    }
+
+    /* With the periods in seconds, out of range now */
+    config_defaults(&c);
+    c.value[CONFIG_TICK] = 5;
+    c.value[CONFIG_ACC_TICK] = 5;
+    c.value[CONFIG_INACTIVE] = 1200;
+    len = frame_encode_config(&hdr, &c, buf, sizeof(buf));
+    config_defaults(&d);
+    CHECK(frame_decode_config(buf, (uint32_t)len, &out_hdr, &d) ==
+          CONFIG_KEYS - 2);
+    CHECK(d.value[CONFIG_TICK] == CONFIG_TICK_DEFAULT);
+    CHECK(d.value[CONFIG_ACC_TICK] == CONFIG_ACC_TICK_DEFAULT);
+    CHECK(d.value[CONFIG_INACTIVE] == 1200);
+
+    /* An erased flash row */
+    memset(buf, 0xFF, sizeof(buf));
+    CHECK(frame_decode_config(buf, sizeof(buf), &out_hdr, &d) == -1);
+    memset(buf, 0, sizeof(buf));
+    CHECK(frame_decode_config(buf, sizeof(buf), &out_hdr, &d) == -1);
+}
+
+static void test_commands(void)
+{
+    uint8_t cmd[FRAME_SET_LEN];
+    struct config seen;
+    int32_t value, expected;
+    int key;
+
+    config_defaults(&settings);
+
+    CHECK(frame_encode_set(CONFIG_CRIT_TEMP, -12, cmd) == FRAME_SET_LEN);
+    CHECK(cmd[0] == FRAME_CMD_SET && cmd[1] == CONFIG_CRIT_TEMP);
+    CHECK(frame_decode_set(cmd, FRAME_SET_LEN, &key, &value) == 0);
+    CHECK(key == CONFIG_CRIT_TEMP && value == -12);
+    CHECK(frame_decode_set(cmd, FRAME_SET_LEN - 1, &key, &value) == -1);
+    CHECK(frame_decode_set(cmd, FRAME_SET_LEN + 1, &key, &value) == -1);
+
+    /* Every setting, across its whole range; out of it, the setting keeps
+       the value it had */
+    for (key = 0; key < CONFIG_KEYS; key++)
+    {
+        expected = settings.value[key];
+        for (value = limits[key][1] - 1; value <= limits[key][2] + 1;
+             value += (limits[key][2] - limits[key][1]) / 7 + 1)
+        {
+            if (value >= limits[key][1] && value <= limits[key][2])
+            {
+                expected = value;
+            }
+            frame_encode_set(key, value, cmd);
+            CHECK(ask(cmd, FRAME_SET_LEN, &seen) == CONFIG_KEYS);
+            CHECK(memcmp(&seen, &settings, sizeof(seen)) == 0);
+            CHECK(seen.value[key] == expected);
+        }
+        frame_encode_set(key, limits[key][2] + 1, cmd);
+        CHECK(ask(cmd, FRAME_SET_LEN, &seen) == CONFIG_KEYS);
+        CHECK(seen.value[key] == expected);
+    }
+
+    /* Unknown keys change nothing, but still answer */
+    seen = settings;
+    frame_encode_set(CONFIG_KEYS, 1, cmd);
+    CHECK(ask(cmd, FRAME_SET_LEN, &seen) == CONFIG_KEYS);
+    CHECK(memcmp(&seen, &settings, sizeof(seen)) == 0);
+
+    cmd[0] = FRAME_CMD_GET;
+    CHECK(ask(cmd, 1, &seen) == CONFIG_KEYS);
+    CHECK(memcmp(&seen, &settings, sizeof(seen)) == 0);
+    CHECK(ask(cmd, 2, &seen) == -1);
+
+    cmd[0] = FRAME_CMD_DEFAULTS;
+    CHECK(ask(cmd, 1, &seen) == CONFIG_KEYS);
+    for (key = 0; key < CONFIG_KEYS; key++)
+    {
+        CHECK(seen.value[key] == limits[key][0]);
+    }
+
+    cmd[0] = 0x7F;
+    CHECK(ask(cmd, 1, &seen) == -1);
+}
+
+int main(void)
+{
+    test_limits();
+    test_frames();
+    test_commands();
+    return test_done("config");
+}
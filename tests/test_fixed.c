@@ -0,0 +1,201 @@
+/*
+ * Fixed-point conversion test
+ *
+ * The temperature conversion against the datasheet formula for every TEMP
+ * code, and the happy score bit for bit against exact rational arithmetic,
+ * with the targets Process.h uses: exhaustively along both caps and at
+ * random over the whole range the targets leave room for. Against the
+ * float code it replaced, over light averages 0 to 60000 and temperatures
+ * -66.90 to 137.85 C, it may only differ by a point, and only where the
+ * exact score is a hair from a whole number, which the float rounding
+ * error can cross.
+ */
+
+#include "test.h"
+
+#include <math.h>
+
+#include "Fixed.h"
+
+/* Process.h: 200 light counts with 8 fractional bits, 25.00 C */
+#define LIGHT_TARGET    (512)
+#define TEMP_TARGET     (25)
+#define COMMON          (100)
+#define LIGHT_FULL      (LIGHT_TARGET * COMMON)
+#define TEMP_FULL       (TEMP_TARGET * COMMON)
+
+#define AVG_MIN         (-65536)
+#define RANDOM_PAIRS    (2000000)
+
+/* Light averages 0 to 60000, every LIGHT_STRIDE, temperatures -66.90 to
+   137.85 C */
+#define LIGHT_STRIDE    (61)
+#define TEMP_MIN        (-6690)
+#define TEMP_MAX        (13785)
+
+/* (min(light, full) / full + min(temp, full) / full) * 50, truncated */
+static int32_t reference(int32_t light, int32_t temp)
+{
+    int64_t l = light < LIGHT_FULL ? light : LIGHT_FULL;
+    int64_t t = temp < TEMP_FULL ? temp : TEMP_FULL;
+
+    return (int32_t)(50 * (l * TEMP_FULL + t * LIGHT_FULL) /
+                     ((int64_t)LIGHT_FULL * TEMP_FULL));
+}
+
+/* The float code of Process.h, in the units Fixed.h takes */
+static int float_score(int32_t light, int32_t temp)
+{
+    float light_score = (float)light / 256 / 200 * 100.0f;
+    float temp_score = (float)temp / 100 / 25 * 100.0f;
+
+    if (light_score > 100.0f)
+    {
+        light_score = 100.0f;
+    }
+    if (temp_score > 100.0f)
+    {
+        temp_score = 100.0f;
+    }
+    return (int)((light_score + temp_score) / 2.0f);
+}
+
+static void test_temp(void)
+{
+    int raw;
+
+    for (raw = 0; raw < 4096; raw++)
+    {
+        CHECK(fixed_temp_cdeg((uint16_t)raw) ==
+              lround((raw * 0.05 - 66.9) * 100.0));
+    }
+}
+
+static int check_score(int32_t light, int32_t temp)
+{
+    int32_t got = fixed_happy_score(light, LIGHT_TARGET, temp, TEMP_TARGET,
+                                    COMMON);
+
+    if (got != reference(light, temp))
+    {
+        printf("light %ld temp %ld: %ld, expected %ld\n", (long)light,
+               (long)temp, (long)got, (long)reference(light, temp));
+        test_failures++;
+        return 1;
+    }
+    return 0;
+}
+
+static void test_score(void)
+{
+    static const int32_t temps[] = { AVG_MIN, -6690, -1, 0, 1, 1249, 1250,
+                                     TEMP_FULL - 1, TEMP_FULL, TEMP_FULL + 1,
+                                     13785 };
+    static const int32_t lights[] = { AVG_MIN, -1, 0, 1, 25599, 25600,
+                                      LIGHT_FULL - 1, LIGHT_FULL,
+                                      LIGHT_FULL + 1, 0x7FFFFF };
+    uint32_t seed = 9u;
+    int32_t light, temp;
+    int i, j;
+
+    for (i = 0; i < (int)(sizeof(temps) / sizeof(temps[0])); i++)
+    {
+        for (light = AVG_MIN; light <= 2 * LIGHT_FULL; light++)
+        {
+            if (check_score(light, temps[i]))
+            {
+                return;
+            }
+        }
+    }
+    for (j = 0; j < (int)(sizeof(lights) / sizeof(lights[0])); j++)
+    {
+        for (temp = AVG_MIN; temp <= 2 * TEMP_FULL; temp++)
+        {
+            if (check_score(lights[j], temp))
+            {
+                return;
+            }
+        }
+    }
+    for (i = 0; i < RANDOM_PAIRS; i++)
+    {
+        light = AVG_MIN + (int32_t)(test_rand(&seed) % (0x7FFFFF - AVG_MIN));
+        temp = AVG_MIN + (int32_t)(test_rand(&seed) % (20000 - AVG_MIN));
+        if (check_score(light, temp))
+        {
+            return;
+        }
+    }
+
+    /* The range BLE.h clamps to 0 to 100 for the frames: no lower than
+       dark at the lowest TEMP reading */
+    CHECK(fixed_happy_score(LIGHT_FULL, LIGHT_TARGET, TEMP_FULL, TEMP_TARGET,
+                            COMMON) == 100);
+    CHECK(fixed_happy_score(0, LIGHT_TARGET, fixed_temp_cdeg(0), TEMP_TARGET,
+                            COMMON) == -133);
+
+    /* Any common divisor of the targets gives the same score */
+    for (i = 0; i < RANDOM_PAIRS / 10; i++)
+    {
+        light = (int32_t)(test_rand(&seed) % (2 * LIGHT_FULL));
+        temp = (int32_t)(test_rand(&seed) % (2 * TEMP_FULL));
+        CHECK(fixed_happy_score(light, 1024, temp, 50, 50) ==
+              reference(light, temp));
+        CHECK(fixed_happy_score(light, 2560, temp, 125, 20) ==
+              reference(light, temp));
+    }
+}
+
+static void test_float(void)
+{
+    const int64_t den = (int64_t)LIGHT_FULL * TEMP_FULL;
+    uint32_t pairs = 0, differ = 0;
+    int64_t l, t, rem;
+    int32_t light, temp;
+    int diff;
+
+    CHECK(fixed_happy_score(3584, LIGHT_TARGET, 1325, TEMP_TARGET,
+                            COMMON) == 30);
+    CHECK(float_score(3584, 1325) == 29);
+
+    for (light = 0; light <= 60000; light += LIGHT_STRIDE)
+    {
+        for (temp = TEMP_MIN; temp <= TEMP_MAX; temp++)
+        {
+            pairs++;
+            diff = fixed_happy_score(light, LIGHT_TARGET, temp, TEMP_TARGET,
+                                     COMMON) - float_score(light, temp);
+            if (diff == 0)
+            {
+                continue;
+            }
+            differ++;
+
+            /* Within 10^-4 of a whole number, exactly */
+            l = light < LIGHT_FULL ? light : LIGHT_FULL;
+            t = temp < TEMP_FULL ? temp : TEMP_FULL;
+            rem = 50 * (l * TEMP_FULL + t * LIGHT_FULL) % den;
+            rem = rem < 0 ? -rem : rem;
+            rem = rem < den - rem ? rem : den - rem;
+            if ((diff != 1 && diff != -1) || rem * 10000 >= den)
+            {
+                printf("light %ld temp %ld: %d off the float code\n",
+                       (long)light, (long)temp, diff);
+                test_failures++;
+                return;
+            }
+        }
+    }
+    CHECK(differ > 0 && differ < pairs / 1000u);
+    printf("fixed: %u of %u scores a point off the float code\n", differ,
+           pairs);
+}
+
+int main(void)
+{
+    test_temp();
+    test_score();
+    test_float();
+    return test_done("fixed");
+}
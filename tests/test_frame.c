@@ -0,0 +1,187 @@
+/*
+ * Frame codec test
+ *
+ * The CRC against its catalogue check value and a bitwise reference, then
+ * report frames: the documented byte layout, a round trip at the extremes
+ * of every field, and rejection of every single bit error, of truncated
+ * frames and of unknown versions. Brief frames round trip and fit the 20
+ * bytes of a notification at the default MTU. Sync commands round trip
+ * too.
+ */
+
+#include "test.h"
+
+#include <string.h>
+
+#include "Frame.h"
+
+/* Bit by bit, straight from the definition */
+static uint16_t crc_reference(const uint8_t *buf, uint32_t len)
+{
+    uint16_t crc = 0xFFFF;
+    uint32_t i;
+    int bit;
+
+    for (i = 0; i < len; i++)
+    {
+        crc ^= (uint16_t)(buf[i] << 8);
+        for (bit = 0; bit < 8; bit++)
+        {
+            crc = crc & 0x8000 ? (uint16_t)((crc << 1) ^ 0x1021) :
+                  (uint16_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+static void test_crc(void)
+{
+    uint8_t buf[300];
+    uint32_t seed = 20u;
+    int i, len;
+
+    CHECK(frame_crc16((const uint8_t *)"123456789", 9) == 0x29B1);
+    CHECK(frame_crc16(buf, 0) == 0xFFFF);
+    for (len = 1; len < (int)sizeof(buf); len += 7)
+    {
+        for (i = 0; i < len; i++)
+        {
+            buf[i] = (uint8_t)test_rand(&seed);
+        }
+        CHECK(frame_crc16(buf, (uint32_t)len) ==
+              crc_reference(buf, (uint32_t)len));
+    }
+}
+
+static void test_report(void)
+{
+    static const struct frame_report extremes[] = {
+        { { 0, 0, 0 }, 0, 0, { -32768, -32768, -32768 }, 0, 0 },
+        { { 65535, 65535, 65535 }, 255, 65535, { 32767, 32767, 32767 },
+          255, 255 },
+        { { 0x1234, 0xABCD, 7 }, 19, 0x0FFF, { -1, 0, 1 }, 100,
+          FRAME_FLAG_LIGHT | FRAME_FLAG_PROVISIONAL },
+    };
+    struct frame_header hdr = { 9, 9, 0xBEEF, 0x01020304 }, out_hdr;
+    struct frame_report out;
+    uint8_t buf[FRAME_REPORT_LEN + 4];
+    int i, bit, len;
+
+    CHECK(frame_encode_report(&hdr, &extremes[0], buf,
+                              FRAME_REPORT_LEN - 1) == -1);
+    CHECK(frame_encode_report(NULL, &extremes[0], buf, sizeof(buf)) == -1);
+
+    for (i = 0; i < (int)(sizeof(extremes) / sizeof(extremes[0])); i++)
+    {
+        len = frame_encode_report(&hdr, &extremes[i], buf, sizeof(buf));
+        CHECK(len == FRAME_REPORT_LEN);
+        memset(&out, 0xA5, sizeof(out));
+        CHECK(frame_decode_report(buf, (uint32_t)len, &out_hdr, &out) == 0);
+        CHECK(out_hdr.version == FRAME_VERSION);
+        CHECK(out_hdr.type == FRAME_TYPE_REPORT);
+        CHECK(out_hdr.seq == hdr.seq && out_hdr.time == hdr.time);
+        CHECK(memcmp(out.light, extremes[i].light, sizeof(out.light)) == 0);
+        CHECK(out.exposure == extremes[i].exposure);
+        CHECK(out.temperature == extremes[i].temperature);
+        CHECK(memcmp(out.acc, extremes[i].acc, sizeof(out.acc)) == 0);
+        CHECK(out.happy_score == extremes[i].happy_score);
+        CHECK(out.flags == extremes[i].flags);
+    }
+
+    /* The layout of Frame.h, little endian */
+    len = frame_encode_report(&hdr, &extremes[2], buf, sizeof(buf));
+    CHECK(buf[0] == (FRAME_VERSION << 4 | FRAME_TYPE_REPORT));
+    CHECK(buf[1] == 0xEF && buf[2] == 0xBE);
+    CHECK(buf[3] == 0x04 && buf[6] == 0x01);
+    CHECK(buf[7] == 0x34 && buf[8] == 0x12);
+    CHECK(buf[13] == 19);
+    CHECK(buf[16] == 0xFF && buf[17] == 0xFF);
+    CHECK(buf[22] == 100 && buf[23] == extremes[2].flags);
+    CHECK(buf[24] == (frame_crc16(buf, 24) & 0xFF));
+    CHECK(buf[25] == frame_crc16(buf, 24) >> 8);
+
+    /* Every single bit error is caught */
+    for (bit = 0; bit < len * 8; bit++)
+    {
+        buf[bit / 8] ^= (uint8_t)(1u << (bit % 8));
+        CHECK(frame_decode_report(buf, (uint32_t)len, &out_hdr, &out) == -1);
+        buf[bit / 8] ^= (uint8_t)(1u << (bit % 8));
+    }
+    CHECK(frame_decode_report(buf, (uint32_t)len, &out_hdr, &out) == 0);
+    CHECK(frame_decode_report(buf, (uint32_t)len - 1, &out_hdr, &out) == -1);
+    CHECK(frame_decode_header(buf, FRAME_HEADER_LEN, &out_hdr) == -1);
+
+    /* A version this decoder does not know, however well formed */
+    buf[0] = (uint8_t)((FRAME_VERSION + 1) << 4 | FRAME_TYPE_REPORT);
+    buf[len - 2] = (uint8_t)frame_crc16(buf, (uint32_t)len - 2);
+    buf[len - 1] = (uint8_t)(frame_crc16(buf, (uint32_t)len - 2) >> 8);
+    CHECK(frame_decode_header(buf, (uint32_t)len, &out_hdr) == -1);
+}
+
+static void test_brief(void)
+{
+    static const struct frame_brief extremes[] = {
+        { 0, -32768, 0, 0 },
+        { 65535, 32767, 255, 255 },
+        { 0x1234, -1250, 100, FRAME_FLAG_TEMP | FRAME_FLAG_PROVISIONAL },
+    };
+    struct frame_header hdr = { 9, 9, 0xBEEF, 0x01020304 }, out_hdr;
+    struct frame_report report;
+    struct frame_brief out;
+    uint8_t buf[FRAME_REPORT_LEN];
+    int i, len;
+
+    CHECK(FRAME_BRIEF_LEN + 3 <= 23);
+    CHECK(frame_encode_brief(&hdr, &extremes[0], buf,
+                             FRAME_BRIEF_LEN - 1) == -1);
+    CHECK(frame_encode_brief(&hdr, NULL, buf, sizeof(buf)) == -1);
+
+    for (i = 0; i < (int)(sizeof(extremes) / sizeof(extremes[0])); i++)
+    {
+        len = frame_encode_brief(&hdr, &extremes[i], buf, sizeof(buf));
+        CHECK(len == FRAME_BRIEF_LEN);
+        memset(&out, 0xA5, sizeof(out));
+        CHECK(frame_decode_brief(buf, (uint32_t)len, &out_hdr, &out) == 0);
+        CHECK(out_hdr.type == FRAME_TYPE_BRIEF);
+        CHECK(out_hdr.seq == hdr.seq && out_hdr.time == hdr.time);
+        CHECK(out.light == extremes[i].light);
+        CHECK(out.temperature == extremes[i].temperature);
+        CHECK(out.happy_score == extremes[i].happy_score);
+        CHECK(out.flags == extremes[i].flags);
+    }
+
+    /* The layout of Frame.h */
+    CHECK(buf[0] == (FRAME_VERSION << 4 | FRAME_TYPE_BRIEF));
+    CHECK(buf[7] == 0x34 && buf[8] == 0x12);
+    CHECK(buf[9] == 0x1E && buf[10] == 0xFB);
+    CHECK(buf[11] == 100 && buf[12] == extremes[2].flags);
+
+    /* Neither is taken for the other */
+    CHECK(frame_decode_report(buf, (uint32_t)len, &out_hdr, &report) == -1);
+    CHECK(frame_decode_brief(buf, (uint32_t)len - 1, &out_hdr, &out) == -1);
+    buf[7] ^= 1;
+    CHECK(frame_decode_brief(buf, (uint32_t)len, &out_hdr, &out) == -1);
+}
+
+static void test_sync(void)
+{
+    uint8_t buf[FRAME_SYNC_LEN];
+    uint32_t since = 0;
+
+    CHECK(frame_encode_sync(0xDEADBEEF, buf) == FRAME_SYNC_LEN);
+    CHECK(buf[0] == FRAME_CMD_SYNC);
+    CHECK(frame_decode_sync(buf, FRAME_SYNC_LEN, &since) == 0);
+    CHECK(since == 0xDEADBEEF);
+    CHECK(frame_decode_sync(buf, FRAME_SYNC_LEN - 1, &since) == -1);
+    buf[0] = FRAME_CMD_SYNC + 1;
+    CHECK(frame_decode_sync(buf, FRAME_SYNC_LEN, &since) == -1);
+}
+
+int main(void)
+{
+    test_crc();
+    test_report();
+    test_brief();
+    test_sync();
+    return test_done("frame");
+}
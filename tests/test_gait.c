@@ -0,0 +1,155 @@
+/*
+ * Gait analysis test
+ *
+ * The kernels against double precision references computed straight from
+ * their definitions, then whole windows of synthetic gaits at the
+ * Process.h rate and length: the step frequency must be found across the
+ * search band, a sound gait must read regular with its energy in the even
+ * stride harmonics, a lame one must move it to the odd harmonics, and a
+ * still window must be turned down.
+ */
+
+#include "test.h"
+
+#include <math.h>
+
+#include "Gait.h"
+
+#define PI          (3.14159265358979323846)
+#define FS          (25.0f)     /* Process.h: ACC_ODR_HZ */
+#define LEN         (256)       /* Process.h: GAIT_LEN */
+#define MIN_RMS     (409.0f)    /* Process.h: 0.05 g */
+#define G           (8192.0)    /* Counts per g */
+
+static int16_t ax[LEN], ay[LEN], az[LEN];
+static uint32_t at[LEN];
+static float work[2 * LEN];
+
+static void test_kernels(void)
+{
+    static float x[LEN];
+    uint32_t seed = 15u;
+    double re, im, power, r0, r, expect;
+    float f;
+    int i, k, lag;
+
+    for (i = 0; i < LEN; i++)
+    {
+        x[i] = (float)((int)(test_rand(&seed) % 2001) - 1000);
+    }
+
+    /* |DFT|^2 at any frequency, on or off the bins */
+    for (k = 0; k < 50; k++)
+    {
+        f = 0.5f * k / 50;
+        for (i = 0, re = 0, im = 0; i < LEN; i++)
+        {
+            re += x[i] * cos(2 * PI * (double)f * i);
+            im -= x[i] * sin(2 * PI * (double)f * i);
+        }
+        power = re * re + im * im;
+        CHECK(fabs(gait_goertzel(x, LEN, f) - power) <= 1e-3 * power + 1.0);
+    }
+
+    for (i = 0, r0 = 0; i < LEN; i++)
+    {
+        r0 += (double)x[i] * x[i];
+    }
+    for (lag = 0; lag < LEN; lag += 17)
+    {
+        for (i = 0, r = 0; i + lag < LEN; i++)
+        {
+            r += (double)x[i] * x[i + lag];
+        }
+        expect = (r / (LEN - lag)) / (r0 / LEN);
+        CHECK(fabs(gait_autocorr(x, LEN, lag) - expect) <= 1e-4);
+    }
+    CHECK(gait_autocorr((float[4]){ 0 }, 4, 1) == 0.0f);
+}
+
+/*
+ * A walk: the magnitude rises with each step (twice per stride) and, with
+ * @limp, once per stride as one side lands harder. The collar sits tilted,
+ * so the signal spreads over all axes.
+ */
+static void walk(double stride, double limp, double noise, uint32_t seed)
+{
+    double w, a;
+    int i;
+
+    for (i = 0; i < LEN; i++)
+    {
+        w = 2 * PI * stride * i / FS;
+        a = 0.25 * sin(2 * w) + 0.08 * sin(4 * w + 0.3) + limp * sin(w) +
+            noise * ((int)(test_rand(&seed) % 2001) - 1000) / 1000.0;
+        ax[i] = (int16_t)(G * 0.3 * (1 + a));
+        ay[i] = (int16_t)(G * 0.1 * (1 + a));
+        az[i] = (int16_t)(G * 0.95 * (1 + a));
+        at[i] = (uint32_t)i;
+    }
+}
+
+static int analyze(struct gait_set *set)
+{
+    struct store_view view = { { ax, NULL }, { ay, NULL }, { az, NULL },
+                               { at, NULL }, { LEN, 0 } };
+
+    return gait_analyze(&view, FS, MIN_RMS, work, set);
+}
+
+static void test_windows(void)
+{
+    struct store_view view = { { ax, NULL }, { ay, NULL }, { az, NULL },
+                               { at, NULL }, { GAIT_MIN_LEN - 1, 0 } };
+    struct gait_set sound, lame, set;
+    double stride, worst = 0;
+    int i;
+
+    CHECK(gait_analyze(NULL, FS, MIN_RMS, work, &set) == -1);
+    CHECK(gait_analyze(&view, FS, MIN_RMS, work, &set) == -1);
+    view.len[0] = LEN;
+    CHECK(gait_analyze(&view, 0.0f, MIN_RMS, work, &set) == -1);
+
+    /* Standing still, only sensor noise */
+    for (i = 0; i < LEN; i++)
+    {
+        ax[i] = 0;
+        ay[i] = 0;
+        az[i] = (int16_t)(G + i % 7);
+        at[i] = (uint32_t)i;
+    }
+    CHECK(analyze(&set) == 1 && set.rms < MIN_RMS);
+
+    /* Steps of 1.1 to 3.8 Hz, found to a tenth of the 0.1 Hz bin */
+    for (stride = 0.55; stride <= 1.9; stride += 0.01)
+    {
+        walk(stride, 0.0, 0.02, 2u);
+        CHECK(analyze(&set) == 0);
+        CHECK(fabs(set.stride_freq - set.step_freq / 2) < 1e-6);
+        if (fabs(set.step_freq - 2 * stride) > worst)
+        {
+            worst = fabs(set.step_freq - 2 * stride);
+        }
+    }
+    CHECK(worst <= 0.01);
+
+    walk(0.9, 0.0, 0.02, 3u);
+    CHECK(analyze(&sound) == 0);
+    walk(0.9, 0.15, 0.02, 3u);
+    CHECK(analyze(&lame) == 0);
+    CHECK(fabs(sound.step_freq - 1.8) <= 0.01);
+    CHECK(fabs(lame.step_freq - 1.8) <= 0.01);
+    CHECK(sound.step_reg > 0.8 && sound.stride_reg > 0.8);
+    CHECK(sound.harmonic_ratio > 2.0);
+    CHECK(lame.harmonic_ratio < sound.harmonic_ratio / 10);
+    CHECK(lame.step_reg < sound.step_reg);
+    printf("gait: step within %.3f Hz, harmonic ratio %.2f sound, %.2f lame\n",
+           worst, sound.harmonic_ratio, lame.harmonic_ratio);
+}
+
+int main(void)
+{
+    test_kernels();
+    test_windows();
+    return test_done("gait");
+}
@@ -0,0 +1,194 @@
+/*
+ * History sync test
+ *
+ * A simulated GATT client syncs the history through history frames, the
+ * way bleSendHistory() serves them: as many records as fit the MTU, then
+ * an empty frame. At every MTU from the smallest that fits a record to the
+ * largest, with sequence numbers wrapping and records added and evicted
+ * while the sync is in progress, the client must receive every record kept
+ * exactly once, in order, and only ever skip records that were evicted.
+ */
+
+#include "test.h"
+
+#include "Frame.h"
+#include "History.h"
+
+#define CAPACITY            (64)
+#define SYNC_BATCH          (16)        // BLE_SYNC_BATCH
+#define MTU_MIN             (FRAME_HISTORY_LEN(1) + 3)
+#define MTU_MAX             (247)       // CY_BLE_GATT_MTU
+#define FIRST_SEQ           (0xFFFFFFC0u)
+
+static struct history_record buf[CAPACITY];
+static struct history h;
+
+/* Every field follows from the sequence number, for the client to check */
+static struct history_record make_record(uint32_t seq)
+{
+    struct history_record r;
+
+    r.seq = 0;
+    r.time = seq * 60u;
+    r.light = (uint16_t)(seq * 7u);
+    r.temperature = (int16_t)(seq * 13u);
+    r.odba = (uint16_t)(seq ^ 0x5A5Au);
+    r.happy_score = (uint8_t)seq;
+    r.flags = (uint8_t)(seq >> 8);
+    r.behaviour = (int8_t)(seq % 5u) - 1;
+    r.posture = (int8_t)(seq % 3u);
+    return r;
+}
+
+static int same_record(const struct history_record *a, uint32_t seq)
+{
+    struct history_record b = make_record(seq);
+
+    return a->seq == seq && a->time == b.time && a->light == b.light &&
+           a->temperature == b.temperature && a->odba == b.odba &&
+           a->happy_score == b.happy_score && a->flags == b.flags &&
+           a->behaviour == b.behaviour && a->posture == b.posture;
+}
+
+static void add(void)
+{
+    struct history_record r = make_record(history_next_seq(&h));
+
+    CHECK(history_add(&h, &r) == 0);
+}
+
+/* The collar side, bleSendHistory() without the stack */
+static int serve(uint32_t *next, int mtu, uint8_t *frame)
+{
+    struct history_record recs[SYNC_BATCH];
+    struct frame_header hdr = { FRAME_VERSION, FRAME_TYPE_HISTORY, 0, 0 };
+    int max, n;
+
+    max = (mtu - 3 - FRAME_HISTORY_LEN(0)) / FRAME_HISTORY_RECORD_LEN;
+    if (max > SYNC_BATCH)
+    {
+        max = SYNC_BATCH;
+    }
+    n = history_read(&h, *next, recs, max);
+    if (n > 0)
+    {
+        *next = recs[n - 1].seq + 1u;
+    }
+    return frame_encode_history(&hdr, recs, n, frame,
+                                FRAME_HISTORY_LEN(SYNC_BATCH));
+}
+
+/*
+ * Sync from @since, adding a record every @every frames (never if 0, at
+ * least 2 for the sync to ever catch up).
+ * Returns the number of records received.
+ */
+static int sync(uint32_t since, int mtu, int every)
+{
+    struct history_record got[SYNC_BATCH];
+    struct frame_header hdr;
+    uint8_t frame[FRAME_HISTORY_LEN(SYNC_BATCH)];
+    uint32_t next = since, expected = since;
+    int frames, total = 0, len, n = -1, i;
+
+    /* Ends, records being added slower than they are sent */
+    for (frames = 1; frames < 100000; frames++)
+    {
+        len = serve(&next, mtu, frame);
+        CHECK(len >= FRAME_HISTORY_LEN(0) && len <= mtu - 3);
+        n = frame_decode_history(frame, (uint32_t)len, &hdr, got, SYNC_BATCH);
+        CHECK(n >= 0 && hdr.type == FRAME_TYPE_HISTORY);
+        if (n <= 0)
+        {
+            break;
+        }
+
+        /* Records skipped must have been evicted: the frame then starts at
+           the oldest one kept */
+        if (got[0].seq != expected)
+        {
+            CHECK(history_length(&h) == CAPACITY);
+            CHECK(got[0].seq == history_next_seq(&h) - CAPACITY);
+            CHECK(got[0].seq - since > expected - since);
+        }
+        for (i = 0; i < n; i++)
+        {
+            CHECK(same_record(&got[i], got[0].seq + (uint32_t)i));
+        }
+        expected = got[n - 1].seq + 1u;
+        total += n;
+
+        if (every && frames % every == 0)
+        {
+            add();
+        }
+    }
+
+    /* Caught up with the newest record */
+    CHECK(n == 0);
+    CHECK(total == 0 || expected == history_next_seq(&h));
+    return total;
+}
+
+static void test_edges(void)
+{
+    struct history_record r = make_record(0), out[1];
+
+    CHECK(history_init(NULL, buf, CAPACITY, 0) == -1);
+    CHECK(history_init(&h, NULL, CAPACITY, 0) == -1);
+    CHECK(history_init(&h, buf, 0, 0) == -1);
+    CHECK(history_init(&h, buf, CAPACITY, FIRST_SEQ) == 0);
+    CHECK(history_add(NULL, &r) == -1);
+    CHECK(history_add(&h, NULL) == -1);
+    CHECK(history_read(&h, 0, NULL, 1) == -1);
+    CHECK(history_read(&h, 0, out, -1) == -1);
+    CHECK(history_read(&h, FIRST_SEQ, out, 1) == 0);
+    CHECK(history_length(NULL) == -1);
+    CHECK(history_length(&h) == 0);
+    CHECK(history_next_seq(&h) == FIRST_SEQ);
+    CHECK(sync(FIRST_SEQ, MTU_MAX, 0) == 0);
+}
+
+static void test_sync(void)
+{
+    uint32_t first, mid, next;
+    int mtu, i;
+
+    for (mtu = MTU_MIN; mtu <= MTU_MAX; mtu++)
+    {
+        history_init(&h, buf, CAPACITY, FIRST_SEQ + (uint32_t)mtu);
+
+        /* Partly full, the sequence numbers about to wrap */
+        for (i = 0; i < CAPACITY / 2; i++)
+        {
+            add();
+        }
+        first = FIRST_SEQ + (uint32_t)mtu;
+        CHECK(sync(first, mtu, 0) == CAPACITY / 2);
+        CHECK(sync(first + 5u, mtu, 0) == CAPACITY / 2 - 5);
+        CHECK(sync(history_next_seq(&h), mtu, 0) == 0);
+        CHECK(sync(history_next_seq(&h) + 1000u, mtu, 0) == 0);
+
+        /* Full, wrapped, the first records long evicted */
+        for (i = 0; i < 3 * CAPACITY; i++)
+        {
+            add();
+        }
+        next = history_next_seq(&h);
+        CHECK(next - first == 7u * CAPACITY / 2);
+        CHECK(sync(first, mtu, 0) == CAPACITY);
+        mid = next - CAPACITY / 4;
+        CHECK(sync(mid, mtu, 0) == CAPACITY / 4);
+
+        /* Records added during the sync are sent by the same sync */
+        CHECK(sync(next - CAPACITY, mtu, 2) >= CAPACITY);
+        CHECK(sync(mid, mtu, 3) > 0);
+    }
+}
+
+int main(void)
+{
+    test_edges();
+    test_sync();
+    return test_done("history");
+}
@@ -0,0 +1,173 @@
+/*
+ * I2C engine test
+ *
+ * I2C_Async.h on the fake bus, with a plain register file slave. Jobs must
+ * take one transaction each and no delay. A slave that NAKs once is
+ * retried after the backoff, as is a bus that refuses to start; one that
+ * keeps NAKing is given up on after I2C_MAX_RETRIES, failing its job
+ * alone: the job queued behind it still runs.
+ */
+
+#include "test.h"
+
+#include "fake_bus.h"
+
+#define SLAVE       (0x68u)
+#define ABSENT      (0x50u)
+
+static uint8_t regs[256];
+
+static void reg_write(uint8_t reg, const uint8_t *data, uint32_t len)
+{
+    while (len--)
+    {
+        regs[reg++] = *data++;
+    }
+}
+
+static void reg_read(uint8_t reg, uint8_t *data, uint32_t len)
+{
+    while (len--)
+    {
+        *data++ = regs[reg++];
+    }
+}
+
+static struct fake_slave slave = { SLAVE, reg_write, reg_read, 0, 0 };
+
+/* Jobs in the order they completed */
+static struct i2c_job *done[4];
+static int dones;
+
+static void job_done(struct i2c_job *job)
+{
+    if (dones < 4)
+    {
+        done[dones] = job;
+    }
+    dones++;
+}
+
+static void job_read(struct i2c_job *job, uint8_t addr, uint8_t reg,
+                     uint8_t *buf, uint32_t len)
+{
+    memset(job, 0, sizeof(*job));
+    job->addr = addr;
+    job->wbuf[0] = reg;
+    job->wlen = 1u;
+    job->rx = buf;
+    job->rxLen = len;
+    job->done = job_done;
+}
+
+/* i2cStats since the last call */
+static struct i2c_stats last;
+static struct i2c_stats stats(void)
+{
+    struct i2c_stats d = {
+        i2cStats.jobs - last.jobs,
+        i2cStats.errors - last.errors,
+        i2cStats.retries - last.retries,
+        i2cStats.failures - last.failures,
+    };
+
+    last = i2cStats;
+    return d;
+}
+
+static void start(void)
+{
+    fake_bus_init(&slave, 1);
+    fake_psoc.delays = 0;
+    dones = 0;
+    stats();
+}
+
+static void test_ok(void)
+{
+    const uint8_t data[3] = { 0x11, 0x22, 0x33 };
+    uint8_t buf[3] = { 0 };
+    struct i2c_stats d;
+
+    start();
+    CHECK(i2cWriteRegs(SLAVE, 0x10, data, 3u) == I2C_JOB_DONE);
+    CHECK(i2cReadRegs(SLAVE, 0x10, buf, 3u) == I2C_JOB_DONE);
+    CHECK(memcmp(buf, data, 3u) == 0);
+    d = stats();
+    CHECK(fake_bus.transactions == 2u && fake_psoc.delays == 0u);
+    CHECK(d.jobs == 2u && d.errors == 0u && d.retries == 0u);
+    CHECK(i2cWriteRegs(SLAVE, 0, buf, I2C_TX_MAX + 1u) == I2C_JOB_FAILED);
+    CHECK(fake_bus.transactions == 2u);
+}
+
+static void test_retry(void)
+{
+    uint8_t buf[2] = { 0 };
+    struct i2c_stats d;
+
+    /* A NAK, then the retry goes through */
+    start();
+    regs[0x20] = 0xab;
+    regs[0x21] = 0xcd;
+    slave.naks = 1u;
+    CHECK(i2cReadRegs(SLAVE, 0x20, buf, 2u) == I2C_JOB_DONE);
+    CHECK(buf[0] == 0xab && buf[1] == 0xcd);
+    d = stats();
+    CHECK(d.errors == 1u && d.retries == 1u && d.failures == 0u);
+    CHECK(fake_bus.naks == 1u && fake_bus.transactions == 2u);
+    CHECK(fake_psoc.delays == 1u);
+
+    /* The bus refuses to start twice, then takes the job */
+    start();
+    fake_bus.refuse = 2u;
+    CHECK(i2cReadRegs(SLAVE, 0x20, buf, 2u) == I2C_JOB_DONE);
+    d = stats();
+    CHECK(d.errors == 2u && d.retries == 2u && d.failures == 0u);
+    CHECK(fake_bus.transactions == 1u && fake_psoc.delays == 2u);
+}
+
+static void test_give_up(void)
+{
+    struct i2c_job job, next;
+    uint8_t buf[2], next_buf[1];
+    struct i2c_stats d;
+
+    /* Out of retries, the job fails with the NAK */
+    start();
+    slave.naks = 100u;
+    job_read(&job, SLAVE, 0x20, buf, 2u);
+    CHECK(i2cAsyncSubmit(&job) == 0);
+    CHECK(i2cAsyncWait(&job) == I2C_JOB_FAILED);
+    CHECK(job.error == FAKE_BUS_NAK && job.retries == 1u + I2C_MAX_RETRIES);
+    d = stats();
+    CHECK(d.errors == 1u + I2C_MAX_RETRIES && d.retries == I2C_MAX_RETRIES);
+    CHECK(d.failures == 1u);
+    CHECK(fake_bus.transactions == 1u + I2C_MAX_RETRIES);
+    CHECK(fake_psoc.delays == I2C_MAX_RETRIES);
+    CHECK(dones == 1 && done[0] == &job);
+    slave.naks = 0;
+
+    /* A slave missing from the bus fails alone, the next job runs */
+    start();
+    regs[0x30] = 0x5a;
+    job_read(&job, ABSENT, 0x00, buf, 2u);
+    job_read(&next, SLAVE, 0x30, next_buf, 1u);
+    CHECK(i2cAsyncSubmit(&job) == 0 && i2cAsyncSubmit(&next) == 0);
+    CHECK(i2cAsyncWait(&next) == I2C_JOB_DONE);
+    CHECK(job.status == I2C_JOB_FAILED && next_buf[0] == 0x5a);
+    CHECK(dones == 2 && done[0] == &job && done[1] == &next);
+    d = stats();
+    CHECK(d.jobs == 2u && d.failures == 1u);
+    CHECK(fake_bus.transactions == 1u + I2C_MAX_RETRIES + 1u);
+}
+
+int main(void)
+{
+    fake_irq = fake_bus_irq;
+    i2cAsyncInit();
+
+    test_ok();
+    test_retry();
+    test_give_up();
+    return test_done("i2c_async");
+}
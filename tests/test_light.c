@@ -0,0 +1,171 @@
+/*
+ * Light sensor read-out test
+ *
+ * Light.h on the fake bus, with a register model of the AS73211: the
+ * output bank reads OSR and STATUS a byte each, then TEMP and the three
+ * channels LSB first, and a conversion finishing raises READY. Reading
+ * TEMP and MRES1..3 one register at a time takes 4 transactions; the burst
+ * of lightReadResults() must take 1, decode the same values, and wait on
+ * no delay. A whole measurement is one transaction too, unless the
+ * exposure changes. Without READY, collecting it counts a miss and leaves
+ * the last results alone.
+ */
+
+#include "test.h"
+
+#include "fake_bus.h"
+#include "Light.h"
+
+/* AS73211: output bank image, from OSR on, and the registers written */
+static uint8_t out[RESULT_BURST_LEN];
+static uint8_t conf[16];
+static uint32_t conversions;
+
+/* Next conversion */
+static uint8_t next_status = STATUS_NDATA;
+static uint16_t next_z = 300u;
+
+static void as_set(uint8_t status, uint16_t temp, uint16_t x, uint16_t y,
+                   uint16_t z)
+{
+    const uint16_t word[4] = { temp, x, y, z };
+    int i;
+
+    out[1] = status;
+    for (i = 0; i < 4; i++)
+    {
+        out[2 + 2 * i] = (uint8_t)word[i];
+        out[3 + 2 * i] = (uint8_t)(word[i] >> 8);
+    }
+}
+
+/* OSR is a byte, TEMP on are 16 bit registers */
+static void as_read(uint8_t reg, uint8_t *data, uint32_t len)
+{
+    uint32_t at = reg == OSR ? 0u : 2u * reg, i;
+
+    out[0] = conf[OSR];
+    for (i = 0; i < len; i++)
+    {
+        data[i] = at + i < RESULT_BURST_LEN ? out[at + i] : 0u;
+    }
+}
+
+static void as_write(uint8_t reg, const uint8_t *data, uint32_t len)
+{
+    CHECK(len == 1u && reg < sizeof(conf));
+    conf[reg] = data[0];
+}
+
+static struct fake_slave as = { LIGHT_ADDRESS, as_write, as_read, 0, 0 };
+
+/* The conversion in progress ends, READY interrupts if armed */
+static void convert(void)
+{
+    conversions++;
+    as_set(next_status, 0x0123, 400u + conversions, 500u, next_z);
+    GPIO_PRT9->intr |= 1u << LIGHT_READY_PIN;
+    if (GPIO_PRT9->mask & (1u << LIGHT_READY_PIN))
+    {
+        lightReadyInterruptHandler();
+    }
+}
+
+static void test_readout(void)
+{
+    struct light_result res;
+    uint16_t temp, x, y, z;
+
+    as_set(STATUS_NDATA, 0x0abc, 0x1234, 0x00ff, 0xfe01);
+
+    /* Register by register, as before the burst */
+    fake_bus_init(&as, 1);
+    temp = lightI2CRead(TEMP);
+    x = lightI2CRead(MRES1);
+    y = lightI2CRead(MRES2);
+    z = lightI2CRead(MRES3);
+    CHECK(fake_bus.transactions == 4u);
+    CHECK(temp == 0x0abc && x == 0x1234 && y == 0x00ff && z == 0xfe01);
+
+    fake_bus_init(&as, 1);
+    fake_psoc.delays = 0;
+    CHECK(lightReadResults(&res) == I2C_JOB_DONE);
+    CHECK(fake_bus.transactions == 1u);
+    CHECK(fake_bus.bytes == 1u + 1u + 1u + RESULT_BURST_LEN);
+    CHECK(fake_psoc.delays == 0u);
+    CHECK(res.osr == OSR_START_MEAS && res.status == STATUS_NDATA);
+    CHECK(res.temperature == temp && res.x == x && res.y == y && res.z == z);
+
+    /* A failed read leaves the results alone */
+    as.naks = 1u + I2C_MAX_RETRIES;
+    res.x = 7u;
+    CHECK(lightReadResults(&res) == I2C_JOB_FAILED);
+    CHECK(res.x == 7u);
+    as.naks = 0;
+}
+
+static void test_measure(void)
+{
+    uint16_t x = 0, y = 0, z = 0, temp = 0;
+    uint8_t exp = 0;
+
+    /* In range, a single transaction */
+    fake_bus_init(&as, 1);
+    fake_psoc.delays = 0;
+    convert();
+    lightArm();
+    CHECK(!lightReadyFlag);
+    convert();
+    CHECK(lightCollect(&x, &y, &z, &temp, &exp) == 0);
+    CHECK(conversions == 2u && lightStats.samples == 1u);
+    CHECK(fake_bus.transactions == 1u && fake_psoc.delays == 0u);
+    CHECK(x == 402u && y == 500u && z == 300u && temp == 0x0123);
+    CHECK(exp == LIGHT_EXP_DEFAULT);
+    CHECK(!(GPIO_PRT9->mask & (1u << LIGHT_READY_PIN)));
+
+    /* Saturated, CREG1 is rewritten in the configuration state */
+    next_status = STATUS_MRESOF;
+    next_z = 0xffffu;
+    fake_bus_init(&as, 1);
+    lightArm();
+    convert();
+    CHECK(lightCollect(&x, &y, &z, &temp, &exp) == 0);
+    CHECK(z == 0xffffu && exp == LIGHT_EXP_DEFAULT);
+    CHECK(lightRange.exp < LIGHT_EXP_DEFAULT);
+    CHECK(fake_bus.transactions == 1u + 3u && fake_psoc.delays == 0u);
+    CHECK(conf[CREG1] == light_range_creg1(lightRange.exp));
+    CHECK(conf[OSR] == OSR_START_MEAS);
+
+    /* READY missed, nothing read, nothing written */
+    fake_bus_init(&as, 1);
+    lightArm();
+    CHECK(lightCollect(&x, &y, &z, &temp, &exp) == -1);
+    CHECK(lightStats.missed == 1u && lightStats.samples == 2u);
+    CHECK(fake_bus.transactions == 0u && z == 0xffffu);
+    CHECK(!(GPIO_PRT9->mask & (1u << LIGHT_READY_PIN)));
+}
+
+static void test_timeout(void)
+{
+    /* Two cycles of TCONV and TBREAK, and a tick */
+    light_range_init(&lightRange, LIGHT_EXP_DEFAULT);
+    CHECK(lightReadyTimeout() == 2u * 1u + 5u + 1u);
+    light_range_init(&lightRange, LIGHT_EXP_MAX);
+    CHECK(lightReadyTimeout() == 2u * 256u + 5u + 1u);
+}
+
+int main(void)
+{
+    fake_irq = fake_bus_irq;
+    fake_bus_init(&as, 1);
+    i2cAsyncInit();
+    lightInit();
+    CHECK(conf[OSR] == OSR_START_MEAS);
+    CHECK(conf[CREG3] == (CREG3_MMODE_CONT | CREG3_CCLK_1MHZ));
+    CHECK(fake_bus.transactions == 5u && fake_psoc.delays == 0u);
+
+    test_readout();
+    test_measure();
+    test_timeout();
+    return test_done("light");
+}
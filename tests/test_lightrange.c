@@ -0,0 +1,177 @@
+/*
+ * Light auto-ranging test
+ *
+ * A model of the AS73211 under a given irradiance, in counts at the
+ * default exposure: counts scale with 2^exp and clip at the full scale of
+ * the conversion time, raising an overflow bit. A slow ramp from 0.01 to
+ * 120000 default counts and back must never saturate nor hunt, random
+ * steps must settle within a few samples, and the normalized result must
+ * read the irradiance back.
+ */
+
+#include "test.h"
+
+#include <math.h>
+
+#include "LightRange.h"
+
+#define IRR_MIN         (0.01)
+#define IRR_MAX         (120000.0)
+#define RAMP_RATE       (1.02)      /* Irradiance change per sample */
+#define STEPS           (20000)
+/* Samples to settle after a step. Bright steps drop 4 exposures a sample
+ * while the sensor overflows, then walk down the conversion times one at a
+ * time: there the full scale follows the time, so the peak stays the same
+ * fraction of it until the gain drops */
+#define MAX_SETTLE      (8)
+
+struct sample
+{
+    uint16_t peak;
+    uint8_t status;
+};
+
+static uint32_t full_scale(int exp)
+{
+    int time = exp > 11 ? exp - 11 : 0;
+
+    return time >= 6 ? 0xFFFFu : (1024u << time) - 1u;
+}
+
+static struct sample measure(int exp, double irr)
+{
+    double counts = irr * ldexp(1.0, exp - LIGHT_EXP_DEFAULT);
+    struct sample s = { 0, 0 };
+
+    if (counts > full_scale(exp))
+    {
+        s.peak = (uint16_t)full_scale(exp);
+        s.status = 0x40;
+    }
+    else
+    {
+        s.peak = (uint16_t)counts;
+    }
+    return s;
+}
+
+/* In band, or as far as the exposure goes */
+static int settled(int exp, const struct sample *s)
+{
+    uint32_t fs = full_scale(exp);
+
+    if (s->status)
+    {
+        return 0;
+    }
+    return (s->peak >= fs / 8 || exp == LIGHT_EXP_MAX) &&
+           (s->peak <= fs - fs / 4 || exp == 0);
+}
+
+static void test_tables(void)
+{
+    struct light_range range;
+
+    CHECK(light_range_init(NULL, 0) == -1);
+    CHECK(light_range_init(&range, -1) == -1);
+    CHECK(light_range_init(&range, LIGHT_EXP_MAX + 1) == -1);
+    CHECK(light_range_update(NULL, 0, 0) == -1);
+
+    CHECK(light_range_creg1(0) == 0xB0);
+    CHECK(light_range_creg1(LIGHT_EXP_DEFAULT) == 0x40);
+    CHECK(light_range_creg1(11) == 0x00);
+    CHECK(light_range_creg1(12) == 0x01);
+    CHECK(light_range_creg1(LIGHT_EXP_MAX) == 0x08);
+    CHECK(light_range_tconv_ms(LIGHT_EXP_DEFAULT) == 1u);
+    CHECK(light_range_tconv_ms(12) == 2u);
+    CHECK(light_range_tconv_ms(LIGHT_EXP_MAX) == 256u);
+
+    CHECK(light_range_normalize(LIGHT_EXP_DEFAULT, 1000) ==
+          1000u << LIGHT_NORM_SHIFT);
+    CHECK(light_range_normalize(0, 1) == 1u << (LIGHT_EXP_DEFAULT +
+                                                 LIGHT_NORM_SHIFT));
+    CHECK(light_range_normalize(LIGHT_EXP_MAX, 24) == 2);
+    CHECK(light_range_normalize(LIGHT_EXP_MAX, 23) == 1);
+    CHECK(light_range_normalize(LIGHT_EXP_MAX, 0xFFFF) == 0x1000);
+}
+
+static void check_reading(int exp, const struct sample *s, double irr)
+{
+    double reading = light_range_normalize(exp, s->peak) /
+                     ldexp(1.0, LIGHT_NORM_SHIFT);
+
+    /* Counts truncate, one count in the eighth of full scale at worst, and
+     * the result rounds to its fractional bits */
+    CHECK(fabs(reading - irr) <= irr / 100 +
+          ldexp(1.0, LIGHT_EXP_DEFAULT - exp) + ldexp(1.0, -LIGHT_NORM_SHIFT));
+}
+
+/* The exposure only moves against the light, one way per half of the ramp */
+static void test_ramp(void)
+{
+    struct light_range range;
+    struct sample s;
+    double irr = IRR_MIN, rate = RAMP_RATE;
+    int i, last, saturated = 0, hunted = 0;
+
+    light_range_init(&range, LIGHT_EXP_DEFAULT);
+    for (i = 0; rate > 1.0 || irr >= IRR_MIN; i++)
+    {
+        s = measure(range.exp, irr);
+        last = range.exp;
+        light_range_update(&range, s.peak, s.status);
+        if (i > MAX_SETTLE)
+        {
+            saturated += s.status != 0;
+            hunted += rate > 1.0 ? range.exp > last : range.exp < last;
+            check_reading(last, &s, irr);
+        }
+
+        irr *= rate;
+        if (irr > IRR_MAX)
+        {
+            rate = 1.0 / RAMP_RATE;
+        }
+    }
+    CHECK(saturated == 0);
+    CHECK(hunted == 0);
+}
+
+static void test_steps(void)
+{
+    struct light_range range;
+    struct sample s;
+    uint32_t seed = 8u;
+    double irr;
+    int i, n, worst = 0;
+
+    light_range_init(&range, LIGHT_EXP_DEFAULT);
+    for (i = 0; i < STEPS; i++)
+    {
+        irr = IRR_MIN * pow(IRR_MAX / IRR_MIN,
+                            (test_rand(&seed) & 0xFFFF) / 65535.0);
+        for (n = 0; n <= MAX_SETTLE + 1; n++)
+        {
+            s = measure(range.exp, irr);
+            if (settled(range.exp, &s))
+            {
+                break;
+            }
+            light_range_update(&range, s.peak, s.status);
+        }
+        worst = n > worst ? n : worst;
+        check_reading(range.exp, &s, irr);
+
+        /* Once settled, it stays put */
+        CHECK(light_range_update(&range, s.peak, s.status) == 0);
+    }
+    CHECK(worst <= MAX_SETTLE);
+}
+
+int main(void)
+{
+    test_tables();
+    test_ramp();
+    test_steps();
+    return test_done("lightrange");
+}
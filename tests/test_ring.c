@@ -0,0 +1,145 @@
+/*
+ * Ring unit test
+ *
+ * The edge cases of each operation, then a long run of random operations
+ * in both modes against a plain array model of the FIFO.
+ */
+
+#include "test.h"
+
+#include "Ring.h"
+
+#define CAPACITY    (7)
+#define RUN_OPS     (200000)
+
+static int count_until(int data, void *arg)
+{
+    int *seen = arg;
+
+    (*seen)++;
+    return data == 3;
+}
+
+static void test_edges(void)
+{
+    static int buf[CAPACITY];
+    struct ring ring;
+    int data, seen, i;
+
+    CHECK(ring_init(NULL, buf, CAPACITY, RING_REJECT) == -1);
+    CHECK(ring_init(&ring, NULL, CAPACITY, RING_REJECT) == -1);
+    CHECK(ring_init(&ring, buf, 0, RING_REJECT) == -1);
+    CHECK(ring_init(&ring, buf, CAPACITY, RING_REJECT) == 0);
+    CHECK(ring_length(&ring) == 0);
+    CHECK(ring_length(NULL) == -1);
+    CHECK(ring_enqueue(NULL, 1) == -1);
+    CHECK(ring_dequeue(&ring, &data) == -1);
+    CHECK(ring_dequeue(&ring, NULL) == -1);
+    CHECK(ring_peek(&ring, 0, &data) == -1);
+
+    /* 0 is an item like any other */
+    CHECK(ring_enqueue(&ring, 0) == 0);
+    CHECK(ring_dequeue(&ring, &data) == 0 && data == 0);
+
+    /* Reject mode keeps the oldest items */
+    for (i = 0; i < CAPACITY; i++)
+    {
+        CHECK(ring_enqueue(&ring, i) == 0);
+    }
+    CHECK(ring_enqueue(&ring, 99) == -1);
+    CHECK(ring_length(&ring) == CAPACITY);
+    CHECK(ring_peek(&ring, 0, &data) == 0 && data == 0);
+    CHECK(ring_peek(&ring, CAPACITY - 1, &data) == 0 && data == CAPACITY - 1);
+    CHECK(ring_peek(&ring, CAPACITY, &data) == -1);
+    CHECK(ring_peek(&ring, -1, &data) == -1);
+
+    /* Iteration stops at the item the callback picks */
+    seen = 0;
+    data = -1;
+    CHECK(ring_iterate(&ring, count_until, &seen, &data) == 0);
+    CHECK(seen == 4 && data == 3);
+    CHECK(ring_iterate(&ring, NULL, NULL, NULL) == -1);
+
+    /* Overwrite mode drops the oldest */
+    CHECK(ring_init(&ring, buf, CAPACITY, RING_OVERWRITE) == 0);
+    for (i = 0; i < CAPACITY; i++)
+    {
+        CHECK(ring_enqueue(&ring, i) == 0);
+    }
+    CHECK(ring_enqueue(&ring, 99) == 1);
+    CHECK(ring_length(&ring) == CAPACITY);
+    CHECK(ring_peek(&ring, 0, &data) == 0 && data == 1);
+    CHECK(ring_peek(&ring, CAPACITY - 1, &data) == 0 && data == 99);
+    for (i = 1; i < CAPACITY; i++)
+    {
+        CHECK(ring_dequeue(&ring, &data) == 0 && data == i);
+    }
+    CHECK(ring_dequeue(&ring, &data) == 0 && data == 99);
+    CHECK(ring_length(&ring) == 0);
+}
+
+/* The model keeps every item ever enqueued, [first, last) is the FIFO */
+static void test_model(int mode)
+{
+    static int buf[CAPACITY];
+    static int model[RUN_OPS];
+    struct ring ring;
+    uint32_t seed = 0x1234567u + (uint32_t)mode;
+    int first = 0, last = 0;
+    int i, data, value, ret, index;
+
+    ring_init(&ring, buf, CAPACITY, mode);
+    for (i = 0; i < RUN_OPS; i++)
+    {
+        switch (test_rand(&seed) % 3)
+        {
+            case 0:
+            case 1:
+                value = (int)test_rand(&seed);
+                ret = ring_enqueue(&ring, value);
+                if (last - first < CAPACITY)
+                {
+                    CHECK(ret == 0);
+                    model[last++] = value;
+                }
+                else if (mode == RING_OVERWRITE)
+                {
+                    CHECK(ret == 1);
+                    first++;
+                    model[last++] = value;
+                }
+                else
+                {
+                    CHECK(ret == -1);
+                }
+                break;
+            default:
+                ret = ring_dequeue(&ring, &data);
+                if (last > first)
+                {
+                    CHECK(ret == 0 && data == model[first]);
+                    first++;
+                }
+                else
+                {
+                    CHECK(ret == -1);
+                }
+                break;
+        }
+        CHECK(ring_length(&ring) == last - first);
+        if (last > first)
+        {
+            index = (int)(test_rand(&seed) % (uint32_t)(last - first));
+            CHECK(ring_peek(&ring, index, &data) == 0 &&
+                  data == model[first + index]);
+        }
+    }
+}
+
+int main(void)
+{
+    test_edges();
+    test_model(RING_REJECT);
+    test_model(RING_OVERWRITE);
+    return test_done("ring");
+}
@@ -0,0 +1,256 @@
+/*
+ * Scheduler test
+ *
+ * One-shot timers, stopping, starting and retuning tasks, then a whole day
+ * of the CM0+ main loop in virtual time: the task set of main_cm0p.c on
+ * the timerNow() millisecond time line, sleeping until sched_next() in
+ * between (the wake up coming up to a tick early), with motion interrupts,
+ * READY waking the light read or now and then failing to, and changes of
+ * settings along the way, and the time line wrapping an hour in. Every release must keep its period exactly and no task may
+ * miss its deadline, but where the settings shorten a period: its next
+ * release may then be past already, costing one late run.
+ */
+
+#include "test.h"
+
+#include "Sched.h"
+
+/* main_cm0p.c */
+enum { ACCEL, FIFO, LIGHT, LIGHT_READ, RESULTS, REPORT, FLUSH, HIBERNATE,
+       TASKS };
+#define FLUSH_PERIOD        (60000u)
+#define DEADLINE            (50u)
+#define REPORT_DEADLINE     (5000u)
+#define RESULTS_DELAY       (200u)
+#define FIFO_PERIOD         (1280u)     // ACC_FIFO_PERIOD at 25 Hz
+#define READY_DELAY         (3u)        // TCONV and TBREAK, default exposure
+#define READY_TIMEOUT       (8u)        // lightReadyTimeout() then
+
+#define DAY                 (86400000u)
+#define START               (0u - 3600000u)
+
+/* Time each task body takes, ms */
+static const uint32_t cost[TASKS] = { 2, 3, 1, 3, 1, 8, 1, 0 };
+
+static struct sched_task tasks[TASKS];
+static struct sched s;
+static uint32_t now;
+
+/* Release each run was for, and whether the task was released off its
+   period since: woken early, or retuned to a shorter one */
+static uint32_t last_release[TASKS];
+static uint32_t runs[TASKS];
+static int rephased[TASKS];
+static int bad_gaps;
+
+/* READY to come, 0 if none is; READY missed */
+static uint32_t ready_at;
+static uint32_t seed = 23u, missed;
+
+static void body(void *arg)
+{
+    int i = (int)(intptr_t)arg;
+    struct sched_task *t = &tasks[i];
+    uint32_t release = t->release - t->period;
+
+    if (runs[i] && release - last_release[i] != t->period && !rephased[i])
+    {
+        bad_gaps++;
+    }
+    rephased[i] = 0;
+    last_release[i] = release;
+    runs[i]++;
+    now += cost[i];
+
+    /* lightTask() arms READY, lightReadTask() times the results */
+    if (i == LIGHT)
+    {
+        sched_start(&s, LIGHT_READ, now + READY_TIMEOUT);
+        ready_at = test_rand(&seed) % 64u ? now + READY_DELAY : 0u;
+        missed += ready_at == 0u;
+    }
+    if (i == LIGHT_READ)
+    {
+        ready_at = 0u;
+        rephased[LIGHT_READ] = 1;
+        sched_start(&s, RESULTS, now + RESULTS_DELAY);
+        rephased[RESULTS] = 1;
+    }
+}
+
+/* taskPeriods() of main_cm0p.c */
+static void periods(uint32_t tick, uint32_t acc_tick, uint32_t every)
+{
+    sched_set_period(&s, ACCEL, acc_tick);
+    sched_set_period(&s, LIGHT, tick);
+    sched_set_period(&s, RESULTS, tick);
+    sched_set_period(&s, REPORT, tick * every);
+    sched_set_period(&s, HIBERNATE, tick);
+}
+
+static int count;
+static void tally(void *arg)
+{
+    (void)arg;
+    count++;
+}
+
+static void test_edges(void)
+{
+    struct sched_task buf[3];
+    struct sched e;
+    uint32_t when;
+    int periodic, shot;
+
+    CHECK(sched_init(NULL, buf, 3) == -1);
+    CHECK(sched_init(&e, buf, 0) == -1);
+    CHECK(sched_init(&e, buf, SCHED_MAX_TASKS + 1) == -1);
+    CHECK(sched_init(&e, buf, 2) == 0);
+    CHECK(sched_next(&e, &when) == -1);
+    CHECK(sched_add(&e, NULL, NULL, 1, 1, 0) == -1);
+
+    periodic = sched_add(&e, tally, NULL, 1000, 50, 0);
+    shot = sched_add(&e, tally, NULL, 0, 10, 250);
+    CHECK(periodic == 0 && shot == 1);
+    CHECK(sched_add(&e, tally, NULL, 1, 1, 0) == -1);
+
+    CHECK(sched_next(&e, &when) == 0 && when == 0);
+    CHECK(sched_run(&e, 0) == 1 && count == 1);
+    CHECK(sched_next(&e, &when) == 0 && when == 250);
+    CHECK(sched_run(&e, 249) == 0);
+    CHECK(sched_run(&e, 250) == 1 && count == 2);
+    CHECK(sched_next(&e, &when) == 0 && when == 1000);
+    CHECK(sched_run(&e, 1000) == 1 && sched_run(&e, 1001) == 0);
+
+    /* The one-shot only runs again once armed */
+    CHECK(sched_start(&e, shot, 1500) == 0);
+    CHECK(sched_next(&e, &when) == 0 && when == 1500);
+    CHECK(sched_set_period(&e, shot, 5) == -1);
+    CHECK(sched_set_period(&e, periodic, 0) == -1);
+    CHECK(sched_stop(&e, periodic) == 0 && sched_stop(&e, shot) == 0);
+    CHECK(sched_next(&e, &when) == -1);
+    CHECK(sched_stop(&e, 2) == -1 && sched_wake(&e, -1, 0) == -1);
+
+    /* Retuned, the next release stays one period after the last */
+    CHECK(sched_start(&e, periodic, 2000) == 0);
+    CHECK(sched_run(&e, 2000) == 1);
+    CHECK(sched_set_period(&e, periodic, 300) == 0);
+    CHECK(sched_next(&e, &when) == 0 && when == 2300);
+
+    /* Falling behind: one miss, no burst of the periods missed */
+    CHECK(sched_run(&e, 3000) == 1);
+    CHECK(buf[periodic].misses == 1);
+    CHECK(sched_next(&e, &when) == 0 && when == 3300);
+    CHECK(sched_run(&e, 3299) == 0);
+}
+
+static void test_day(void)
+{
+    uint32_t wake, next_motion, sleeps = 0, early = 0, idle = 0;
+    uint32_t releases = 0, i;
+    int stage = 0;
+
+    now = START;
+    sched_init(&s, tasks, TASKS);
+    sched_add(&s, body, (void *)ACCEL, 1u, DEADLINE, now);
+    sched_add(&s, body, (void *)FIFO, FIFO_PERIOD, DEADLINE,
+              now + FIFO_PERIOD);
+    sched_add(&s, body, (void *)LIGHT, 1u, DEADLINE, now);
+    sched_add(&s, body, (void *)LIGHT_READ, 0u, DEADLINE, now);
+    sched_stop(&s, LIGHT_READ);
+    rephased[LIGHT_READ] = 1;
+    sched_add(&s, body, (void *)RESULTS, 1u, DEADLINE, now + RESULTS_DELAY);
+    sched_add(&s, body, (void *)REPORT, 1u, REPORT_DEADLINE,
+              now + RESULTS_DELAY);
+    sched_add(&s, body, (void *)FLUSH, FLUSH_PERIOD, FLUSH_PERIOD,
+              now + FLUSH_PERIOD);
+    sched_add(&s, body, (void *)HIBERNATE, 1u, FLUSH_PERIOD,
+              now + RESULTS_DELAY);
+    periods(5000, 5000, 15);
+    next_motion = now + 600000u;
+
+    while (now - START < DAY)
+    {
+        if ((int32_t)(now - next_motion) >= 0)
+        {
+            sched_wake(&s, ACCEL, now);
+            rephased[ACCEL] = 1;
+            next_motion = now + 60000u + test_rand(&seed) % 1800000u;
+        }
+        if (ready_at != 0u && (int32_t)(now - ready_at) >= 0)
+        {
+            sched_wake(&s, LIGHT_READ, now);
+        }
+
+        /* Longer periods at noon, back to the defaults at six */
+        if (stage == 0 && now - START >= DAY / 2)
+        {
+            periods(10000, 10000, 9);
+            stage++;
+        }
+        if (stage == 1 && now - START >= DAY / 4 * 3)
+        {
+            for (i = 0; i < TASKS; i++)
+            {
+                CHECK(tasks[i].misses == 0);
+                rephased[i] = 1;
+            }
+            periods(5000, 5000, 15);
+            stage++;
+        }
+
+        if (sched_run(&s, now) == 0)
+        {
+            idle++;
+        }
+
+        /* Deep sleep until the next task is due, or the next motion */
+        CHECK(sched_next(&s, &wake) == 0);
+        if ((int32_t)(wake - now) > 0)
+        {
+            if ((int32_t)(wake - next_motion) > 0)
+            {
+                wake = next_motion;
+            }
+            if (ready_at != 0u && (int32_t)(wake - ready_at) > 0)
+            {
+                wake = ready_at;
+            }
+            if (test_rand(&seed) & 1)
+            {
+                wake--;
+                early++;
+            }
+            if ((int32_t)(wake - now) > 0)
+            {
+                now = wake;
+            }
+            sleeps++;
+        }
+    }
+
+    for (i = 0; i < TASKS; i++)
+    {
+        CHECK(tasks[i].misses <= 1);
+        CHECK(tasks[i].runs == runs[i]);
+        releases += runs[i];
+    }
+    CHECK(bad_gaps == 0);
+
+    /* Ran exactly what was due */
+    CHECK(runs[FLUSH] == (DAY - 1) / FLUSH_PERIOD);
+    CHECK(runs[FIFO] == (DAY - 1) / FIFO_PERIOD);
+    CHECK(runs[LIGHT] - runs[LIGHT_READ] <= 1u && missed > 0u);
+
+    /* Woken for nothing only when the timer fired early, or for motion */
+    CHECK(idle <= early + runs[ACCEL]);
+    printf("sched: %u runs, %u sleeps, %u early wake ups, %u READY "
+           "missed\n", releases, sleeps, early, missed);
+}
+
+int main(void)
+{
+    test_edges();
+    test_day();
+    return test_done("sched");
+}
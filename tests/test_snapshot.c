@@ -0,0 +1,223 @@
+/*
+ * Snapshot test
+ *
+ * Snapshots round trip through the backup register words at the extremes
+ * of every field, and the words of anything else (a bit error, another
+ * version, the cleared registers of a start up) are refused. Windows
+ * refilled by window_seed() read back the statistics they were seeded
+ * with, and a whole restore, decoding the words and refilling both 720
+ * sample windows of Process.h, is timed.
+ */
+
+#include "test.h"
+
+#include <string.h>
+
+#include "Frame.h"
+#include "Snapshot.h"
+#include "Window.h"
+
+/* The layout of Snapshot.c: magic, version, fields, CRC */
+#define PACKED_LEN          (2 + 20 + 2 * 14 + 1 + 2 * BEHAVIOUR_COUNT + 2 + 2)
+#define CAPACITY            (720)       // HISTORY_LEN of Process.h
+#define RESTORES            (2000)
+
+static int light_buf[CAPACITY], temp_buf[CAPACITY];
+static struct window_entry light_minq[CAPACITY], light_maxq[CAPACITY];
+static struct window_entry temp_minq[CAPACITY], temp_maxq[CAPACITY];
+static struct window light, temp;
+
+static const struct snapshot extremes[] = {
+    { 86399, 0xFFFFFFFFu, 0xFFFFFFF0u, 86000, -32768, 255, 1,
+      { { CAPACITY, -1234567, INT32_MIN, 5 }, { 1, 2500, 2500, 2500 }, -1,
+        { 3600, 0, 1, 65535 }, 65535 } },
+    { 0, 0, 0, 0, 32767, 0, 0,
+      { { 0, 0, 0, 0 }, { 65535, INT32_MAX, -1, INT32_MAX }, 127,
+        { 0, 0, 0, 0 }, 0 } },
+    { 43200, 123456, 77, 43100, 80, 2, 0,
+      { { 500, 1200, 3, 60000 }, { 500, 2510, 1890, 3120 }, 2,
+        { 100, 2000, 900, 600 }, 12 } },
+};
+
+static int same_window(const struct snapshot_window *a,
+                       const struct snapshot_window *b)
+{
+    return a->count == b->count && a->mean == b->mean && a->min == b->min &&
+           a->max == b->max;
+}
+
+static int same(const struct snapshot *a, const struct snapshot *b)
+{
+    return a->time == b->time && a->sample_seq == b->sample_seq &&
+           a->history_seq == b->history_seq &&
+           a->last_motion == b->last_motion &&
+           a->happy_score == b->happy_score && a->state == b->state &&
+           a->inactive == b->inactive &&
+           same_window(&a->proc.light, &b->proc.light) &&
+           same_window(&a->proc.temp, &b->proc.temp) &&
+           a->proc.behaviour == b->proc.behaviour &&
+           memcmp(a->proc.budget, b->proc.budget,
+                  sizeof(a->proc.budget)) == 0 &&
+           a->proc.dark_count == b->proc.dark_count;
+}
+
+/* process_window_state() of Process.h */
+static void window_state(window_t win, struct snapshot_window *state)
+{
+    int mean = 0, min = 0, max = 0;
+
+    window_mean(win, &mean);
+    window_min(win, &min);
+    window_max(win, &max);
+    state->count = (uint16_t)window_count(win);
+    state->mean = mean;
+    state->min = min;
+    state->max = max;
+}
+
+static void test_round_trip(void)
+{
+    uint32_t words[SNAPSHOT_WORDS], bad[SNAPSHOT_WORDS];
+    uint8_t bytes[SNAPSHOT_WORDS * 4];
+    struct snapshot out;
+    uint16_t crc;
+    int i, bit;
+
+    CHECK(snapshot_encode(NULL, words) == -1);
+    CHECK(snapshot_encode(&extremes[0], NULL) == -1);
+    CHECK(snapshot_decode(NULL, &out) == -1);
+
+    for (i = 0; i < (int)(sizeof(extremes) / sizeof(extremes[0])); i++)
+    {
+        CHECK(snapshot_encode(&extremes[i], words) == 0);
+        memset(&out, 0, sizeof(out));
+        CHECK(snapshot_decode(words, &out) == 0);
+        CHECK(same(&out, &extremes[i]));
+    }
+
+    /* Every bit error in the packed bytes is refused, @s left as it was;
+       the padding after them does not matter */
+    for (bit = 0; bit < SNAPSHOT_WORDS * 32; bit++)
+    {
+        memcpy(bad, words, sizeof(bad));
+        bad[bit / 32] ^= 1u << (bit % 32);
+        out = extremes[0];
+        if (bit < PACKED_LEN * 8)
+        {
+            CHECK(snapshot_decode(bad, &out) == -1);
+            CHECK(same(&out, &extremes[0]));
+        }
+        else
+        {
+            CHECK(snapshot_decode(bad, &out) == 0);
+            CHECK(same(&out, &extremes[2]));
+        }
+    }
+
+    /* Another version, however well formed */
+    for (i = 0; i < SNAPSHOT_WORDS * 4; i++)
+    {
+        bytes[i] = (uint8_t)(words[i / 4] >> (8 * (i % 4)));
+    }
+    CHECK(bytes[0] == SNAPSHOT_MAGIC && bytes[1] == SNAPSHOT_VERSION);
+    crc = frame_crc16(bytes, PACKED_LEN - 2);
+    CHECK(bytes[PACKED_LEN - 2] == (uint8_t)crc);
+    CHECK(bytes[PACKED_LEN - 1] == crc >> 8);
+    bytes[1] = SNAPSHOT_VERSION - 1;
+    crc = frame_crc16(bytes, PACKED_LEN - 2);
+    bytes[PACKED_LEN - 2] = (uint8_t)crc;
+    bytes[PACKED_LEN - 1] = (uint8_t)(crc >> 8);
+    for (i = 0; i < SNAPSHOT_WORDS; i++)
+    {
+        bad[i] = bytes[4 * i] | (uint32_t)bytes[4 * i + 1] << 8 |
+                 (uint32_t)bytes[4 * i + 2] << 16 |
+                 (uint32_t)bytes[4 * i + 3] << 24;
+    }
+    CHECK(snapshot_decode(bad, &out) == -1);
+
+    /* What hibernateResume() finds after any other start up */
+    memset(bad, 0, sizeof(bad));
+    CHECK(snapshot_decode(bad, &out) == -1);
+    words[0] = 0;
+    CHECK(snapshot_decode(words, &out) == -1);
+}
+
+static void test_seed(void)
+{
+    struct snapshot_window before, after;
+    uint32_t seed = 25u;
+    int round, i, n;
+
+    for (round = 0; round < 2000; round++)
+    {
+        window_init(&light, light_buf, light_minq, light_maxq, CAPACITY);
+        n = 1 + (int)(test_rand(&seed) % (CAPACITY + 300));
+        for (i = 0; i < n; i++)
+        {
+            window_push(&light, (int)(test_rand(&seed) % 200000) - 50000);
+        }
+        window_state(&light, &before);
+
+        window_init(&temp, temp_buf, temp_minq, temp_maxq, CAPACITY);
+        CHECK(window_seed(&temp, before.count, before.mean, before.min,
+                          before.max) == 0);
+        window_state(&temp, &after);
+        CHECK(same_window(&before, &after));
+        CHECK(window_sum(&temp) == (int64_t)before.mean * before.count ||
+              before.count == 2);
+        CHECK(window_seed(&temp, 1, 0, 0, 0) == -1);
+
+        /* The made up samples move out as real ones come in */
+        for (i = 0; i < CAPACITY; i++)
+        {
+            window_push(&temp, 7);
+        }
+        window_state(&temp, &after);
+        CHECK(after.count == CAPACITY && after.min == 7 && after.max == 7);
+    }
+
+    window_init(&temp, temp_buf, temp_minq, temp_maxq, CAPACITY);
+    CHECK(window_seed(NULL, 1, 0, 0, 0) == -1);
+    CHECK(window_seed(&temp, -1, 0, 0, 0) == -1);
+    CHECK(window_seed(&temp, CAPACITY + 1, 5, 0, 9) == -1);
+    CHECK(window_seed(&temp, 10, 5, 6, 9) == -1);
+    CHECK(window_seed(&temp, 10, 10, 6, 9) == -1);
+    CHECK(window_seed(&temp, 0, 0, 0, 0) == 0 && window_count(&temp) == 0);
+}
+
+static void test_restore(void)
+{
+    const struct snapshot *snap = &extremes[2];
+    uint32_t words[SNAPSHOT_WORDS];
+    struct snapshot out;
+    double start, elapsed;
+    int k;
+
+    snapshot_encode(snap, words);
+    start = test_now();
+    for (k = 0; k < RESTORES; k++)
+    {
+        snapshot_decode(words, &out);
+        window_init(&light, light_buf, light_minq, light_maxq, CAPACITY);
+        window_init(&temp, temp_buf, temp_minq, temp_maxq, CAPACITY);
+        window_seed(&light, out.proc.light.count, out.proc.light.mean,
+                    out.proc.light.min, out.proc.light.max);
+        window_seed(&temp, out.proc.temp.count, out.proc.temp.mean,
+                    out.proc.temp.min, out.proc.temp.max);
+    }
+    elapsed = (test_now() - start) / RESTORES;
+
+    /* The next snapshot carries on with the same statistics */
+    window_state(&light, &out.proc.light);
+    window_state(&temp, &out.proc.temp);
+    CHECK(same(&out, snap));
+    printf("snapshot: restore in %.1f us on the host\n", elapsed * 1e6);
+}
+
+int main(void)
+{
+    test_round_trip();
+    test_seed();
+    test_restore();
+    return test_done("snapshot");
+}
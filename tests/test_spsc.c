@@ -0,0 +1,152 @@
+/*
+ * SPSC ring test
+ *
+ * The edge cases and an index wrap on one thread, then a producer and a
+ * consumer thread passing 2M records through 64 slots. Every record
+ * carries its sequence number and a payload derived from it, so a lost,
+ * repeated, reordered or torn record is caught. The consumer alternates
+ * between popping and peeking before popping, as the CM4 does. Either side
+ * yields when it has to wait, so the test also runs on a single CPU.
+ */
+
+#include "test.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <string.h>
+
+#include "Spsc.h"
+
+#define SLOTS       (64)
+#define RECORDS     (2000000u)
+
+struct record
+{
+    uint32_t seq;
+    uint32_t payload[5];
+};
+
+static struct record slots[SLOTS];
+static struct spsc ring;
+static uint32_t producer_full = 0;
+
+static void fill(struct record *r, uint32_t seq)
+{
+    int i;
+
+    r->seq = seq;
+    for (i = 0; i < 5; i++)
+    {
+        r->payload[i] = seq * 2654435761u + (uint32_t)i;
+    }
+}
+
+static int intact(const struct record *r)
+{
+    struct record expected;
+
+    fill(&expected, r->seq);
+    return memcmp(r, &expected, sizeof(expected)) == 0;
+}
+
+static void test_edges(void)
+{
+    struct record r, out;
+    uint32_t i;
+
+    CHECK(spsc_init(NULL, slots, sizeof(r), SLOTS) == -1);
+    CHECK(spsc_init(&ring, NULL, sizeof(r), SLOTS) == -1);
+    CHECK(spsc_init(&ring, slots, 0, SLOTS) == -1);
+    CHECK(spsc_init(&ring, slots, sizeof(r), 0) == -1);
+    CHECK(spsc_init(&ring, slots, sizeof(r), 48) == -1);
+    CHECK(spsc_init(&ring, slots, sizeof(r), SLOTS) == 0);
+    CHECK(spsc_length(&ring) == 0);
+    CHECK(spsc_peek(&ring, &out) == -1);
+    CHECK(spsc_pop(&ring, NULL) == -1);
+    CHECK(spsc_push(&ring, NULL) == -1);
+
+    /* Full, then drained across the 32-bit index wrap */
+    ring.head = ring.tail = UINT32_MAX - SLOTS / 2;
+    for (i = 0; i < SLOTS; i++)
+    {
+        fill(&r, i);
+        CHECK(spsc_push(&ring, &r) == 0);
+    }
+    CHECK(spsc_length(&ring) == SLOTS);
+    CHECK(spsc_push(&ring, &r) == -1);
+    CHECK(ring.dropped == 1);
+    for (i = 0; i < SLOTS; i++)
+    {
+        CHECK(spsc_peek(&ring, &out) == 0 && out.seq == i);
+        CHECK(spsc_pop(&ring, &out) == 0 && out.seq == i && intact(&out));
+    }
+    CHECK(spsc_length(&ring) == 0);
+    CHECK(spsc_pop(&ring, &out) == -1);
+}
+
+static void *producer(void *arg)
+{
+    struct record r;
+    uint32_t seq;
+
+    (void)arg;
+    for (seq = 0; seq < RECORDS; seq++)
+    {
+        fill(&r, seq);
+        while (spsc_push(&ring, &r) != 0)
+        {
+            producer_full++;
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+static void test_threads(void)
+{
+    pthread_t thread;
+    struct record r, peeked;
+    uint32_t next = 0, bad = 0;
+
+    spsc_init(&ring, slots, sizeof(struct record), SLOTS);
+    if (pthread_create(&thread, NULL, producer, NULL) != 0)
+    {
+        CHECK(!"pthread_create");
+        return;
+    }
+
+    while (next < RECORDS)
+    {
+        if (next & 1)
+        {
+            if (spsc_peek(&ring, &peeked) != 0)
+            {
+                sched_yield();
+                continue;
+            }
+            CHECK(spsc_pop(&ring, &r) == 0);
+            bad += memcmp(&r, &peeked, sizeof(r)) != 0;
+        }
+        else if (spsc_pop(&ring, &r) != 0)
+        {
+            sched_yield();
+            continue;
+        }
+        bad += r.seq != next || !intact(&r);
+        next++;
+    }
+    pthread_join(thread, NULL);
+
+    CHECK(bad == 0);
+    CHECK(spsc_length(&ring) == 0);
+    CHECK(ring.dropped == producer_full);
+    printf("spsc: %u records, producer found the ring full %u times\n",
+           (unsigned)RECORDS, (unsigned)producer_full);
+}
+
+int main(void)
+{
+    test_edges();
+    test_threads();
+    return test_done("spsc");
+}
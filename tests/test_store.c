@@ -0,0 +1,130 @@
+/*
+ * Store unit test
+ *
+ * Random single and bulk appends, some of them larger than the store,
+ * interleaved with views of random sizes. Every view is checked sample by
+ * sample against a reference model that keeps every sample appended.
+ */
+
+#include "test.h"
+
+#include "Store.h"
+
+#define CAPACITY    (50)
+#define ROUNDS      (5000)
+#define MAX_BATCH   (120)
+#define MAX_SAMPLES (ROUNDS * MAX_BATCH)
+
+static int16_t model[MAX_SAMPLES][3];
+
+static void test_edges(void)
+{
+    static int16_t x[4], y[4], z[4];
+    static uint32_t t[4];
+    struct store store;
+    struct store_view view;
+    int16_t xyz[3 * 6] = { 0 };
+    uint32_t times[6] = { 0 };
+
+    CHECK(store_init(NULL, x, y, z, t, 4) == -1);
+    CHECK(store_init(&store, x, NULL, z, t, 4) == -1);
+    CHECK(store_init(&store, x, y, z, t, 0) == -1);
+    CHECK(store_init(&store, x, y, z, t, 4) == 0);
+    CHECK(store_length(&store) == 0);
+    CHECK(store_length(NULL) == -1);
+    CHECK(store_append(NULL, 0, 0, 0, 0) == -1);
+    CHECK(store_append_bulk(&store, NULL, times, 1) == -1);
+    CHECK(store_append_bulk(&store, xyz, times, -1) == -1);
+    CHECK(store_view(&store, -1, &view) == -1);
+    CHECK(store_view(&store, 3, NULL) == -1);
+    CHECK(store_view(&store, 3, &view) == 0);
+    CHECK(view.len[0] == 0 && view.len[1] == 0);
+
+    CHECK(store_append(&store, 1, 2, 3, 4) == 0);
+    CHECK(store_append_bulk(&store, xyz, times, 3) == 0);
+    CHECK(store_append(&store, 1, 2, 3, 4) == 1);
+    CHECK(store_append_bulk(&store, xyz, times, 6) == 6);
+    CHECK(store_length(&store) == 4);
+}
+
+static void test_model(void)
+{
+    static int16_t x[CAPACITY], y[CAPACITY], z[CAPACITY];
+    static uint32_t t[CAPACITY];
+    static int16_t batch[3 * MAX_BATCH];
+    static uint32_t times[MAX_BATCH];
+    struct store store;
+    struct store_view view;
+    uint32_t seed = 4u;
+    int count = 0;
+    int round, i, k, n, want, got, expect, overwritten, length, seg, j;
+
+    store_init(&store, x, y, z, t, CAPACITY);
+    for (round = 0; round < ROUNDS; round++)
+    {
+        n = (int)(test_rand(&seed) % MAX_BATCH);
+        for (i = 0; i < n; i++)
+        {
+            for (k = 0; k < 3; k++)
+            {
+                batch[3 * i + k] = (int16_t)test_rand(&seed);
+                model[count + i][k] = batch[3 * i + k];
+            }
+            times[i] = (uint32_t)(count + i);
+        }
+
+        /* Whatever no longer fits, of the old samples or of the batch */
+        length = count < CAPACITY ? count : CAPACITY;
+        expect = length + n - (length + n < CAPACITY ? length + n : CAPACITY);
+        if (test_rand(&seed) & 1)
+        {
+            overwritten = store_append_bulk(&store, batch, times, n);
+        }
+        else
+        {
+            for (i = 0, overwritten = 0; i < n; i++)
+            {
+                overwritten += store_append(&store, batch[3 * i],
+                                            batch[3 * i + 1], batch[3 * i + 2],
+                                            times[i]);
+            }
+        }
+        CHECK(overwritten == expect);
+        count += n;
+        CHECK(store_length(&store) == (count < CAPACITY ? count : CAPACITY));
+
+        want = (int)(test_rand(&seed) % (CAPACITY + 20));
+        got = store_view(&store, want, &view);
+        expect = want < store_length(&store) ? want : store_length(&store);
+        CHECK(got == expect);
+        CHECK(view.len[0] + view.len[1] == got);
+        if (view.len[1] != 0)
+        {
+            CHECK(view.x[1] == x && view.t[1] == t);
+        }
+
+        j = count - got;
+        for (seg = 0; seg < 2; seg++)
+        {
+            for (i = 0; i < view.len[seg]; i++, j++)
+            {
+                CHECK(view.x[seg][i] == model[j][0]);
+                CHECK(view.y[seg][i] == model[j][1]);
+                CHECK(view.z[seg][i] == model[j][2]);
+                CHECK(view.t[seg][i] == (uint32_t)j);
+            }
+        }
+        if (test_failures)
+        {
+            printf("round %d\n", round);
+            return;
+        }
+    }
+}
+
+int main(void)
+{
+    test_edges();
+    test_model();
+    return test_done("store");
+}
@@ -0,0 +1,145 @@
+/*
+ * Wake up simulation
+ *
+ * A day of the CM0+ main loop in virtual time, one step per accelerometer
+ * sample, counting how often the MCU leaves deep sleep. The cow grazes and
+ * lies down in bouts of random length; while it lies it only twitches now
+ * and then. Two loops are compared:
+ *  - polling: the RTC tick and the FIFO drain timer, whatever the cow does
+ *  - wake on motion: the same until CRIT_INACTIVE seconds go by without a
+ *    motion interrupt, then only the RTC tick and the next motion
+ * While the cow moves, INT1 is only checked at each service, as in
+ * accService(); what letting it interrupt then would cost is counted too.
+ */
+
+#include "test.h"
+
+/* RTC_Alarm.h, Accelerometer.h and FSM.h, in ms */
+#define TICK                (5000u)
+#define SAMPLE              (40u)       // 25 Hz
+#define FIFO_PERIOD         (1280u)     // ACC_FIFO_PERIOD
+#define CRIT_INACTIVE       (600000u)
+
+#define MINUTE              (60000u)
+#define HOUR                (3600000u)
+#define DAY                 (24u * HOUR)
+
+/* Tick and drain together, once per least common multiple of the two */
+#define POLL_WAKES  (HOUR / TICK + HOUR / FIFO_PERIOD - HOUR / 160000u)
+
+/* The cow grazes 5 - 60 min, over the threshold on a quarter of the
+   samples, then lies 20 - 120 min, twitching every 5 - 30 min */
+static uint32_t seed = 12u;
+static uint32_t bout_end, next_twitch;
+static int lying = 1;
+
+static uint32_t between(uint32_t lo, uint32_t hi)
+{
+    return lo + test_rand(&seed) % (hi - lo + 1u);
+}
+
+/* Whether the sample at @t is over the wake on motion threshold */
+static int cow(uint32_t t)
+{
+    if (t >= bout_end)
+    {
+        lying = !lying;
+        bout_end = t + (lying ? between(20u, 120u) : between(5u, 60u)) * MINUTE;
+        next_twitch = t + between(5u, 30u) * MINUTE;
+    }
+    if (!lying)
+    {
+        return (test_rand(&seed) & 3u) == 0u;
+    }
+    if (t >= next_twitch)
+    {
+        next_twitch = t + between(5u, 30u) * MINUTE;
+        return 1;
+    }
+    return 0;
+}
+
+/* Per hour, from @count over @steps samples */
+static uint32_t per_hour(uint32_t count, uint32_t steps)
+{
+    return (uint32_t)((uint64_t)count * HOUR / ((uint64_t)steps * SAMPLE));
+}
+
+int main(void)
+{
+    uint32_t poll = 0, wom = 0, trips = 0, motion = 0, edges = 0;
+    uint32_t steps[2] = { 0 }, wakes[2] = { 0 }, ticks[2] = { 0 };
+    uint32_t t, last_motion = 0, last_sample = 0, drain_start = 0, awake;
+    int asleep = 0, latched = 0, tick, drain;
+
+    for (t = 0; t < DAY; t += SAMPLE)
+    {
+        if (cow(t))
+        {
+            /* Latched until the status read. Were INT1 to interrupt while
+               the cow moves, its handler would read the status right away
+               and each sample over the threshold would wake the MCU up */
+            edges += !asleep;
+            latched = 1;
+            last_sample = t;
+        }
+
+        /* The polling loop wakes up on its timers alone */
+        tick = t % TICK == 0u;
+        poll += tick || t % FIFO_PERIOD == 0u;
+
+        steps[asleep]++;
+        ticks[asleep] += tick;
+        drain = !asleep && (t - drain_start) % FIFO_PERIOD == 0u;
+        if (!tick && !drain && !(asleep && latched))
+        {
+            continue;
+        }
+        wakes[asleep]++;
+        motion += asleep && latched && !tick;
+
+        /* accService(), then the inactivity check of the tick */
+        if (latched)
+        {
+            latched = 0;
+            last_motion = t - t % 1000u;
+            if (asleep)
+            {
+                /* The drain timer starts over */
+                asleep = 0;
+                drain_start = t;
+            }
+        }
+        if (tick && !asleep && t - last_motion >= CRIT_INACTIVE)
+        {
+            CHECK(t - last_sample >= CRIT_INACTIVE - 1000u);
+            CHECK(t - last_sample <= CRIT_INACTIVE + FIFO_PERIOD + TICK);
+            asleep = 1;
+            trips++;
+        }
+    }
+    wom = wakes[0] + wakes[1];
+    awake = per_hour(wakes[0], steps[0]);
+
+    CHECK(poll == DAY / HOUR * POLL_WAKES);
+    CHECK(trips > 0 && motion > 0);
+    CHECK(steps[1] > steps[0] / 10u);
+
+    /* Lying still, only the tick and the motion that ends it are left */
+    CHECK(wakes[1] == ticks[1] + motion);
+
+    /* Awake, the same as polling, but where the restarted drain timer
+       meets the tick */
+    CHECK(awake + 1u >= POLL_WAKES);
+    CHECK(awake <= HOUR / TICK + HOUR / FIFO_PERIOD);
+    CHECK(wom < poll);
+    CHECK(per_hour(edges, steps[0]) > awake);
+
+    printf("wakeup: %u a day polling, %u with wake on motion, inactive "
+           "%u%% of the time\n", poll, wom,
+           (unsigned)((uint64_t)steps[1] * 100u / (steps[0] + steps[1])));
+    printf("wakeup: per hour %u polling, %u awake, %u asleep; INT1 "
+           "interrupting while awake would add %u\n", POLL_WAKES, awake,
+           per_hour(wakes[1], steps[1]), per_hour(edges, steps[0]));
+    return test_done("wakeup");
+}
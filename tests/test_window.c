@@ -0,0 +1,110 @@
+/*
+ * Window unit test
+ *
+ * 100k random pushes through windows of several sizes, every statistic
+ * checked against a brute-force pass over the samples it should hold.
+ * Runs of equal and of monotonic samples exercise the deques.
+ */
+
+#include "test.h"
+
+#include "Window.h"
+
+#define MAX_CAPACITY    (720)
+#define PUSHES          (100000)
+
+static int history[PUSHES];
+
+static void test_edges(void)
+{
+    static int samples[4];
+    static struct window_entry minq[4], maxq[4];
+    struct window win;
+    int value;
+
+    CHECK(window_init(NULL, samples, minq, maxq, 4) == -1);
+    CHECK(window_init(&win, NULL, minq, maxq, 4) == -1);
+    CHECK(window_init(&win, samples, minq, maxq, 0) == -1);
+    CHECK(window_init(&win, samples, minq, maxq, 4) == 0);
+    CHECK(window_count(&win) == 0);
+    CHECK(window_sum(&win) == 0);
+    CHECK(window_mean(&win, &value) == -1);
+    CHECK(window_min(&win, &value) == -1);
+    CHECK(window_max(&win, &value) == -1);
+    CHECK(window_push(NULL, 1) == -1);
+
+    /* The mean truncates toward zero */
+    window_push(&win, -3);
+    window_push(&win, -4);
+    CHECK(window_mean(&win, &value) == 0 && value == -3);
+    window_push(&win, 1);
+    window_push(&win, 2);
+    CHECK(window_push(&win, 9) == 1);
+    CHECK(window_count(&win) == 4);
+    CHECK(window_sum(&win) == -4 + 1 + 2 + 9);
+    CHECK(window_min(&win, &value) == 0 && value == -4);
+    CHECK(window_max(&win, &value) == 0 && value == 9);
+}
+
+static int next_value(uint32_t *seed, int i)
+{
+    switch ((i / 500) % 4)
+    {
+        case 0:
+            return (int)(test_rand(seed) % 200001) - 100000;
+        case 1:
+            return 42;
+        case 2:
+            return i;
+        default:
+            return -i;
+    }
+}
+
+static void test_brute_force(int capacity)
+{
+    static int samples[MAX_CAPACITY];
+    static struct window_entry minq[MAX_CAPACITY], maxq[MAX_CAPACITY];
+    struct window win;
+    uint32_t seed = 0xC0FFEEu + (uint32_t)capacity;
+    int i, j, first, min, max, value;
+    int64_t sum;
+
+    window_init(&win, samples, minq, maxq, capacity);
+    for (i = 0; i < PUSHES; i++)
+    {
+        history[i] = next_value(&seed, i);
+        CHECK(window_push(&win, history[i]) == (i >= capacity));
+
+        first = i - capacity + 1 < 0 ? 0 : i - capacity + 1;
+        sum = 0;
+        min = max = history[first];
+        for (j = first; j <= i; j++)
+        {
+            sum += history[j];
+            min = history[j] < min ? history[j] : min;
+            max = history[j] > max ? history[j] : max;
+        }
+
+        CHECK(window_count(&win) == i - first + 1);
+        CHECK(window_sum(&win) == sum);
+        CHECK(window_mean(&win, &value) == 0 &&
+              value == (int)(sum / (i - first + 1)));
+        CHECK(window_min(&win, &value) == 0 && value == min);
+        CHECK(window_max(&win, &value) == 0 && value == max);
+        if (test_failures)
+        {
+            printf("capacity %d, push %d\n", capacity, i);
+            return;
+        }
+    }
+}
+
+int main(void)
+{
+    test_edges();
+    test_brute_force(1);
+    test_brute_force(23);
+    test_brute_force(MAX_CAPACITY);
+    return test_done("window");
+}
@@ -0,0 +1,287 @@
+#!/usr/bin/env python3
+"""
+Train the behaviour classifier and emit EasyMoo.cydsn/ClassifierModel.h.
+
+The model is a small random forest: CLASSIFIER_TREES decision trees of depth
+at most CLASSIFIER_MAX_DEPTH, each trained on a bootstrap sample with a random
+subset of features tried per split. Trees only test integer thresholds, so the
+firmware evaluates them exactly as trained.
+
+Training data is a CSV file with one labelled window per row: the feature
+columns below, in firmware units (see Activity.h, Classifier.h), then a
+"behaviour" column (grazing, ruminating, lying or walking). Without --csv, a
+synthetic data set is generated from simple collar motion models, which only
+gives a placeholder model to bring the pipeline up; retrain on labelled
+recordings before trusting the output. A placeholder model is marked with
+CLASSIFIER_PROVISIONAL, and its results are flagged as such in reports.
+
+Usage:
+    tools/train_classifier.py [--csv windows.csv] [--out path] [--seed N]
+
+Only the Python standard library is used.
+"""
+
+import argparse
+import csv
+import math
+import os
+import random
+
+FEATURES = ["odba", "jerk", "var_x", "var_y", "var_z", "zc",
+            "mean_x", "mean_y", "mean_z"]
+BEHAVIOURS = ["grazing", "ruminating", "lying", "walking"]
+
+TREES = 5
+MAX_DEPTH = 4
+MIN_LEAF = 4
+
+# Must match Process.h / CoreLink.h
+ACC_LSB_PER_G = 8192
+ACTIVITY_LEN = 128
+ACTIVITY_HYST = ACC_LSB_PER_G // 20
+ODR = 1125.0 / 45.0
+
+
+def tdiv(a, b):
+    """C integer division, truncating toward zero."""
+    q = abs(a) // abs(b)
+    return q if (a >= 0) == (b >= 0) else -q
+
+
+class Activity:
+    """Port of Activity.c, kept bit exact."""
+
+    def __init__(self, capacity, hyst):
+        self.cap = capacity
+        self.hyst = hyst
+        self.buf = []
+        self.sum = [0, 0, 0]
+        self.sumsq = [0, 0, 0]
+        self.odba_sum = 0
+        self.jerk_sum = 0
+        self.zc = [0, 0, 0]
+        self.prev = [0, 0, 0]
+        self.sign = [0, 0, 0]
+        self.evicted = False
+
+    def push(self, v):
+        if len(self.buf) == self.cap:
+            old = self.buf.pop(0)
+            for i in range(3):
+                self.sum[i] -= old[0][i]
+                self.sumsq[i] -= old[0][i] ** 2
+                if old[3] & (1 << i):
+                    self.zc[i] -= 1
+            self.odba_sum -= old[1]
+            self.jerk_sum -= old[2]
+            self.evicted = True
+        odba = jerk = zc = 0
+        n = len(self.buf)
+        for i in range(3):
+            if n > 0:
+                d = v[i] - tdiv(self.sum[i], n)
+                odba += abs(d)
+                jerk += abs(v[i] - self.prev[i])
+                if d > self.hyst or d < -self.hyst:
+                    sign = 1 if d > 0 else -1
+                    if self.sign[i] and sign != self.sign[i]:
+                        zc |= 1 << i
+                        self.zc[i] += 1
+                    self.sign[i] = sign
+            self.sum[i] += v[i]
+            self.sumsq[i] += v[i] ** 2
+            self.prev[i] = v[i]
+        self.odba_sum += odba
+        self.jerk_sum += jerk
+        self.buf.append((tuple(v), odba, jerk, zc))
+
+    def features(self):
+        n = len(self.buf)
+        mean = [tdiv(s, n) for s in self.sum]
+        var = [(n * q - s * s) // (n * n) for s, q in zip(self.sum, self.sumsq)]
+        jn = n if self.evicted else n - 1
+        jerk = self.jerk_sum // jn if jn > 0 else 0
+        return [self.odba_sum // n, jerk, var[0], var[1], var[2],
+                sum(self.zc), mean[0], mean[1], mean[2]]
+
+
+def clamp16(v):
+    return max(-32768, min(32767, int(round(v))))
+
+
+def synthetic_window(rng, behaviour):
+    """Collar frame: x forward, y left, z up. Returns one feature vector."""
+    g = ACC_LSB_PER_G
+    if behaviour == "grazing":
+        pitch = math.radians(rng.uniform(45, 75))       # head down
+        roll = math.radians(rng.uniform(-10, 10))
+        amp, freq, noise, steps = rng.uniform(300, 900), rng.uniform(0.8, 1.6), 250, 0.3
+    elif behaviour == "ruminating":
+        pitch = math.radians(rng.uniform(-10, 15))
+        roll = math.radians(rng.uniform(-10, 10))
+        amp, freq, noise, steps = rng.uniform(80, 250), rng.uniform(0.9, 1.3), 60, 0.0
+    elif behaviour == "lying":
+        pitch = math.radians(rng.uniform(-5, 20))
+        roll = math.radians(rng.uniform(20, 50) * rng.choice((-1, 1)))
+        amp, freq, noise, steps = rng.uniform(0, 60), rng.uniform(0.1, 0.4), 40, 0.0
+    else:                                               # walking
+        pitch = math.radians(rng.uniform(-5, 25))
+        roll = math.radians(rng.uniform(-8, 8))
+        amp, freq, noise, steps = rng.uniform(1200, 3000), rng.uniform(0.8, 1.2), 300, 1.0
+
+    gx = -g * math.sin(pitch)
+    gy = g * math.cos(pitch) * math.sin(roll)
+    gz = g * math.cos(pitch) * math.cos(roll)
+    act = Activity(ACTIVITY_LEN, ACTIVITY_HYST)
+    phase = rng.uniform(0, 2 * math.pi)
+    for k in range(2 * ACTIVITY_LEN):
+        t = k / ODR
+        w = 2 * math.pi * freq * t + phase
+        stride = steps * amp * math.sin(2 * w) * 0.5
+        act.push([clamp16(gx + amp * math.sin(w) + stride + rng.gauss(0, noise)),
+                  clamp16(gy + 0.4 * amp * math.sin(w + 1.0) + rng.gauss(0, noise)),
+                  clamp16(gz + 0.7 * amp * math.cos(w) + stride + rng.gauss(0, noise))])
+    return act.features()
+
+
+def load_csv(path):
+    rows = []
+    with open(path, newline="") as f:
+        for r in csv.DictReader(f):
+            rows.append(([int(r[name]) for name in FEATURES],
+                         BEHAVIOURS.index(r["behaviour"].strip().lower())))
+    return rows
+
+
+def gini(counts, n):
+    return 1.0 - sum((c / n) ** 2 for c in counts if c)
+
+
+def best_split(rows, feats):
+    n = len(rows)
+    total = [0] * len(BEHAVIOURS)
+    for _, y in rows:
+        total[y] += 1
+    best = None
+    for f in feats:
+        ordered = sorted(rows, key=lambda r: r[0][f])
+        left = [0] * len(BEHAVIOURS)
+        for i in range(n - 1):
+            left[ordered[i][1]] += 1
+            a, b = ordered[i][0][f], ordered[i + 1][0][f]
+            if a == b or i + 1 < MIN_LEAF or n - i - 1 < MIN_LEAF:
+                continue
+            right = [t - l for t, l in zip(total, left)]
+            score = ((i + 1) * gini(left, i + 1) +
+                     (n - i - 1) * gini(right, n - i - 1)) / n
+            if best is None or score < best[0]:
+                best = (score, f, (a + b) // 2)
+    return best
+
+
+def majority(rows):
+    counts = [0] * len(BEHAVIOURS)
+    for _, y in rows:
+        counts[y] += 1
+    return counts.index(max(counts))
+
+
+def build(rows, depth, rng, nodes):
+    """Appends the subtree to nodes and returns its root index."""
+    idx = len(nodes)
+    nodes.append(None)
+    labels = {y for _, y in rows}
+    split = None
+    if depth < MAX_DEPTH and len(labels) > 1:
+        k = max(2, int(math.sqrt(len(FEATURES))) + 1)
+        split = best_split(rows, rng.sample(range(len(FEATURES)), k))
+    if split is None:
+        nodes[idx] = (-1, 0, majority(rows), 0)
+        return idx
+    _, f, thr = split
+    left = build([r for r in rows if r[0][f] <= thr], depth + 1, rng, nodes)
+    right = build([r for r in rows if r[0][f] > thr], depth + 1, rng, nodes)
+    nodes[idx] = (f, thr, left, right)
+    return idx
+
+
+def predict(nodes, roots, x):
+    votes = [0] * len(BEHAVIOURS)
+    for r in roots:
+        n = nodes[r]
+        while n[0] >= 0:
+            n = nodes[n[2] if x[n[0]] <= n[1] else n[3]]
+        votes[n[2]] += 1
+    return votes.index(max(votes))
+
+
+def emit(path, nodes, roots, source, accuracy, provisional):
+    lines = [
+        "/*",
+        " * ClassifierModel.h - Behaviour classifier model, see Classifier.h",
+        " *",
+        " * Generated by tools/train_classifier.py, do not edit.",
+        " * Training data: %s" % source,
+        " * Training accuracy: %.1f%%" % (100.0 * accuracy),
+        " */",
+        "",
+        "#ifndef _CLASSIFIER_MODEL_H",
+        "#define _CLASSIFIER_MODEL_H",
+        "",
+        "#define CLASSIFIER_TREES        (%d)" % len(roots),
+        "#define CLASSIFIER_MAX_DEPTH    (%d)" % MAX_DEPTH,
+        "#define CLASSIFIER_PROVISIONAL  (%d)" % provisional,
+        "",
+        "static const uint16_t classifier_roots[CLASSIFIER_TREES] = {",
+        "    " + ", ".join(str(r) for r in roots),
+        "};",
+        "",
+        "static const struct classifier_node classifier_nodes[] = {",
+    ]
+    for i, (f, thr, left, right) in enumerate(nodes):
+        if f < 0:
+            lines.append("    /* %3d */ { -1, 0, BEHAVIOUR_%s, 0 }," %
+                         (i, BEHAVIOURS[left].upper()))
+        else:
+            lines.append("    /* %3d */ { CLASSIFIER_%s, %d, %d, %d }," %
+                         (i, FEATURES[f].upper(), thr, left, right))
+    lines += ["};", "", "#endif /* _CLASSIFIER_MODEL_H */", ""]
+    with open(path, "w", newline="\r\n") as f:
+        f.write("\n".join(lines))
+
+
+def main():
+    here = os.path.dirname(os.path.abspath(__file__))
+    ap = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    ap.add_argument("--csv", help="labelled feature windows")
+    ap.add_argument("--out", default=os.path.normpath(os.path.join(
+        here, "..", "EasyMoo.cydsn", "ClassifierModel.h")))
+    ap.add_argument("--seed", type=int, default=136)
+    ap.add_argument("--windows", type=int, default=60,
+                    help="synthetic windows per behaviour")
+    args = ap.parse_args()
+
+    rng = random.Random(args.seed)
+    if args.csv:
+        rows = load_csv(args.csv)
+        source = os.path.basename(args.csv)
+    else:
+        rows = [(synthetic_window(rng, b), y)
+                for y, b in enumerate(BEHAVIOURS)
+                for _ in range(args.windows)]
+        source = "synthetic, seed %d, %d windows per behaviour" % (
+            args.seed, args.windows)
+
+    nodes, roots = [], []
+    for _ in range(TREES):
+        bag = [rng.choice(rows) for _ in rows]
+        roots.append(build(bag, 0, rng, nodes))
+
+    accuracy = sum(predict(nodes, roots, x) == y for x, y in rows) / len(rows)
+    emit(args.out, nodes, roots, source, accuracy, 0 if args.csv else 1)
+    print("%d nodes, accuracy %.1f%% -> %s" % (len(nodes), 100 * accuracy,
+                                                 args.out))
+
+
+if __name__ == "__main__":
+    main()